@@ -1,118 +1,660 @@
-#include Ecryption.h
+#include "Ecryption.h"
+#include "EcryptionBase64.h"
+#include "EcryptionCache.h"
+#include "EcryptionEnvelope.h"
+#include "EcryptionScratch.h"
+#include "EcryptionStats.h"
+#include "EcryptionUTF8.h"
 
-#define SPLIT_SYMBOL "52168@E4B9!13Fe-33!B0D9CF6!$@!~"
-FString UnrealUtils::Common::Encrypt(const FString& InputString, const FAES::FAESKey& Key)
+namespace
 {
-	if (!ensure(!InputString.IsEmpty())) { return{}; }
-	if (!ensure(Key.IsValid())) { return{}; }
-	FString TempString = InputString;
+	/** 原地解密 Buffer, 并只保留负载. */
+	bool OpenBuffer(TArray<uint8>& Buffer, const UnrealUtils::Common::FPreparedAESKey& Key)
+	{
+		TArrayView<const uint8> Payload;
+		uint8 Flags = 0;
+		if (!UnrealUtils::Common::Envelope::Open(Buffer.GetData(), Buffer.Num(), Key, Payload, Flags))
+		{
+			Buffer.Reset();
+			return false;
+		}
+		if ((Flags & UnrealUtils::Common::Envelope::FlagCompressed) != 0)
+		{
+			UnrealUtils::Common::Scratch::FScratchBuffer Inflated;
+			const bool bInflated = UnrealUtils::Common::Envelope::Inflate(Payload, Flags, Inflated);
+			Buffer.Reset();
+			if (!bInflated)
+			{
+				return false;
+			}
+			Buffer.Append(Payload.GetData(), Payload.Num());
+			return true;
+		}
+		const int32 Offset = (int32)(Payload.GetData() - Buffer.GetData());
+		if (Offset != 0)
+		{
+			FMemory::Memmove(Buffer.GetData(), Payload.GetData(), Payload.Num());
+		}
+		Buffer.SetNum(Payload.Num(), false);
+		return true;
+	}
+
+	/** 融合路径每次处理的字节数: 既是 16 也是 3 的倍数, 明文块和编码结果一起能留在 L1/L2 中. */
+	static constexpr int32 FusedChunkSize = 48 * 256;
+
+	/**
+	 * 生成信封明文(信封头 + 负载 + 补零)中 [Offset, Offset + ChunkSize) 这一段.
+	 * WritePayload(PayloadOffset, NumBytes, Dest) 负责写出负载中的一段.
+	 */
+	template <typename WritePayloadType>
+	void FillPlaintextChunk(int32 PayloadSize, uint8 Flags, WritePayloadType&& WritePayload, int32 Offset, int32 ChunkSize, uint8* OutChunk)
+	{
+		const int32 PayloadEnd = UnrealUtils::Common::Envelope::HeaderSize + PayloadSize;
+		int32 Position = Offset;
+		const int32 ChunkEnd = Offset + ChunkSize;
+		if (Position < UnrealUtils::Common::Envelope::HeaderSize)
+		{
+			uint8 Header[UnrealUtils::Common::Envelope::HeaderSize];
+			UnrealUtils::Common::Envelope::WriteHeader(Header, Flags, PayloadSize);
+			const int32 NumHeaderBytes = FMath::Min(UnrealUtils::Common::Envelope::HeaderSize, ChunkEnd) - Position;
+			FMemory::Memcpy(OutChunk, Header + Position, NumHeaderBytes);
+			Position += NumHeaderBytes;
+		}
+		if (Position < PayloadEnd && Position < ChunkEnd)
+		{
+			const int32 NumPayloadBytes = FMath::Min(PayloadEnd, ChunkEnd) - Position;
+			WritePayload(Position - UnrealUtils::Common::Envelope::HeaderSize, NumPayloadBytes, OutChunk + Position - Offset);
+			Position += NumPayloadBytes;
+		}
+		if (Position < ChunkEnd)
+		{
+			FMemory::Memzero(OutChunk + Position - Offset, ChunkEnd - Position);
+		}
+	}
+
+	/**
+	 * 融合路径: 逐块生成明文, 加密后趁数据还在缓存中直接编码到 OutResult 里, 复用 OutResult 已有的容量.
+	 * WritePayload 读取的数据不能在 OutResult 中.
+	 */
+	template <typename WritePayloadType>
+	void SealToBase64(int32 PayloadSize, uint8 Flags, WritePayloadType&& WritePayload, const UnrealUtils::Common::FPreparedAESKey& Key, FString& OutResult)
+	{
+		const int32 SealedSize = UnrealUtils::Common::Envelope::GetSealedSize(PayloadSize);
+		const int32 EncodedSize = (int32)UnrealUtils::Common::Base64::GetEncodedSize(SealedSize);
 
-	/** 插入垃圾符号. */
-	const FString SplitSymbol = SPLIT_SYMBOL;
-	TempString.Append(SplitSymbol);
+		TArray<TCHAR>& ResultChars = OutResult.GetCharArray();
+		ResultChars.Reset(EncodedSize + 1);
+		ResultChars.AddUninitialized(EncodedSize + 1);
+		ResultChars[EncodedSize] = TEXT('\0');
 
-	const auto BufferSize = TempString.Len();
-	TArray<uint8> Buffer{};
-	Buffer.AddUninitialized(BufferSize);
-	StringToBytes(TempString, Buffer.GetData(), BufferSize);
+		alignas(16) uint8 Chunk[FusedChunkSize];
+		for (int32 Offset = 0; Offset < SealedSize; Offset += FusedChunkSize)
+		{
+			const int32 ChunkSize = FMath::Min(FusedChunkSize, SealedSize - Offset);
+			FillPlaintextChunk(PayloadSize, Flags, WritePayload, Offset, ChunkSize, Chunk);
+			UnrealUtils::Common::AESKernel::EncryptData(Chunk, ChunkSize, Key);
+			UnrealUtils::Common::Base64::Encode(Chunk, ChunkSize, ResultChars.GetData() + Offset / 3 * 4);
+		}
+	}
 
-  /** 调整，因为除非大小是 16 的倍数，否则无法使用. */
-	const int32 OriginalSize = Buffer.Num();
-	const int32 AlignedSize = Align(OriginalSize, FAES::AESBlockSize);
-	Buffer.SetNumZeroed(AlignedSize);
+	/** 把已密封的 Sealed 按 BytesToString 的规则写入 OutResult, 复用 OutResult 已有的容量. */
+	void SealedToChars(const uint8* Sealed, int32 SealedSize, FString& OutResult)
+	{
+		TArray<TCHAR>& ResultChars = OutResult.GetCharArray();
+		ResultChars.Reset(SealedSize + 1);
+		ResultChars.AddUninitialized(SealedSize + 1);
+		UnrealUtils::Common::Envelope::BytesToChars(Sealed, SealedSize, ResultChars.GetData());
+		ResultChars[SealedSize] = TEXT('\0');
+	}
 
-	/** 加密. */
-	FAES::EncryptData(Buffer.GetData(), Buffer.Num(), Key);
+	/**
+	 * 把字符串加密成 BytesToString 形式的密文写入 OutResult.
+	 * 信封只是中间结果, 放在暂存内存里; Input 读完之后才写 OutResult, 所以 Input 可以就是 OutResult 的内容.
+	 */
+	void SealStringToChars(FStringView Input, const UnrealUtils::Common::FPreparedAESKey& Key, FString& OutResult)
+	{
+		const int32 PayloadSize = UnrealUtils::Common::Envelope::GetStringPayloadSize(Input);
+		const int32 SealedSize = UnrealUtils::Common::Envelope::GetSealedSize(PayloadSize);
+		UnrealUtils::Common::Scratch::FScratchBuffer Buffer(SealedSize);
+		UnrealUtils::Common::Envelope::WriteStringPayload(Input, Buffer.GetData() + UnrealUtils::Common::Envelope::HeaderSize);
+		UnrealUtils::Common::Envelope::Seal(Buffer.GetData(), PayloadSize, UnrealUtils::Common::Envelope::FlagUTF8, Key);
+		SealedToChars(Buffer.GetData(), SealedSize, OutResult);
+	}
 
-	const FString Result = BytesToString(Buffer.GetData(), AlignedSize);
+	/** 先完整解码再整体解密, 用于旧的垃圾符号格式. */
+	FString DecryptBase64Buffered(const FString& InputString, const UnrealUtils::Common::FPreparedAESKey& Key)
+	{
+		uint32 SealedSize = 0;
+		if (!ensure(UnrealUtils::Common::Base64::GetDecodedSize(*InputString, InputString.Len(), SealedSize))) { return{}; }
+		UnrealUtils::Common::Scratch::FScratchBuffer Buffer((int32)SealedSize);
+		if (!ensure(UnrealUtils::Common::Base64::Decode(*InputString, InputString.Len(), Buffer.GetData()))) { return{}; }
+
+		TArrayView<const uint8> Payload;
+		uint8 Flags = 0;
+		if (!UnrealUtils::Common::Envelope::Open(Buffer.GetData(), Buffer.Num(), Key, Payload, Flags)) { return{}; }
+		UnrealUtils::Common::Scratch::FScratchBuffer Inflated;
+		if (!UnrealUtils::Common::Envelope::Inflate(Payload, Flags, Inflated)) { return{}; }
+
+		return UnrealUtils::Common::Envelope::PayloadToString(Payload, Flags);
+	}
+
+	/**
+	 * 准备要密封的负载: 按需压缩 Payload, 压缩后更小时 OutPayload 指向 Compressed 并加上 FlagCompressed,
+	 * 否则原样使用 Payload.
+	 */
+	void CompressPayload(TArrayView<const uint8> Payload, UnrealUtils::Common::EEcryptionCompression Compression, UnrealUtils::Common::Scratch::FScratchBuffer& Compressed,
+		TArrayView<const uint8>& OutPayload, uint8& InOutFlags)
+	{
+		OutPayload = Payload;
+		if (Compression == UnrealUtils::Common::EEcryptionCompression::None)
+		{
+			return;
+		}
+		Compressed.Allocate(UnrealUtils::Common::Envelope::GetMaxCompressedSize(Compression, Payload.Num()));
+		const int32 CompressedSize = UnrealUtils::Common::Envelope::Compress(Compression, Payload, Compressed.GetData());
+		if (CompressedSize > 0)
+		{
+			OutPayload = TArrayView<const uint8>(Compressed.GetData(), CompressedSize);
+			InOutFlags |= UnrealUtils::Common::Envelope::FlagCompressed;
+		}
+	}
+
+	/** 密封已准备好的负载, 写入 OutCipher. */
+	void SealPayload(TArrayView<const uint8> Payload, uint8 Flags, const UnrealUtils::Common::FPreparedAESKey& Key, TArray<uint8>& OutCipher)
+	{
+		const int32 SealedSize = UnrealUtils::Common::Envelope::GetSealedSize(Payload.Num());
+		OutCipher.Reset(SealedSize);
+		OutCipher.AddUninitialized(SealedSize);
+		FMemory::Memcpy(OutCipher.GetData() + UnrealUtils::Common::Envelope::HeaderSize, Payload.GetData(), Payload.Num());
+		UnrealUtils::Common::Envelope::Seal(OutCipher.GetData(), Payload.Num(), Flags, Key);
+	}
+}
+
+bool UnrealUtils::Common::Encrypt(TArrayView<const uint8> InputBytes, const FPreparedAESKey& Key, TArray<uint8>& OutCipher)
+{
+	Stats::FScopedCall Call(Stats::EFunction::Encrypt, InputBytes.Num());
+	if (!ensure(!InputBytes.IsEmpty())) { return false; }
+	if (!ensure(Key.IsValid())) { return false; }
+
+	const int32 SealedSize = Envelope::GetSealedSize(InputBytes.Num());
+	OutCipher.Reset(SealedSize);
+	OutCipher.AddUninitialized(SealedSize);
+	FMemory::Memcpy(OutCipher.GetData() + Envelope::HeaderSize, InputBytes.GetData(), InputBytes.Num());
+	Envelope::Seal(OutCipher.GetData(), InputBytes.Num(), 0, Key);
+	Call.Succeed(SealedSize);
+	return true;
+}
+
+bool UnrealUtils::Common::Encrypt(FStringView InputString, const FPreparedAESKey& Key, TArray<uint8>& OutCipher)
+{
+	Stats::FScopedCall Call(Stats::EFunction::Encrypt, InputString.Len());
+	if (!ensure(!InputString.IsEmpty())) { return false; }
+	if (!ensure(Key.IsValid())) { return false; }
+
+	const int32 PayloadSize = Envelope::GetStringPayloadSize(InputString);
+	const int32 SealedSize = Envelope::GetSealedSize(PayloadSize);
+	OutCipher.Reset(SealedSize);
+	OutCipher.AddUninitialized(SealedSize);
+	Envelope::WriteStringPayload(InputString, OutCipher.GetData() + Envelope::HeaderSize);
+	Envelope::Seal(OutCipher.GetData(), PayloadSize, Envelope::FlagUTF8, Key);
+	Call.Succeed(SealedSize);
+	return true;
+}
+
+bool UnrealUtils::Common::Decrypt(TArrayView<const uint8> InputCipher, const FPreparedAESKey& Key, TArray<uint8>& OutBytes)
+{
+	Stats::FScopedCall Call(Stats::EFunction::Decrypt, InputCipher.Num());
+	if (!ensure(Key.IsValid())) { return false; }
+	if (!Envelope::IsValidSealedSize(InputCipher.Num()))
+	{
+		Stats::RecordFailure(Stats::EFailure::MalformedInput);
+		return false;
+	}
+
+	OutBytes.Reset(InputCipher.Num());
+	OutBytes.Append(InputCipher.GetData(), InputCipher.Num());
+	if (!OpenBuffer(OutBytes, Key)) { return false; }
+	Call.Succeed(OutBytes.Num());
+	return true;
+}
+
+bool UnrealUtils::Common::Decrypt(FStringView InputString, const FPreparedAESKey& Key, TArray<uint8>& OutBytes)
+{
+	Stats::FScopedCall Call(Stats::EFunction::Decrypt, InputString.Len());
+	if (!ensure(Key.IsValid())) { return false; }
+	if (!Envelope::IsValidCipherString(InputString))
+	{
+		Stats::RecordFailure(Stats::EFailure::MalformedInput);
+		return false;
+	}
+
+	OutBytes.Reset(InputString.Len());
+	OutBytes.AddUninitialized(InputString.Len());
+	Envelope::CharsToBytes(InputString, OutBytes.GetData());
+	if (!OpenBuffer(OutBytes, Key)) { return false; }
+	Call.Succeed(OutBytes.Num());
+	return true;
+}
+
+bool UnrealUtils::Common::EncryptInPlace(TArray<uint8>& InOutBytes, const FPreparedAESKey& Key)
+{
+	Stats::FScopedCall Call(Stats::EFunction::Encrypt, InOutBytes.Num());
+	if (!ensure(InOutBytes.Num() > 0)) { return false; }
+	if (!ensure(Key.IsValid())) { return false; }
+
+	/** 不允许收缩, 容量足够时不会重新分配. */
+	const int32 PayloadSize = InOutBytes.Num();
+	const int32 SealedSize = Envelope::GetSealedSize(PayloadSize);
+	InOutBytes.SetNumUninitialized(SealedSize, false);
+	FMemory::Memmove(InOutBytes.GetData() + Envelope::HeaderSize, InOutBytes.GetData(), PayloadSize);
+	Envelope::Seal(InOutBytes.GetData(), PayloadSize, 0, Key);
+	Call.Succeed(SealedSize);
+	return true;
+}
+
+bool UnrealUtils::Common::DecryptInPlace(TArray<uint8>& InOutBytes, const FPreparedAESKey& Key)
+{
+	Stats::FScopedCall Call(Stats::EFunction::Decrypt, InOutBytes.Num());
+	if (!ensure(Key.IsValid())) { return false; }
+	if (!Envelope::IsValidSealedSize(InOutBytes.Num()))
+	{
+		Stats::RecordFailure(Stats::EFailure::MalformedInput);
+		return false;
+	}
+
+	if (!OpenBuffer(InOutBytes, Key)) { return false; }
+	Call.Succeed(InOutBytes.Num());
+	return true;
+}
+
+FString UnrealUtils::Common::Encrypt(const FString& InputString, const FPreparedAESKey& Key)
+{
+	Stats::FScopedCall Call(Stats::EFunction::Encrypt, InputString.Len());
+	if (!ensure(!InputString.IsEmpty())) { return{}; }
+	if (!ensure(Key.IsValid())) { return{}; }
+
+	/** 堆上只分配返回的字符串. */
+	FString Result;
+	SealStringToChars(InputString, Key, Result);
+	Call.Succeed(Result.Len());
 	return Result;
 }
 
-FString UnrealUtils::Common::Decrypt(const FString& InputString, const FAES::FAESKey& Key)
+FString UnrealUtils::Common::Encrypt(FString&& InputString, const FPreparedAESKey& Key)
 {
+	Stats::FScopedCall Call(Stats::EFunction::Encrypt, InputString.Len());
 	if (!ensure(!InputString.IsEmpty())) { return{}; }
 	if (!ensure(Key.IsValid())) { return{}; }
-	const auto BufferSize = InputString.Len();
 
-	/** 大小不是 16 的倍数. */
-	if (BufferSize % FAES::AESBlockSize != 0)
+	/** 接管输入的内存写入密文, 空余容量足够时不分配; 密文不短于明文, 原来的明文字符全部被覆盖. */
+	FString Result = MoveTemp(InputString);
+	SealStringToChars(Result, Key, Result);
+	Call.Succeed(Result.Len());
+	return Result;
+}
+
+FString UnrealUtils::Common::Decrypt(const FString& InputString, const FPreparedAESKey& Key)
+{
+	Stats::FScopedCall Call(Stats::EFunction::Decrypt, InputString.Len());
+	if (!ensure(Key.IsValid())) { return{}; }
+	if (!Envelope::IsValidCipherString(InputString))
 	{
-		/** 由于大小无效，消息无法解密. */
-		ensureMsgf(false, TEXT("Unable to decode message because message size is invalid."));
-		return {};
+		Stats::RecordFailure(Stats::EFailure::MalformedInput);
+		return{};
 	}
-	TArray<uint8> Buffer{};
-	Buffer.AddUninitialized(BufferSize);
-	StringToBytes(InputString, Buffer.GetData(), BufferSize);
 
-	/** 解密 */
-	FAES::DecryptData(Buffer.GetData(), BufferSize, Key);
+	const DecryptCache::FLookup CacheLookup(DecryptCache::EFormat::String, InputString, Key);
+	FString Result;
+	if (CacheLookup.Find(Result))
+	{
+		Call.Succeed(Result.Len());
+		return Result;
+	}
 
-	const FString DecryptedString = BytesToString(Buffer.GetData(), BufferSize);
+	Scratch::FScratchBuffer Buffer(InputString.Len());
+	Envelope::CharsToBytes(InputString, Buffer.GetData());
 
-	/** 从垃圾符号中分离出所需的数据. */
-	FString LeftData;
-	FString RightData;
-	const FString SplitSymbol = SPLIT_SYMBOL;
-	DecryptedString.Split(SplitSymbol, &LeftData, &RightData, ESearchCase::CaseSensitive, ESearchDir::FromStart);
+	TArrayView<const uint8> Payload;
+	uint8 Flags = 0;
+	if (!Envelope::Open(Buffer.GetData(), Buffer.Num(), Key, Payload, Flags)) { return{}; }
+	Scratch::FScratchBuffer Inflated;
+	if (!Envelope::Inflate(Payload, Flags, Inflated)) { return{}; }
 
-	return LeftData;
+	Result = Envelope::PayloadToString(Payload, Flags);
+	CacheLookup.Add(Result);
+	Call.Succeed(Result.Len());
+	return Result;
 }
 
-FString UnrealUtils::Common::EncryptBase64(const FString& InputString, const FAES::FAESKey& Key)
+FString UnrealUtils::Common::EncryptBase64(const FString& InputString, const FPreparedAESKey& Key)
 {
+	Stats::FScopedCall Call(Stats::EFunction::EncryptBase64, InputString.Len());
 	if (!ensure(!InputString.IsEmpty())) { return{}; }
 	if (!ensure(Key.IsValid())) { return{}; }
-	FString TempString = InputString;
 
-	/** 插入垃圾符号. */
-	const FString SplitSymbol = SPLIT_SYMBOL;
-	TempString.Append(SplitSymbol);
+	/** 纯 ASCII 时 UTF-8 与字符一一对应, 每块直接从字符串转换; 否则先整体转成 UTF-8. */
+	const FStringView Input(InputString);
+	const int32 PayloadSize = Envelope::GetStringPayloadSize(Input);
+	FString Result;
+	if (PayloadSize == Input.Len())
+	{
+		SealToBase64(PayloadSize, Envelope::FlagUTF8, [&Input](int32 PayloadOffset, int32 NumBytes, uint8* Dest)
+		{
+			Envelope::WriteStringPayload(Input.Mid(PayloadOffset, NumBytes), Dest);
+		}, Key, Result);
+		Call.Succeed(Result.Len());
+		return Result;
+	}
 
-	const auto BufferSize = TempString.Len();
-	TArray<uint8> Buffer{};
-	Buffer.AddUninitialized(BufferSize);
-	StringToBytes(TempString, Buffer.GetData(), BufferSize);
+	Scratch::FScratchBuffer Payload(PayloadSize);
+	Envelope::WriteStringPayload(Input, Payload.GetData());
+	SealToBase64(PayloadSize, Envelope::FlagUTF8, [&Payload](int32 PayloadOffset, int32 NumBytes, uint8* Dest)
+	{
+		FMemory::Memcpy(Dest, Payload.GetData() + PayloadOffset, NumBytes);
+	}, Key, Result);
+	Call.Succeed(Result.Len());
+	return Result;
+}
 
-	/** 调整，因为除非大小是 16 的倍数，否则无法使用. */
-	const int32 OriginalSize = Buffer.Num();
-	const int32 AlignedSize = Align(OriginalSize, FAES::AESBlockSize);
-	Buffer.SetNumZeroed(AlignedSize);
+FString UnrealUtils::Common::EncryptBase64(FString&& InputString, const FPreparedAESKey& Key)
+{
+	Stats::FScopedCall Call(Stats::EFunction::EncryptBase64, InputString.Len());
+	if (!ensure(!InputString.IsEmpty())) { return{}; }
+	if (!ensure(Key.IsValid())) { return{}; }
 
-	/** 加密. */
-	FAES::EncryptData(Buffer.GetData(), Buffer.Num(), Key);
+	/** 融合路径会边读输入边写结果, 这里先把负载转到暂存内存, 再接管输入的内存写入结果. */
+	FString Result = MoveTemp(InputString);
+	const FStringView Input(Result);
+	const int32 PayloadSize = Envelope::GetStringPayloadSize(Input);
+	Scratch::FScratchBuffer Payload(PayloadSize);
+	Envelope::WriteStringPayload(Input, Payload.GetData());
+	SealToBase64(PayloadSize, Envelope::FlagUTF8, [&Payload](int32 PayloadOffset, int32 NumBytes, uint8* Dest)
+	{
+		FMemory::Memcpy(Dest, Payload.GetData() + PayloadOffset, NumBytes);
+	}, Key, Result);
+	Call.Succeed(Result.Len());
+	return Result;
+}
 
-	const FString Result = FBase64::Encode(Buffer.GetData(), AlignedSize);
+FString UnrealUtils::Common::DecryptBase64(const FString& InputString, const FPreparedAESKey& Key)
+{
+	Stats::FScopedCall Call(Stats::EFunction::DecryptBase64, InputString.Len());
+	if (!ensure(Key.IsValid())) { return{}; }
+
+	/** 先不分配内存地检查长度, '=' 补齐和字符, 大量无效的输入(例如伪造的令牌)在这里就被拒绝. */
+	uint32 SealedSize = 0;
+	if (!Base64::Validate(*InputString, InputString.Len(), SealedSize) || !Envelope::IsValidSealedSize(SealedSize))
+	{
+		Stats::RecordFailure(Stats::EFailure::MalformedInput);
+		return{};
+	}
+
+	const DecryptCache::FLookup CacheLookup(DecryptCache::EFormat::Base64, InputString, Key);
+	FString Result;
+	if (CacheLookup.Find(Result))
+	{
+		Call.Succeed(Result.Len());
+		return Result;
+	}
+
+	/**
+	 * 与 EncryptBase64 对称: 逐块解码, 解密, 再直接写入结果字符串.
+	 * UTF-8 负载中跨块的多字节序列先留在 Carry 中, 下一块解密后拼到块的前面再解码.
+	 */
+	static constexpr int32 MaxCarrySize = 16;
+	alignas(16) uint8 ChunkStorage[MaxCarrySize + FusedChunkSize];
+	uint8* Chunk = ChunkStorage + MaxCarrySize;
+	uint8 Carry[MaxCarrySize];
+	int32 NumCarry = 0;
+
+	int32 PayloadSize = 0;
+	uint8 Flags = 0;
+	int32 NumResultChars = 0;
+	for (int32 Offset = 0; Offset < (int32)SealedSize; Offset += FusedChunkSize)
+	{
+		const int32 ChunkSize = FMath::Min(FusedChunkSize, (int32)SealedSize - Offset);
+		const TCHAR* ChunkChars = *InputString + Offset / 3 * 4;
+		const int32 NumChunkChars = (int32)Base64::GetEncodedSize(ChunkSize);
+
+		/** 中间的块里不能出现 '=', 否则解码出的字节数会少于 ChunkSize. */
+		uint32 DecodedSize = 0;
+		if (!ensure(Base64::GetDecodedSize(ChunkChars, NumChunkChars, DecodedSize) && DecodedSize == (uint32)ChunkSize
+			&& Base64::Decode(ChunkChars, NumChunkChars, Chunk)))
+		{
+			return {};
+		}
+		AESKernel::DecryptData(Chunk, ChunkSize, Key);
+
+		int32 ChunkPayloadBegin = 0;
+		if (Offset == 0)
+		{
+			if (!Envelope::ReadHeader(Chunk, (int32)SealedSize, Flags, PayloadSize))
+			{
+				/** 旧的垃圾符号格式需要先看到全部明文, 退回到整体解密. */
+				Result = DecryptBase64Buffered(InputString, Key);
+				CacheLookup.Add(Result);
+				Call.Succeed(Result.Len());
+				return Result;
+			}
+			if ((Flags & ~Envelope::KnownFlags) != 0)
+			{
+				Stats::RecordFailure(Stats::EFailure::InvalidEnvelope);
+				return {};
+			}
+			if ((Flags & Envelope::FlagCompressed) != 0)
+			{
+				/** 压缩过的负载要整体解压, 同样退回到整体解密. */
+				Result = DecryptBase64Buffered(InputString, Key);
+				CacheLookup.Add(Result);
+				Call.Succeed(Result.Len());
+				return Result;
+			}
+			if (PayloadSize == 0)
+			{
+				Stats::RecordFailure(Stats::EFailure::InvalidEnvelope);
+				return {};
+			}
+			/** 两种负载格式下字符数都不会超过负载字节数. */
+			Result.GetCharArray().AddUninitialized(PayloadSize + 1);
+			ChunkPayloadBegin = Envelope::HeaderSize;
+		}
+
+		const int32 ChunkPayloadEnd = FMath::Min(ChunkSize, Envelope::HeaderSize + PayloadSize - Offset);
+		if (ChunkPayloadEnd <= ChunkPayloadBegin)
+		{
+			continue;
+		}
+		TCHAR* Dest = Result.GetCharArray().GetData() + NumResultChars;
+		if ((Flags & Envelope::FlagUTF8) == 0)
+		{
+			Envelope::BytesToChars(Chunk + ChunkPayloadBegin, ChunkPayloadEnd - ChunkPayloadBegin, Dest);
+			NumResultChars += ChunkPayloadEnd - ChunkPayloadBegin;
+			continue;
+		}
+
+		const int32 Begin = ChunkPayloadBegin - NumCarry;
+		FMemory::Memcpy(Chunk + Begin, Carry, NumCarry);
+		const bool bFinal = Offset + ChunkPayloadEnd == Envelope::HeaderSize + PayloadSize;
+		int32 NumChars = 0;
+		int32 NumConsumed = 0;
+		if (!UTF8::Decode(Chunk + Begin, ChunkPayloadEnd - Begin, Dest, NumChars, NumConsumed, bFinal))
+		{
+			Stats::RecordFailure(Stats::EFailure::CorruptPayload);
+			return {};
+		}
+		NumResultChars += NumChars;
+		NumCarry = ChunkPayloadEnd - Begin - NumConsumed;
+		FMemory::Memcpy(Carry, Chunk + Begin + NumConsumed, NumCarry);
+	}
+
+	TArray<TCHAR>& ResultChars = Result.GetCharArray();
+	ResultChars.SetNum(NumResultChars + 1, false);
+	ResultChars[NumResultChars] = TEXT('\0');
+	CacheLookup.Add(Result);
+	Call.Succeed(NumResultChars);
 	return Result;
 }
 
-FString UnrealUtils::Common::DecryptBase64(const FString& InputString, const FAES::FAESKey& Key)
+bool UnrealUtils::Common::Encrypt(TArrayView<const uint8> InputBytes, const FPreparedAESKey& Key, TArray<uint8>& OutCipher, EEcryptionCompression Compression)
+{
+	if (Compression == EEcryptionCompression::None) { return Encrypt(InputBytes, Key, OutCipher); }
+	Stats::FScopedCall Call(Stats::EFunction::Encrypt, InputBytes.Num());
+	if (!ensure(!InputBytes.IsEmpty())) { return false; }
+	if (!ensure(Key.IsValid())) { return false; }
+
+	Scratch::FScratchBuffer Compressed;
+	TArrayView<const uint8> Payload;
+	uint8 Flags = 0;
+	CompressPayload(InputBytes, Compression, Compressed, Payload, Flags);
+	SealPayload(Payload, Flags, Key, OutCipher);
+	Call.Succeed(OutCipher.Num());
+	return true;
+}
+
+bool UnrealUtils::Common::Encrypt(FStringView InputString, const FPreparedAESKey& Key, TArray<uint8>& OutCipher, EEcryptionCompression Compression)
+{
+	if (Compression == EEcryptionCompression::None) { return Encrypt(InputString, Key, OutCipher); }
+	Stats::FScopedCall Call(Stats::EFunction::Encrypt, InputString.Len());
+	if (!ensure(!InputString.IsEmpty())) { return false; }
+	if (!ensure(Key.IsValid())) { return false; }
+
+	Scratch::FScratchBuffer Raw(Envelope::GetStringPayloadSize(InputString));
+	Envelope::WriteStringPayload(InputString, Raw.GetData());
+	Scratch::FScratchBuffer Compressed;
+	TArrayView<const uint8> Payload;
+	uint8 Flags = Envelope::FlagUTF8;
+	CompressPayload(TArrayView<const uint8>(Raw.GetData(), Raw.Num()), Compression, Compressed, Payload, Flags);
+	SealPayload(Payload, Flags, Key, OutCipher);
+	Call.Succeed(OutCipher.Num());
+	return true;
+}
+
+FString UnrealUtils::Common::Encrypt(const FString& InputString, const FPreparedAESKey& Key, EEcryptionCompression Compression)
 {
+	if (Compression == EEcryptionCompression::None) { return Encrypt(InputString, Key); }
+	Stats::FScopedCall Call(Stats::EFunction::Encrypt, InputString.Len());
 	if (!ensure(!InputString.IsEmpty())) { return{}; }
 	if (!ensure(Key.IsValid())) { return{}; }
-	TArray<uint8> Buffer{};
 
-	if (!ensure(FBase64::Decode(InputString, Buffer))) { return{}; }
-	const auto BufferSize = Buffer.Num();
-	/** 大小不是 16 的倍数. */
-	if (BufferSize % FAES::AESBlockSize != 0)
+	const FStringView Input(InputString);
+	Scratch::FScratchBuffer Raw(Envelope::GetStringPayloadSize(Input));
+	Envelope::WriteStringPayload(Input, Raw.GetData());
+	Scratch::FScratchBuffer Compressed;
+	TArrayView<const uint8> Payload;
+	uint8 Flags = Envelope::FlagUTF8;
+	CompressPayload(TArrayView<const uint8>(Raw.GetData(), Raw.Num()), Compression, Compressed, Payload, Flags);
+
+	const int32 SealedSize = Envelope::GetSealedSize(Payload.Num());
+	Scratch::FScratchBuffer Buffer(SealedSize);
+	FMemory::Memcpy(Buffer.GetData() + Envelope::HeaderSize, Payload.GetData(), Payload.Num());
+	Envelope::Seal(Buffer.GetData(), Payload.Num(), Flags, Key);
+
+	FString Result;
+	SealedToChars(Buffer.GetData(), SealedSize, Result);
+	Call.Succeed(SealedSize);
+	return Result;
+}
+
+FString UnrealUtils::Common::EncryptBase64(const FString& InputString, const FPreparedAESKey& Key, EEcryptionCompression Compression)
+{
+	if (Compression == EEcryptionCompression::None) { return EncryptBase64(InputString, Key); }
+	Stats::FScopedCall Call(Stats::EFunction::EncryptBase64, InputString.Len());
+	if (!ensure(!InputString.IsEmpty())) { return{}; }
+	if (!ensure(Key.IsValid())) { return{}; }
+
+	const FStringView Input(InputString);
+	Scratch::FScratchBuffer Raw(Envelope::GetStringPayloadSize(Input));
+	Envelope::WriteStringPayload(Input, Raw.GetData());
+	Scratch::FScratchBuffer Compressed;
+	TArrayView<const uint8> Payload;
+	uint8 Flags = Envelope::FlagUTF8;
+	CompressPayload(TArrayView<const uint8>(Raw.GetData(), Raw.Num()), Compression, Compressed, Payload, Flags);
+
+	FString Result;
+	SealToBase64(Payload.Num(), Flags, [&Payload](int32 PayloadOffset, int32 NumBytes, uint8* Dest)
 	{
-		/** 由于大小无效，消息无法解密. */
-		ensureMsgf(false, TEXT("Unable to decode message because message size is invalid."));
-		return {};
-	}
+		FMemory::Memcpy(Dest, Payload.GetData() + PayloadOffset, NumBytes);
+	}, Key, Result);
+	Call.Succeed(Result.Len());
+	return Result;
+}
+
+bool UnrealUtils::Common::Encrypt(TArrayView<const uint8> InputBytes, const FAES::FAESKey& Key, TArray<uint8>& OutCipher)
+{
+	return Encrypt(InputBytes, FPreparedAESKey(Key), OutCipher);
+}
+
+bool UnrealUtils::Common::Encrypt(FStringView InputString, const FAES::FAESKey& Key, TArray<uint8>& OutCipher)
+{
+	return Encrypt(InputString, FPreparedAESKey(Key), OutCipher);
+}
+
+bool UnrealUtils::Common::Decrypt(TArrayView<const uint8> InputCipher, const FAES::FAESKey& Key, TArray<uint8>& OutBytes)
+{
+	return Decrypt(InputCipher, FPreparedAESKey(Key), OutBytes);
+}
+
+bool UnrealUtils::Common::Decrypt(FStringView InputString, const FAES::FAESKey& Key, TArray<uint8>& OutBytes)
+{
+	return Decrypt(InputString, FPreparedAESKey(Key), OutBytes);
+}
+
+bool UnrealUtils::Common::EncryptInPlace(TArray<uint8>& InOutBytes, const FAES::FAESKey& Key)
+{
+	return EncryptInPlace(InOutBytes, FPreparedAESKey(Key));
+}
+
+bool UnrealUtils::Common::DecryptInPlace(TArray<uint8>& InOutBytes, const FAES::FAESKey& Key)
+{
+	return DecryptInPlace(InOutBytes, FPreparedAESKey(Key));
+}
+
+FString UnrealUtils::Common::Encrypt(const FString& InputString, const FAES::FAESKey& Key)
+{
+	return Encrypt(InputString, FPreparedAESKey(Key));
+}
+
+FString UnrealUtils::Common::Encrypt(FString&& InputString, const FAES::FAESKey& Key)
+{
+	return Encrypt(MoveTemp(InputString), FPreparedAESKey(Key));
+}
+
+FString UnrealUtils::Common::Decrypt(const FString& InputString, const FAES::FAESKey& Key)
+{
+	return Decrypt(InputString, FPreparedAESKey(Key));
+}
 
-	/** 解密 */
-	FAES::DecryptData(Buffer.GetData(), BufferSize, Key);
+FString UnrealUtils::Common::EncryptBase64(const FString& InputString, const FAES::FAESKey& Key)
+{
+	return EncryptBase64(InputString, FPreparedAESKey(Key));
+}
 
-	const FString DecryptedString = BytesToString(Buffer.GetData(), BufferSize);
+FString UnrealUtils::Common::EncryptBase64(FString&& InputString, const FAES::FAESKey& Key)
+{
+	return EncryptBase64(MoveTemp(InputString), FPreparedAESKey(Key));
+}
 
-	/** 从垃圾符号中分离出所需的数据. */
-	FString LeftData;
-	FString RightData;
-	const FString SplitSymbol = SPLIT_SYMBOL;
-	DecryptedString.Split(SplitSymbol, &LeftData, &RightData, ESearchCase::CaseSensitive, ESearchDir::FromStart);
+FString UnrealUtils::Common::DecryptBase64(const FString& InputString, const FAES::FAESKey& Key)
+{
+	return DecryptBase64(InputString, FPreparedAESKey(Key));
+}
 
-	return LeftData;
+bool UnrealUtils::Common::Encrypt(TArrayView<const uint8> InputBytes, const FAES::FAESKey& Key, TArray<uint8>& OutCipher, EEcryptionCompression Compression)
+{
+	return Encrypt(InputBytes, FPreparedAESKey(Key), OutCipher, Compression);
+}
+
+bool UnrealUtils::Common::Encrypt(FStringView InputString, const FAES::FAESKey& Key, TArray<uint8>& OutCipher, EEcryptionCompression Compression)
+{
+	return Encrypt(InputString, FPreparedAESKey(Key), OutCipher, Compression);
+}
+
+FString UnrealUtils::Common::Encrypt(const FString& InputString, const FAES::FAESKey& Key, EEcryptionCompression Compression)
+{
+	return Encrypt(InputString, FPreparedAESKey(Key), Compression);
+}
+
+FString UnrealUtils::Common::EncryptBase64(const FString& InputString, const FAES::FAESKey& Key, EEcryptionCompression Compression)
+{
+	return EncryptBase64(InputString, FPreparedAESKey(Key), Compression);
 }
-#undef SPLIT_SYMBOL
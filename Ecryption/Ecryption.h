@@ -5,14 +5,129 @@
 #include "CoreMinimal.h"
 #include "Misc/AES.h"
 #include "Misc/Base64.h"
+#include "EcryptionAES.h"
+#include "EcryptionBlob.h"
 
 namespace UnrealUtils
 {
     namespace Common
     {
+        /** 加密前可选的压缩. 不论使用哪种, 解密时都按密文中的标记自动解压. */
+        enum class EEcryptionCompression : uint8
+        {
+            None,
+            /** 速度优先, 适合频繁加解密的消息. */
+            LZ4,
+            /** 压缩率优先, 适合存盘或网络带宽受限的场合. */
+            Zlib,
+        };
+
+        /**
+         * 密文格式: 明文前加 12 字节的信封头(Magic, Version, Flags, PayloadSize)后补零到 16 的倍数, 再以 AES 加密.
+         * 字符串以 UTF-8 作为负载(信封标记 FlagUTF8), 中文等非 Latin-1 字符也能完整还原.
+         * 解密时同时兼容没有该标记的(按 StringToBytes 映射的)密文和旧的以垃圾符号结尾的密文.
+         * 长度或字符无效的密文在分配内存之前就被拒绝. 无效, 截断, 损坏或被篡改的密文都来自外部, 只返回空字符串/false
+         * 并计入失败统计(见 EcryptionStats.h), 不触发 ensure; ensure 只用于调用方的编程错误, 例如无效的密钥.
+         * 反复解密相同密文时可以开启结果缓存, 见 EcryptionCache.h.
+         */
         FString Encrypt(const FString& InputString, const FAES::FAESKey& Key);
         FString Decrypt(const FString& InputString, const FAES::FAESKey& Key);
         FString EncryptBase64(const FString& InputString, const FAES::FAESKey& Key);
         FString DecryptBase64(const FString& InputString, const FAES::FAESKey& Key);
+
+        /**
+         * 零拷贝版本: 密文/明文直接写入调用方提供的缓冲区, 复用其已有容量.
+         * 字符串明文以 UTF-8 加密, 字符串密文按 StringToBytes 的规则映射为字节, 与上面的 FString 版本互通.
+         * 解密到字节时返回原始负载, 由字符串加密得到的密文返回其 UTF-8 字节.
+         * 输出缓冲区不能与输入重叠.
+         */
+        bool Encrypt(TArrayView<const uint8> InputBytes, const FAES::FAESKey& Key, TArray<uint8>& OutCipher);
+        bool Encrypt(FStringView InputString, const FAES::FAESKey& Key, TArray<uint8>& OutCipher);
+        bool Decrypt(TArrayView<const uint8> InputCipher, const FAES::FAESKey& Key, TArray<uint8>& OutBytes);
+        bool Decrypt(FStringView InputString, const FAES::FAESKey& Key, TArray<uint8>& OutBytes);
+
+        /** 使用预先展开的密钥, 同一个密钥处理大量消息时省去每次的密钥展开. */
+        FString Encrypt(const FString& InputString, const FPreparedAESKey& Key);
+        FString Decrypt(const FString& InputString, const FPreparedAESKey& Key);
+        FString EncryptBase64(const FString& InputString, const FPreparedAESKey& Key);
+        FString DecryptBase64(const FString& InputString, const FPreparedAESKey& Key);
+        bool Encrypt(TArrayView<const uint8> InputBytes, const FPreparedAESKey& Key, TArray<uint8>& OutCipher);
+        bool Encrypt(FStringView InputString, const FPreparedAESKey& Key, TArray<uint8>& OutCipher);
+        bool Decrypt(TArrayView<const uint8> InputCipher, const FPreparedAESKey& Key, TArray<uint8>& OutBytes);
+        bool Decrypt(FStringView InputString, const FPreparedAESKey& Key, TArray<uint8>& OutBytes);
+
+        /**
+         * 传入临时字符串时使用的重载: 直接在输入字符串的内存上写出密文, 空余容量足够时不再分配, 结果与上面的版本相同.
+         * 例如 Encrypt(FString::Printf(...), Key). 输入字符串之后为空.
+         */
+        FString Encrypt(FString&& InputString, const FAES::FAESKey& Key);
+        FString EncryptBase64(FString&& InputString, const FAES::FAESKey& Key);
+        FString Encrypt(FString&& InputString, const FPreparedAESKey& Key);
+        FString EncryptBase64(FString&& InputString, const FPreparedAESKey& Key);
+
+        /**
+         * 原地版本: 直接在调用方的数组上加解密, 不创建第二个缓冲区或字符串, 密文与 Encrypt(TArrayView) 相同.
+         * 加密时负载后移给信封头让位并补零, 优先使用数组已有的空余容量, 不够时才扩容.
+         * 解密后数组只保留负载, 只有压缩过的密文需要临时空间解压.
+         * 长度无效的密文返回 false 且不修改数组, 其他解密失败时清空数组.
+         */
+        bool EncryptInPlace(TArray<uint8>& InOutBytes, const FAES::FAESKey& Key);
+        bool DecryptInPlace(TArray<uint8>& InOutBytes, const FAES::FAESKey& Key);
+        bool EncryptInPlace(TArray<uint8>& InOutBytes, const FPreparedAESKey& Key);
+        bool DecryptInPlace(TArray<uint8>& InOutBytes, const FPreparedAESKey& Key);
+
+        /**
+         * 先压缩再加密, 适合 JSON/配置文本这类重复较多的内容. 压缩后密文不会变小(例如已经压缩过的数据)时自动跳过.
+         * 压缩与否记录在信封标记中, 上面所有的 Decrypt/DecryptBase64 都能直接解密. 分段解密(FDecryptContext)不支持压缩过的密文.
+         */
+        FString Encrypt(const FString& InputString, const FAES::FAESKey& Key, EEcryptionCompression Compression);
+        FString EncryptBase64(const FString& InputString, const FAES::FAESKey& Key, EEcryptionCompression Compression);
+        bool Encrypt(TArrayView<const uint8> InputBytes, const FAES::FAESKey& Key, TArray<uint8>& OutCipher, EEcryptionCompression Compression);
+        bool Encrypt(FStringView InputString, const FAES::FAESKey& Key, TArray<uint8>& OutCipher, EEcryptionCompression Compression);
+        FString Encrypt(const FString& InputString, const FPreparedAESKey& Key, EEcryptionCompression Compression);
+        FString EncryptBase64(const FString& InputString, const FPreparedAESKey& Key, EEcryptionCompression Compression);
+        bool Encrypt(TArrayView<const uint8> InputBytes, const FPreparedAESKey& Key, TArray<uint8>& OutCipher, EEcryptionCompression Compression);
+        bool Encrypt(FStringView InputString, const FPreparedAESKey& Key, TArray<uint8>& OutCipher, EEcryptionCompression Compression);
+
+        /** 负载不小于该大小时 CTR 模式把计数器空间切成若干段, 由多个工作线程分别处理. */
+        static constexpr int32 CTRParallelThreshold = 1024 * 1024;
+
+        /**
+         * CTR 模式, 适合很大的负载: 密文 = 16 字节随机初始计数器块 + 与明文等长的数据, 不需要补齐.
+         * 各个块互不依赖, 超过 CTRParallelThreshold 时用 ParallelFor 分到所有核心.
+         * 与上面基于信封的格式不通用.
+         */
+        bool EncryptCTR(TArrayView<const uint8> InputBytes, const FAES::FAESKey& Key, TArray<uint8>& OutCipher);
+        bool DecryptCTR(TArrayView<const uint8> InputCipher, const FAES::FAESKey& Key, TArray<uint8>& OutBytes);
+        bool EncryptCTR(TArrayView<const uint8> InputBytes, const FPreparedAESKey& Key, TArray<uint8>& OutCipher);
+        bool DecryptCTR(TArrayView<const uint8> InputCipher, const FPreparedAESKey& Key, TArray<uint8>& OutBytes);
+
+        /**
+         * AES-GCM 认证加密(FAESKey 为 AES-256, FPreparedAESKey 按密钥长度): 密文 = 12 字节随机 nonce + 与明文等长的数据 + 16 字节认证标签.
+         * 解密时同时算出标签, 标签不符(密文被篡改或密钥不对)时返回 false/空字符串, 不会输出任何明文.
+         * 支持 AES-NI 和 PCLMULQDQ 时 CTR 加密与 GHASH 在同一个循环中交错执行.
+         * Base64 版本的字符串以 UTF-8 加密. 与上面的信封格式和 CTR 格式都不通用.
+         */
+        bool EncryptGCM(TArrayView<const uint8> InputBytes, const FAES::FAESKey& Key, TArray<uint8>& OutCipher);
+        bool DecryptGCM(TArrayView<const uint8> InputCipher, const FAES::FAESKey& Key, TArray<uint8>& OutBytes);
+        FString EncryptGCMBase64(const FString& InputString, const FAES::FAESKey& Key);
+        FString DecryptGCMBase64(const FString& InputString, const FAES::FAESKey& Key);
+        bool EncryptGCM(TArrayView<const uint8> InputBytes, const FPreparedAESKey& Key, TArray<uint8>& OutCipher);
+        bool DecryptGCM(TArrayView<const uint8> InputCipher, const FPreparedAESKey& Key, TArray<uint8>& OutBytes);
+        FString EncryptGCMBase64(const FString& InputString, const FPreparedAESKey& Key);
+        FString DecryptGCMBase64(const FString& InputString, const FPreparedAESKey& Key);
+
+        /**
+         * 以 FEncryptedBlob 返回密文, 不经过 BytesToString. 失败时返回空的 FEncryptedBlob.
+         * 字符串按上面的规则以 UTF-8 加密; 字节可以选择信封格式或 CTR 格式, 解密时按 Blob 中记录的格式处理.
+         */
+        FEncryptedBlob EncryptBlob(FStringView InputString, const FAES::FAESKey& Key);
+        FEncryptedBlob EncryptBlob(TArrayView<const uint8> InputBytes, const FAES::FAESKey& Key, EEncryptedBlobFormat Format = EEncryptedBlobFormat::Envelope);
+        bool DecryptBlob(const FEncryptedBlob& Blob, const FAES::FAESKey& Key, TArray<uint8>& OutBytes);
+        FString DecryptBlobToString(const FEncryptedBlob& Blob, const FAES::FAESKey& Key);
+        FEncryptedBlob EncryptBlob(FStringView InputString, const FPreparedAESKey& Key);
+        FEncryptedBlob EncryptBlob(TArrayView<const uint8> InputBytes, const FPreparedAESKey& Key, EEncryptedBlobFormat Format = EEncryptedBlobFormat::Envelope);
+        bool DecryptBlob(const FEncryptedBlob& Blob, const FPreparedAESKey& Key, TArray<uint8>& OutBytes);
+        FString DecryptBlobToString(const FEncryptedBlob& Blob, const FPreparedAESKey& Key);
     }
 }
@@ -0,0 +1,660 @@
+#include "EcryptionAES.h"
+#include "EcryptionCPU.h"
+
+#define ECRYPTION_WITH_AESNI ECRYPTION_WITH_X86_INTRINSICS
+#define ECRYPTION_TARGET_AESNI ECRYPTION_TARGET("aes,sse2")
+#if ECRYPTION_WITH_AESNI
+	#include <wmmintrin.h>
+	#include <emmintrin.h>
+#endif
+
+#if ECRYPTION_WITH_AESNI
+namespace UnrealUtils
+{
+	namespace Common
+	{
+		struct FAESKernelTable
+		{
+			void (*EncryptBlocks)(uint8* Contents, uint64 NumBlocks, const uint8* RoundKeys);
+			void (*DecryptBlocks)(uint8* Contents, uint64 NumBlocks, const uint8* RoundKeys);
+			void (*TransformBlocksCTR)(const uint8* Input, uint8* Output, uint64 NumBlocks, uint64 Nonce, uint64 Counter, const uint8* RoundKeys);
+			void (*EncryptBlocksMulti)(uint8* const* Contents, const uint64* NumBlocks, int32 NumBuffers, const uint8* RoundKeys);
+			void (*DecryptBlocksMulti)(uint8* const* Contents, const uint64* NumBlocks, int32 NumBuffers, const uint8* RoundKeys);
+		};
+	}
+}
+
+namespace
+{
+	/** 一次并行处理的块数, 用来填满 aesenc 的流水线. */
+	static constexpr int32 NumParallelBlocks = 8;
+	static_assert(NumParallelBlocks == UnrealUtils::Common::AESKernel::MaxMultiBufferLanes, "The multi-buffer kernel runs one message per parallel block.");
+
+	ECRYPTION_TARGET_AESNI FORCEINLINE __m128i ExpandAssist1(__m128i Key, __m128i Assist)
+	{
+		Assist = _mm_shuffle_epi32(Assist, 0xff);
+		__m128i Temp = _mm_slli_si128(Key, 4);
+		Key = _mm_xor_si128(Key, Temp);
+		Temp = _mm_slli_si128(Temp, 4);
+		Key = _mm_xor_si128(Key, Temp);
+		Temp = _mm_slli_si128(Temp, 4);
+		Key = _mm_xor_si128(Key, Temp);
+		return _mm_xor_si128(Key, Assist);
+	}
+
+	ECRYPTION_TARGET_AESNI FORCEINLINE __m128i ExpandAssist2(__m128i PrevKey, __m128i Key)
+	{
+		const __m128i Assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(PrevKey, 0x00), 0xaa);
+		__m128i Temp = _mm_slli_si128(Key, 4);
+		Key = _mm_xor_si128(Key, Temp);
+		Temp = _mm_slli_si128(Temp, 4);
+		Key = _mm_xor_si128(Key, Temp);
+		Temp = _mm_slli_si128(Temp, 4);
+		Key = _mm_xor_si128(Key, Temp);
+		return _mm_xor_si128(Key, Assist);
+	}
+
+	/** AES-192 的一步: Key0 是完整的 4 个字, Key1 只有低 2 个字有效. */
+	ECRYPTION_TARGET_AESNI FORCEINLINE void ExpandAssist192(__m128i& Key0, __m128i& Key1, __m128i Assist)
+	{
+		Key0 = ExpandAssist1(Key0, _mm_shuffle_epi32(Assist, 0x55));
+		const __m128i Last = _mm_shuffle_epi32(Key0, 0xff);
+		Key1 = _mm_xor_si128(_mm_xor_si128(Key1, _mm_slli_si128(Key1, 4)), Last);
+	}
+
+	/** 取 Low 的低 8 字节和 High 的低 8 字节拼成一个轮密钥. */
+	ECRYPTION_TARGET_AESNI FORCEINLINE __m128i CombineLow(__m128i Low, __m128i High)
+	{
+		return _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(Low), _mm_castsi128_pd(High), 0));
+	}
+
+	/** 取 Low 的高 8 字节和 High 的低 8 字节拼成一个轮密钥. */
+	ECRYPTION_TARGET_AESNI FORCEINLINE __m128i CombineHigh(__m128i Low, __m128i High)
+	{
+		return _mm_castpd_si128(_mm_shuffle_pd(_mm_castsi128_pd(Low), _mm_castsi128_pd(High), 1));
+	}
+
+	/** aeskeygenassist 的 rcon 必须是立即数, 所以三种密钥长度的展开都只能逐轮写出. */
+	ECRYPTION_TARGET_AESNI void ExpandEncryptKeys128(const uint8* KeyBytes, __m128i* RoundKeys)
+	{
+		__m128i Key0 = _mm_loadu_si128((const __m128i*)KeyBytes);
+		RoundKeys[0] = Key0;
+
+#define ECRYPTION_EXPAND_ROUND(Index, Rcon) \
+		Key0 = ExpandAssist1(Key0, _mm_aeskeygenassist_si128(Key0, Rcon)); \
+		RoundKeys[Index] = Key0;
+
+		ECRYPTION_EXPAND_ROUND(1, 0x01)
+		ECRYPTION_EXPAND_ROUND(2, 0x02)
+		ECRYPTION_EXPAND_ROUND(3, 0x04)
+		ECRYPTION_EXPAND_ROUND(4, 0x08)
+		ECRYPTION_EXPAND_ROUND(5, 0x10)
+		ECRYPTION_EXPAND_ROUND(6, 0x20)
+		ECRYPTION_EXPAND_ROUND(7, 0x40)
+		ECRYPTION_EXPAND_ROUND(8, 0x80)
+		ECRYPTION_EXPAND_ROUND(9, 0x1b)
+		ECRYPTION_EXPAND_ROUND(10, 0x36)
+#undef ECRYPTION_EXPAND_ROUND
+	}
+
+	/** 每两步生成 3 个轮密钥, 其中一个由前后两步各贡献一半. */
+	ECRYPTION_TARGET_AESNI void ExpandEncryptKeys192(const uint8* KeyBytes, __m128i* RoundKeys)
+	{
+		__m128i Key0 = _mm_loadu_si128((const __m128i*)KeyBytes);
+		__m128i Key1 = _mm_loadl_epi64((const __m128i*)(KeyBytes + 16));
+		RoundKeys[0] = Key0;
+
+#define ECRYPTION_EXPAND_ROUND(Index, Rcon0, Rcon1) \
+		{ \
+			const __m128i PrevKey1 = Key1; \
+			ExpandAssist192(Key0, Key1, _mm_aeskeygenassist_si128(Key1, Rcon0)); \
+			RoundKeys[Index] = CombineLow(PrevKey1, Key0); \
+			RoundKeys[Index + 1] = CombineHigh(Key0, Key1); \
+			ExpandAssist192(Key0, Key1, _mm_aeskeygenassist_si128(Key1, Rcon1)); \
+			RoundKeys[Index + 2] = Key0; \
+		}
+
+		ECRYPTION_EXPAND_ROUND(1, 0x01, 0x02)
+		ECRYPTION_EXPAND_ROUND(4, 0x04, 0x08)
+		ECRYPTION_EXPAND_ROUND(7, 0x10, 0x20)
+		ECRYPTION_EXPAND_ROUND(10, 0x40, 0x80)
+#undef ECRYPTION_EXPAND_ROUND
+	}
+
+	ECRYPTION_TARGET_AESNI void ExpandEncryptKeys256(const uint8* KeyBytes, __m128i* RoundKeys)
+	{
+		__m128i Key0 = _mm_loadu_si128((const __m128i*)KeyBytes);
+		__m128i Key1 = _mm_loadu_si128((const __m128i*)(KeyBytes + 16));
+		RoundKeys[0] = Key0;
+		RoundKeys[1] = Key1;
+
+#define ECRYPTION_EXPAND_ROUND(Index, Rcon) \
+		Key0 = ExpandAssist1(Key0, _mm_aeskeygenassist_si128(Key1, Rcon)); \
+		RoundKeys[Index] = Key0; \
+		Key1 = ExpandAssist2(Key0, Key1); \
+		RoundKeys[Index + 1] = Key1;
+
+		ECRYPTION_EXPAND_ROUND(2, 0x01)
+		ECRYPTION_EXPAND_ROUND(4, 0x02)
+		ECRYPTION_EXPAND_ROUND(6, 0x04)
+		ECRYPTION_EXPAND_ROUND(8, 0x08)
+		ECRYPTION_EXPAND_ROUND(10, 0x10)
+		ECRYPTION_EXPAND_ROUND(12, 0x20)
+#undef ECRYPTION_EXPAND_ROUND
+
+		RoundKeys[14] = ExpandAssist1(Key0, _mm_aeskeygenassist_si128(Key1, 0x40));
+	}
+
+	template <bool bEncrypt>
+	ECRYPTION_TARGET_AESNI FORCEINLINE __m128i AESRound(__m128i State, __m128i RoundKey)
+	{
+		return bEncrypt ? _mm_aesenc_si128(State, RoundKey) : _mm_aesdec_si128(State, RoundKey);
+	}
+
+	template <bool bEncrypt>
+	ECRYPTION_TARGET_AESNI FORCEINLINE __m128i AESLastRound(__m128i State, __m128i RoundKey)
+	{
+		return bEncrypt ? _mm_aesenclast_si128(State, RoundKey) : _mm_aesdeclast_si128(State, RoundKey);
+	}
+
+	/** 8 个状态各做一轮. */
+	template <bool bEncrypt>
+	ECRYPTION_TARGET_AESNI FORCEINLINE void AESRound8(__m128i* State, __m128i RoundKey)
+	{
+		State[0] = AESRound<bEncrypt>(State[0], RoundKey);
+		State[1] = AESRound<bEncrypt>(State[1], RoundKey);
+		State[2] = AESRound<bEncrypt>(State[2], RoundKey);
+		State[3] = AESRound<bEncrypt>(State[3], RoundKey);
+		State[4] = AESRound<bEncrypt>(State[4], RoundKey);
+		State[5] = AESRound<bEncrypt>(State[5], RoundKey);
+		State[6] = AESRound<bEncrypt>(State[6], RoundKey);
+		State[7] = AESRound<bEncrypt>(State[7], RoundKey);
+	}
+
+	/** 在编译期逐轮递归展开第 Round 到 LastRound - 1 轮, 生成的代码里没有轮数计数器和循环分支. */
+	template <bool bEncrypt, int32 Round, int32 LastRound>
+	ECRYPTION_TARGET_AESNI FORCEINLINE void AESRounds8(__m128i* State, const __m128i* RoundKeys)
+	{
+		if constexpr (Round < LastRound)
+		{
+			AESRound8<bEncrypt>(State, RoundKeys[Round]);
+			AESRounds8<bEncrypt, Round + 1, LastRound>(State, RoundKeys);
+		}
+	}
+
+	template <bool bEncrypt, int32 Round, int32 LastRound>
+	ECRYPTION_TARGET_AESNI FORCEINLINE __m128i AESRounds1(__m128i State, const __m128i* RoundKeys)
+	{
+		if constexpr (Round < LastRound)
+		{
+			return AESRounds1<bEncrypt, Round + 1, LastRound>(AESRound<bEncrypt>(State, RoundKeys[Round]), RoundKeys);
+		}
+		else
+		{
+			return State;
+		}
+	}
+
+	/** 第 Counter 个计数器块: 前 8 字节为 Nonce, 后 8 字节为大端的 Counter. */
+	ECRYPTION_TARGET_AESNI FORCEINLINE __m128i MakeCounterBlock(uint64 Nonce, uint64 Counter)
+	{
+#if PLATFORM_LITTLE_ENDIAN
+		Counter = BYTESWAP_ORDER64(Counter);
+#endif
+		return _mm_set_epi64x((int64)Counter, (int64)Nonce);
+	}
+
+	/**
+	 * 一种密钥长度的 AES: 轮数是编译期常量, 每块的轮函数完全展开.
+	 * FPreparedAESKey 构造时按密钥长度选定一个实例的 Kernels, 之后的调用只经过一次间接跳转.
+	 */
+	template <int32 KeyBits>
+	struct TAESCipher
+	{
+		static_assert(KeyBits == 128 || KeyBits == 192 || KeyBits == 256, "AES key must be 128, 192 or 256 bits.");
+
+		static constexpr int32 NumKeyBytes = KeyBits / 8;
+		static constexpr int32 NumRounds = KeyBits / 32 + 6;
+		static_assert(NumRounds <= UnrealUtils::Common::FPreparedAESKey::MaxNumRounds, "Round keys do not fit FPreparedAESKey.");
+
+		static const UnrealUtils::Common::FAESKernelTable Kernels;
+
+		ECRYPTION_TARGET_AESNI static void ExpandEncryptKeys(const uint8* KeyBytes, __m128i* RoundKeys)
+		{
+			if constexpr (KeyBits == 128)
+			{
+				ExpandEncryptKeys128(KeyBytes, RoundKeys);
+			}
+			else if constexpr (KeyBits == 192)
+			{
+				ExpandEncryptKeys192(KeyBytes, RoundKeys);
+			}
+			else
+			{
+				ExpandEncryptKeys256(KeyBytes, RoundKeys);
+			}
+		}
+
+		/** 由加密轮密钥得到等价逆密码所用的解密轮密钥. */
+		ECRYPTION_TARGET_AESNI static void ExpandDecryptKeys(const uint8* KeyBytes, __m128i* RoundKeys)
+		{
+			__m128i EncryptKeys[NumRounds + 1];
+			ExpandEncryptKeys(KeyBytes, EncryptKeys);
+
+			RoundKeys[0] = EncryptKeys[NumRounds];
+			for (int32 Round = 1; Round < NumRounds; ++Round)
+			{
+				RoundKeys[Round] = _mm_aesimc_si128(EncryptKeys[NumRounds - Round]);
+			}
+			RoundKeys[NumRounds] = EncryptKeys[0];
+		}
+
+		/** 每次 8 块交错执行, 让各块的 aesenc/aesdec 互相掩盖延迟; 8 个状态都保留在寄存器中. */
+		template <bool bEncrypt>
+		ECRYPTION_TARGET_AESNI static void TransformBlocks(uint8* Contents, uint64 NumBlocks, const uint8* RoundKeyBytes)
+		{
+			const __m128i* RoundKeys = (const __m128i*)RoundKeyBytes;
+			__m128i* Blocks = (__m128i*)Contents;
+			for (; NumBlocks >= NumParallelBlocks; NumBlocks -= NumParallelBlocks, Blocks += NumParallelBlocks)
+			{
+				const __m128i FirstKey = RoundKeys[0];
+				__m128i State[NumParallelBlocks];
+				State[0] = _mm_xor_si128(_mm_loadu_si128(Blocks + 0), FirstKey);
+				State[1] = _mm_xor_si128(_mm_loadu_si128(Blocks + 1), FirstKey);
+				State[2] = _mm_xor_si128(_mm_loadu_si128(Blocks + 2), FirstKey);
+				State[3] = _mm_xor_si128(_mm_loadu_si128(Blocks + 3), FirstKey);
+				State[4] = _mm_xor_si128(_mm_loadu_si128(Blocks + 4), FirstKey);
+				State[5] = _mm_xor_si128(_mm_loadu_si128(Blocks + 5), FirstKey);
+				State[6] = _mm_xor_si128(_mm_loadu_si128(Blocks + 6), FirstKey);
+				State[7] = _mm_xor_si128(_mm_loadu_si128(Blocks + 7), FirstKey);
+				AESRounds8<bEncrypt, 1, NumRounds>(State, RoundKeys);
+				const __m128i LastKey = RoundKeys[NumRounds];
+				_mm_storeu_si128(Blocks + 0, AESLastRound<bEncrypt>(State[0], LastKey));
+				_mm_storeu_si128(Blocks + 1, AESLastRound<bEncrypt>(State[1], LastKey));
+				_mm_storeu_si128(Blocks + 2, AESLastRound<bEncrypt>(State[2], LastKey));
+				_mm_storeu_si128(Blocks + 3, AESLastRound<bEncrypt>(State[3], LastKey));
+				_mm_storeu_si128(Blocks + 4, AESLastRound<bEncrypt>(State[4], LastKey));
+				_mm_storeu_si128(Blocks + 5, AESLastRound<bEncrypt>(State[5], LastKey));
+				_mm_storeu_si128(Blocks + 6, AESLastRound<bEncrypt>(State[6], LastKey));
+				_mm_storeu_si128(Blocks + 7, AESLastRound<bEncrypt>(State[7], LastKey));
+			}
+
+			for (; NumBlocks > 0; --NumBlocks, ++Blocks)
+			{
+				const __m128i State = AESRounds1<bEncrypt, 1, NumRounds>(_mm_xor_si128(_mm_loadu_si128(Blocks), RoundKeys[0]), RoundKeys);
+				_mm_storeu_si128(Blocks, AESLastRound<bEncrypt>(State, RoundKeys[NumRounds]));
+			}
+		}
+
+		/** 与 TransformBlocks 相同的 8 块交错, 计数器块直接在寄存器中生成, 加密后与输入异或. */
+		ECRYPTION_TARGET_AESNI static void TransformBlocksCTR(const uint8* Input, uint8* Output, uint64 NumBlocks, uint64 Nonce, uint64 Counter, const uint8* RoundKeyBytes)
+		{
+			const __m128i* RoundKeys = (const __m128i*)RoundKeyBytes;
+			const __m128i* InBlocks = (const __m128i*)Input;
+			__m128i* OutBlocks = (__m128i*)Output;
+			for (; NumBlocks >= NumParallelBlocks; NumBlocks -= NumParallelBlocks, InBlocks += NumParallelBlocks, OutBlocks += NumParallelBlocks, Counter += NumParallelBlocks)
+			{
+				const __m128i FirstKey = RoundKeys[0];
+				__m128i State[NumParallelBlocks];
+				State[0] = _mm_xor_si128(MakeCounterBlock(Nonce, Counter + 0), FirstKey);
+				State[1] = _mm_xor_si128(MakeCounterBlock(Nonce, Counter + 1), FirstKey);
+				State[2] = _mm_xor_si128(MakeCounterBlock(Nonce, Counter + 2), FirstKey);
+				State[3] = _mm_xor_si128(MakeCounterBlock(Nonce, Counter + 3), FirstKey);
+				State[4] = _mm_xor_si128(MakeCounterBlock(Nonce, Counter + 4), FirstKey);
+				State[5] = _mm_xor_si128(MakeCounterBlock(Nonce, Counter + 5), FirstKey);
+				State[6] = _mm_xor_si128(MakeCounterBlock(Nonce, Counter + 6), FirstKey);
+				State[7] = _mm_xor_si128(MakeCounterBlock(Nonce, Counter + 7), FirstKey);
+				AESRounds8<true, 1, NumRounds>(State, RoundKeys);
+				const __m128i LastKey = RoundKeys[NumRounds];
+				_mm_storeu_si128(OutBlocks + 0, _mm_xor_si128(_mm_aesenclast_si128(State[0], LastKey), _mm_loadu_si128(InBlocks + 0)));
+				_mm_storeu_si128(OutBlocks + 1, _mm_xor_si128(_mm_aesenclast_si128(State[1], LastKey), _mm_loadu_si128(InBlocks + 1)));
+				_mm_storeu_si128(OutBlocks + 2, _mm_xor_si128(_mm_aesenclast_si128(State[2], LastKey), _mm_loadu_si128(InBlocks + 2)));
+				_mm_storeu_si128(OutBlocks + 3, _mm_xor_si128(_mm_aesenclast_si128(State[3], LastKey), _mm_loadu_si128(InBlocks + 3)));
+				_mm_storeu_si128(OutBlocks + 4, _mm_xor_si128(_mm_aesenclast_si128(State[4], LastKey), _mm_loadu_si128(InBlocks + 4)));
+				_mm_storeu_si128(OutBlocks + 5, _mm_xor_si128(_mm_aesenclast_si128(State[5], LastKey), _mm_loadu_si128(InBlocks + 5)));
+				_mm_storeu_si128(OutBlocks + 6, _mm_xor_si128(_mm_aesenclast_si128(State[6], LastKey), _mm_loadu_si128(InBlocks + 6)));
+				_mm_storeu_si128(OutBlocks + 7, _mm_xor_si128(_mm_aesenclast_si128(State[7], LastKey), _mm_loadu_si128(InBlocks + 7)));
+			}
+
+			for (; NumBlocks > 0; --NumBlocks, ++InBlocks, ++OutBlocks, ++Counter)
+			{
+				const __m128i State = AESRounds1<true, 1, NumRounds>(_mm_xor_si128(MakeCounterBlock(Nonce, Counter), RoundKeys[0]), RoundKeys);
+				_mm_storeu_si128(OutBlocks, _mm_xor_si128(_mm_aesenclast_si128(State, RoundKeys[NumRounds]), _mm_loadu_si128(InBlocks)));
+			}
+		}
+
+		/**
+		 * 多缓冲: 8 条消息各占一路, 每一步每条消息推进一块, 8 路的状态与 TransformBlocks 一样交错执行.
+		 * 已经处理完的路读写栈上的占位块, 循环里只有选择指针的条件传送, 没有按路的分支.
+		 */
+		template <bool bEncrypt>
+		ECRYPTION_TARGET_AESNI static void TransformBlocksMulti(uint8* const* Contents, const uint64* NumBlocks, int32 NumBuffers, const uint8* RoundKeyBytes)
+		{
+			const __m128i* RoundKeys = (const __m128i*)RoundKeyBytes;
+			__m128i Sink[NumParallelBlocks];
+			__m128i* Blocks[NumParallelBlocks];
+			uint64 LaneBlocks[NumParallelBlocks];
+			uint64 MaxBlocks = 0;
+			for (int32 Lane = 0; Lane < NumParallelBlocks; ++Lane)
+			{
+				Sink[Lane] = _mm_setzero_si128();
+				Blocks[Lane] = Lane < NumBuffers ? (__m128i*)Contents[Lane] : nullptr;
+				LaneBlocks[Lane] = Lane < NumBuffers ? NumBlocks[Lane] : 0;
+				MaxBlocks = FMath::Max(MaxBlocks, LaneBlocks[Lane]);
+			}
+
+			for (uint64 Step = 0; Step < MaxBlocks; ++Step)
+			{
+				__m128i* Targets[NumParallelBlocks];
+				for (int32 Lane = 0; Lane < NumParallelBlocks; ++Lane)
+				{
+					Targets[Lane] = Step < LaneBlocks[Lane] ? Blocks[Lane] + Step : Sink + Lane;
+				}
+
+				const __m128i FirstKey = RoundKeys[0];
+				__m128i State[NumParallelBlocks];
+				State[0] = _mm_xor_si128(_mm_loadu_si128(Targets[0]), FirstKey);
+				State[1] = _mm_xor_si128(_mm_loadu_si128(Targets[1]), FirstKey);
+				State[2] = _mm_xor_si128(_mm_loadu_si128(Targets[2]), FirstKey);
+				State[3] = _mm_xor_si128(_mm_loadu_si128(Targets[3]), FirstKey);
+				State[4] = _mm_xor_si128(_mm_loadu_si128(Targets[4]), FirstKey);
+				State[5] = _mm_xor_si128(_mm_loadu_si128(Targets[5]), FirstKey);
+				State[6] = _mm_xor_si128(_mm_loadu_si128(Targets[6]), FirstKey);
+				State[7] = _mm_xor_si128(_mm_loadu_si128(Targets[7]), FirstKey);
+				AESRounds8<bEncrypt, 1, NumRounds>(State, RoundKeys);
+				const __m128i LastKey = RoundKeys[NumRounds];
+				_mm_storeu_si128(Targets[0], AESLastRound<bEncrypt>(State[0], LastKey));
+				_mm_storeu_si128(Targets[1], AESLastRound<bEncrypt>(State[1], LastKey));
+				_mm_storeu_si128(Targets[2], AESLastRound<bEncrypt>(State[2], LastKey));
+				_mm_storeu_si128(Targets[3], AESLastRound<bEncrypt>(State[3], LastKey));
+				_mm_storeu_si128(Targets[4], AESLastRound<bEncrypt>(State[4], LastKey));
+				_mm_storeu_si128(Targets[5], AESLastRound<bEncrypt>(State[5], LastKey));
+				_mm_storeu_si128(Targets[6], AESLastRound<bEncrypt>(State[6], LastKey));
+				_mm_storeu_si128(Targets[7], AESLastRound<bEncrypt>(State[7], LastKey));
+			}
+		}
+	};
+
+	using FAES128Cipher = TAESCipher<128>;
+	using FAES192Cipher = TAESCipher<192>;
+	using FAES256Cipher = TAESCipher<256>;
+}
+
+template <int32 KeyBits>
+const UnrealUtils::Common::FAESKernelTable TAESCipher<KeyBits>::Kernels =
+{
+	&TAESCipher<KeyBits>::template TransformBlocks<true>,
+	&TAESCipher<KeyBits>::template TransformBlocks<false>,
+	&TAESCipher<KeyBits>::TransformBlocksCTR,
+	&TAESCipher<KeyBits>::template TransformBlocksMulti<true>,
+	&TAESCipher<KeyBits>::template TransformBlocksMulti<false>,
+};
+
+namespace
+{
+	/** 展开轮密钥并返回这个密钥长度的内核. */
+	template <typename CipherType>
+	const UnrealUtils::Common::FAESKernelTable* PrepareRoundKeys(const uint8* KeyBytes, uint8* EncryptRoundKeys, uint8* DecryptRoundKeys)
+	{
+		CipherType::ExpandEncryptKeys(KeyBytes, (__m128i*)EncryptRoundKeys);
+		CipherType::ExpandDecryptKeys(KeyBytes, (__m128i*)DecryptRoundKeys);
+		return &CipherType::Kernels;
+	}
+}
+#endif
+
+namespace
+{
+	/** 析构时清除密钥材料; 通过 volatile 写入, 不会被编译器当作死存储优化掉. */
+	void WipeMemory(void* Data, SIZE_T NumBytes)
+	{
+		volatile uint8* Bytes = (volatile uint8*)Data;
+		while (NumBytes--)
+		{
+			*Bytes++ = 0;
+		}
+	}
+
+	/** CTR 每次生成的密钥流块数, 放在栈上并留在 L1 中. */
+	static constexpr int32 NumKeystreamBlocks = 64;
+}
+
+UnrealUtils::Common::FPreparedAESKey::FPreparedAESKey(const FAES::FAESKey& InKey)
+	: FPreparedAESKey(InKey.Key, FAES::FAESKey::KeySize)
+{
+}
+
+UnrealUtils::Common::FPreparedAESKey::FPreparedAESKey(const uint8* InKeyBytes, int32 InNumKeyBytes)
+	: Kernels(nullptr)
+	, NumKeyBytes(0)
+	, NumRounds(0)
+{
+	FMemory::Memzero(EncryptRoundKeys, sizeof(EncryptRoundKeys));
+	FMemory::Memzero(DecryptRoundKeys, sizeof(DecryptRoundKeys));
+	if (!ensureMsgf(InNumKeyBytes == 16 || InNumKeyBytes == 24 || InNumKeyBytes == 32, TEXT("AES key must be 16, 24 or 32 bytes, got %d."), InNumKeyBytes))
+	{
+		return;
+	}
+	FMemory::Memcpy(Key.Key, InKeyBytes, InNumKeyBytes);
+
+#if ECRYPTION_WITH_AESNI
+	if (AESKernel::HasHardwareSupport() && Key.IsValid())
+	{
+		switch (InNumKeyBytes)
+		{
+		case FAES128Cipher::NumKeyBytes:
+			Kernels = PrepareRoundKeys<FAES128Cipher>(Key.Key, EncryptRoundKeys, DecryptRoundKeys);
+			break;
+		case FAES192Cipher::NumKeyBytes:
+			Kernels = PrepareRoundKeys<FAES192Cipher>(Key.Key, EncryptRoundKeys, DecryptRoundKeys);
+			break;
+		default:
+			Kernels = PrepareRoundKeys<FAES256Cipher>(Key.Key, EncryptRoundKeys, DecryptRoundKeys);
+			break;
+		}
+		NumKeyBytes = InNumKeyBytes;
+		NumRounds = InNumKeyBytes / 4 + 6;
+		return;
+	}
+#endif
+	/** FAES 只实现了 AES-256. */
+	if (!ensureMsgf(InNumKeyBytes == FAES::FAESKey::KeySize, TEXT("AES-128/192 keys require AES-NI; only 32-byte keys are supported on this CPU.")))
+	{
+		WipeMemory(Key.Key, sizeof(Key.Key));
+		return;
+	}
+	NumKeyBytes = InNumKeyBytes;
+	NumRounds = FPreparedAESKey::MaxNumRounds;
+}
+
+UnrealUtils::Common::FPreparedAESKey::~FPreparedAESKey()
+{
+	WipeMemory(EncryptRoundKeys, sizeof(EncryptRoundKeys));
+	WipeMemory(DecryptRoundKeys, sizeof(DecryptRoundKeys));
+	WipeMemory(Key.Key, sizeof(Key.Key));
+}
+
+bool UnrealUtils::Common::AESKernel::HasHardwareSupport()
+{
+	return FCPUFeatures::Get().bAESNI;
+}
+
+void UnrealUtils::Common::AESKernel::EncryptData(uint8* Contents, uint64 NumBytes, const FAES::FAESKey& Key)
+{
+	if (HasHardwareSupport())
+	{
+		EncryptDataHardware(Contents, NumBytes, Key);
+		return;
+	}
+	FAES::EncryptData(Contents, NumBytes, Key);
+}
+
+void UnrealUtils::Common::AESKernel::DecryptData(uint8* Contents, uint64 NumBytes, const FAES::FAESKey& Key)
+{
+	if (HasHardwareSupport())
+	{
+		DecryptDataHardware(Contents, NumBytes, Key);
+		return;
+	}
+	FAES::DecryptData(Contents, NumBytes, Key);
+}
+
+void UnrealUtils::Common::AESKernel::EncryptData(uint8* Contents, uint64 NumBytes, const FPreparedAESKey& Key)
+{
+	check(NumBytes % FAES::AESBlockSize == 0);
+#if ECRYPTION_WITH_AESNI
+	if (Key.IsExpanded())
+	{
+		Key.GetKernels()->EncryptBlocks(Contents, NumBytes / FAES::AESBlockSize, Key.GetEncryptRoundKeys());
+		return;
+	}
+#endif
+	FAES::EncryptData(Contents, NumBytes, Key.GetKey());
+}
+
+void UnrealUtils::Common::AESKernel::DecryptData(uint8* Contents, uint64 NumBytes, const FPreparedAESKey& Key)
+{
+	check(NumBytes % FAES::AESBlockSize == 0);
+#if ECRYPTION_WITH_AESNI
+	if (Key.IsExpanded())
+	{
+		Key.GetKernels()->DecryptBlocks(Contents, NumBytes / FAES::AESBlockSize, Key.GetDecryptRoundKeys());
+		return;
+	}
+#endif
+	FAES::DecryptData(Contents, NumBytes, Key.GetKey());
+}
+
+void UnrealUtils::Common::AESKernel::EncryptDataMulti(uint8* const* Contents, const uint64* NumBytes, int32 NumBuffers, const FPreparedAESKey& Key)
+{
+	check(NumBuffers >= 0 && NumBuffers <= MaxMultiBufferLanes);
+	uint64 NumBlocks[MaxMultiBufferLanes];
+	for (int32 Index = 0; Index < NumBuffers; ++Index)
+	{
+		check(NumBytes[Index] % FAES::AESBlockSize == 0);
+		NumBlocks[Index] = NumBytes[Index] / FAES::AESBlockSize;
+	}
+#if ECRYPTION_WITH_AESNI
+	if (Key.IsExpanded())
+	{
+		Key.GetKernels()->EncryptBlocksMulti(Contents, NumBlocks, NumBuffers, Key.GetEncryptRoundKeys());
+		return;
+	}
+#endif
+	for (int32 Index = 0; Index < NumBuffers; ++Index)
+	{
+		FAES::EncryptData(Contents[Index], NumBytes[Index], Key.GetKey());
+	}
+}
+
+void UnrealUtils::Common::AESKernel::DecryptDataMulti(uint8* const* Contents, const uint64* NumBytes, int32 NumBuffers, const FPreparedAESKey& Key)
+{
+	check(NumBuffers >= 0 && NumBuffers <= MaxMultiBufferLanes);
+	uint64 NumBlocks[MaxMultiBufferLanes];
+	for (int32 Index = 0; Index < NumBuffers; ++Index)
+	{
+		check(NumBytes[Index] % FAES::AESBlockSize == 0);
+		NumBlocks[Index] = NumBytes[Index] / FAES::AESBlockSize;
+	}
+#if ECRYPTION_WITH_AESNI
+	if (Key.IsExpanded())
+	{
+		Key.GetKernels()->DecryptBlocksMulti(Contents, NumBlocks, NumBuffers, Key.GetDecryptRoundKeys());
+		return;
+	}
+#endif
+	for (int32 Index = 0; Index < NumBuffers; ++Index)
+	{
+		FAES::DecryptData(Contents[Index], NumBytes[Index], Key.GetKey());
+	}
+}
+
+void UnrealUtils::Common::AESKernel::EncryptDataHardware(uint8* Contents, uint64 NumBytes, const FAES::FAESKey& Key)
+{
+	check(NumBytes % FAES::AESBlockSize == 0);
+#if ECRYPTION_WITH_AESNI
+	__m128i RoundKeys[FAES256Cipher::NumRounds + 1];
+	FAES256Cipher::ExpandEncryptKeys(Key.Key, RoundKeys);
+	FAES256Cipher::TransformBlocks<true>(Contents, NumBytes / FAES::AESBlockSize, (const uint8*)RoundKeys);
+#else
+	FAES::EncryptData(Contents, NumBytes, Key);
+#endif
+}
+
+void UnrealUtils::Common::AESKernel::DecryptDataHardware(uint8* Contents, uint64 NumBytes, const FAES::FAESKey& Key)
+{
+	check(NumBytes % FAES::AESBlockSize == 0);
+#if ECRYPTION_WITH_AESNI
+	__m128i RoundKeys[FAES256Cipher::NumRounds + 1];
+	FAES256Cipher::ExpandDecryptKeys(Key.Key, RoundKeys);
+	FAES256Cipher::TransformBlocks<false>(Contents, NumBytes / FAES::AESBlockSize, (const uint8*)RoundKeys);
+#else
+	FAES::DecryptData(Contents, NumBytes, Key);
+#endif
+}
+
+void UnrealUtils::Common::AESKernel::TransformCTR(const uint8* Input, uint8* Output, uint64 NumBytes, const uint8* InitialCounter, uint64 FirstBlockIndex, const FPreparedAESKey& Key)
+{
+	uint64 Nonce = 0;
+	uint64 CounterBase = 0;
+	FMemory::Memcpy(&Nonce, InitialCounter, sizeof(Nonce));
+	FMemory::Memcpy(&CounterBase, InitialCounter + sizeof(Nonce), sizeof(CounterBase));
+#if PLATFORM_LITTLE_ENDIAN
+	CounterBase = BYTESWAP_ORDER64(CounterBase);
+#endif
+	uint64 Counter = CounterBase + FirstBlockIndex;
+
+#if ECRYPTION_WITH_AESNI
+	/** 整块部分直接走寄存器中的计数器, 只有最后不足一块的尾巴走下面的通用路径. */
+	if (Key.IsExpanded())
+	{
+		const uint64 NumFullBlocks = NumBytes / FAES::AESBlockSize;
+		Key.GetKernels()->TransformBlocksCTR(Input, Output, NumFullBlocks, Nonce, Counter, Key.GetEncryptRoundKeys());
+		Input += NumFullBlocks * FAES::AESBlockSize;
+		Output += NumFullBlocks * FAES::AESBlockSize;
+		NumBytes -= NumFullBlocks * FAES::AESBlockSize;
+		Counter += NumFullBlocks;
+	}
+#endif
+	if (NumBytes == 0)
+	{
+		return;
+	}
+
+	/** 先批量生成一段计数器块, 用 ECB 内核整体加密成密钥流, 再与输入异或. */
+	alignas(16) uint64 Keystream[NumKeystreamBlocks * 2];
+	while (NumBytes > 0)
+	{
+		const uint64 NumChunkBytes = FMath::Min<uint64>(NumBytes, sizeof(Keystream));
+		const int32 NumBlocks = (int32)((NumChunkBytes + FAES::AESBlockSize - 1) / FAES::AESBlockSize);
+		for (int32 Index = 0; Index < NumBlocks; ++Index, ++Counter)
+		{
+			Keystream[Index * 2] = Nonce;
+#if PLATFORM_LITTLE_ENDIAN
+			Keystream[Index * 2 + 1] = BYTESWAP_ORDER64(Counter);
+#else
+			Keystream[Index * 2 + 1] = Counter;
+#endif
+		}
+		EncryptData((uint8*)Keystream, NumBlocks * FAES::AESBlockSize, Key);
+
+		const uint64 NumWords = NumChunkBytes / sizeof(uint64);
+		for (uint64 Index = 0; Index < NumWords; ++Index)
+		{
+			uint64 Word;
+			FMemory::Memcpy(&Word, Input + Index * sizeof(uint64), sizeof(Word));
+			Word ^= Keystream[Index];
+			FMemory::Memcpy(Output + Index * sizeof(uint64), &Word, sizeof(Word));
+		}
+		const uint8* KeystreamBytes = (const uint8*)Keystream;
+		for (uint64 Index = NumWords * sizeof(uint64); Index < NumChunkBytes; ++Index)
+		{
+			Output[Index] = Input[Index] ^ KeystreamBytes[Index];
+		}
+
+		Input += NumChunkBytes;
+		Output += NumChunkBytes;
+		NumBytes -= NumChunkBytes;
+	}
+	WipeMemory(Keystream, sizeof(Keystream));
+}
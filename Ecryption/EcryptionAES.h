@@ -0,0 +1,88 @@
+// EcryptionAES.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/AES.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /** 按密钥长度实例化好的一组 AES-NI 内核, 定义在 EcryptionAES.cpp 中. */
+        struct FAESKernelTable;
+
+        /**
+         * 预先展开好加密和解密轮密钥的 AES 密钥, 支持 128/192/256 位.
+         * 构造时按密钥长度选定对应轮数的内核, 之后每次加解密不再判断密钥长度, 每块的轮函数完全展开.
+         * 构造后只读, 可以在多个线程之间共享; 同一个密钥处理大量消息时避免每次重新展开.
+         * 不支持 AES-NI 时只保存原始密钥, 由 FAES 处理, 此时只能使用 256 位密钥.
+         */
+        class alignas(PLATFORM_CACHE_LINE_SIZE) FPreparedAESKey
+        {
+        public:
+            static constexpr int32 MaxNumRounds = 14;
+            static constexpr int32 RoundKeysSize = (MaxNumRounds + 1) * FAES::AESBlockSize;
+
+            explicit FPreparedAESKey(const FAES::FAESKey& InKey);
+            /** InNumKeyBytes 为 16, 24 或 32, 分别对应 AES-128/192/256. */
+            FPreparedAESKey(const uint8* InKeyBytes, int32 InNumKeyBytes);
+            ~FPreparedAESKey();
+
+            bool IsValid() const { return NumRounds > 0 && Key.IsValid(); }
+            /** 原始密钥, 只有前 GetNumKeyBytes() 字节有效. */
+            const FAES::FAESKey& GetKey() const { return Key; }
+            int32 GetNumKeyBytes() const { return NumKeyBytes; }
+            int32 GetNumRounds() const { return NumRounds; }
+
+            /** 是否已展开轮密钥(即走 AES-NI). */
+            bool IsExpanded() const { return Kernels != nullptr; }
+            const FAESKernelTable* GetKernels() const { return Kernels; }
+            const uint8* GetEncryptRoundKeys() const { return EncryptRoundKeys; }
+            const uint8* GetDecryptRoundKeys() const { return DecryptRoundKeys; }
+
+        private:
+            uint8 EncryptRoundKeys[RoundKeysSize];
+            uint8 DecryptRoundKeys[RoundKeysSize];
+            FAES::FAESKey Key;
+            const FAESKernelTable* Kernels;
+            int32 NumKeyBytes;
+            int32 NumRounds;
+        };
+
+        /** AES ECB 内核. 支持 AES-NI 的 CPU 走硬件指令, 否则回退到 FAES. 接受 FAESKey 的重载都是 AES-256. */
+        namespace AESKernel
+        {
+            /** 当前 CPU 是否支持 AES-NI, 首次调用时通过 CPUID 检测. */
+            bool HasHardwareSupport();
+
+            /** 原地加解密, NumBytes 必须是 16 的倍数. */
+            void EncryptData(uint8* Contents, uint64 NumBytes, const FAES::FAESKey& Key);
+            void DecryptData(uint8* Contents, uint64 NumBytes, const FAES::FAESKey& Key);
+            void EncryptData(uint8* Contents, uint64 NumBytes, const FPreparedAESKey& Key);
+            void DecryptData(uint8* Contents, uint64 NumBytes, const FPreparedAESKey& Key);
+
+            /**
+             * CTR 模式: Output = Input ^ AES(计数器块), 加密和解密是同一个操作, NumBytes 不需要对齐.
+             * 第 Index 个块的计数器块 = InitialCounter 的后 8 字节按大端加上 FirstBlockIndex + Index (模 2^64).
+             * 可以把整个消息切成若干段分别调用, 只要 FirstBlockIndex 对应各段的起始位置. Input 可以等于 Output.
+             */
+            void TransformCTR(const uint8* Input, uint8* Output, uint64 NumBytes, const uint8* InitialCounter, uint64 FirstBlockIndex, const FPreparedAESKey& Key);
+
+            /** 多缓冲内核一次交错处理的消息数. */
+            static constexpr int32 MaxMultiBufferLanes = 8;
+
+            /**
+             * 同时原地加解密 NumBuffers(不超过 MaxMultiBufferLanes)条互不相关的消息, 每条的 NumBytes 必须是 16 的倍数.
+             * 1 到 4 块的短消息单独处理时受 aesenc 的延迟限制, 交错执行后每一步各条消息同时推进一块.
+             * 各条消息长度相近时效果最好. 缓冲区之间不能重叠.
+             */
+            void EncryptDataMulti(uint8* const* Contents, const uint64* NumBytes, int32 NumBuffers, const FPreparedAESKey& Key);
+            void DecryptDataMulti(uint8* const* Contents, const uint64* NumBytes, int32 NumBuffers, const FPreparedAESKey& Key);
+
+            /** 强制使用 AES-NI, 调用前必须确认 HasHardwareSupport() 为 true. */
+            void EncryptDataHardware(uint8* Contents, uint64 NumBytes, const FAES::FAESKey& Key);
+            void DecryptDataHardware(uint8* Contents, uint64 NumBytes, const FAES::FAESKey& Key);
+        }
+    }
+}
@@ -0,0 +1,163 @@
+#include "EcryptionAsync.h"
+#include "Ecryption.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/QueuedThreadPool.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	int32 AsyncInlineThreshold = 64 * 1024;
+	int32 AsyncMaxQueuedJobs = 64;
+	int32 AsyncNumThreads = 2;
+
+	FAutoConsoleVariableRef CVarAsyncInlineThreshold(
+		TEXT("Ecryption.Async.InlineThreshold"),
+		AsyncInlineThreshold,
+		TEXT("Inputs shorter than this many characters are encrypted/decrypted on the calling thread by EncryptAsync/DecryptAsync."));
+
+	FAutoConsoleVariableRef CVarAsyncMaxQueuedJobs(
+		TEXT("Ecryption.Async.MaxQueuedJobs"),
+		AsyncMaxQueuedJobs,
+		TEXT("Maximum number of EncryptAsync/DecryptAsync jobs queued on the crypto pool. Further calls run on the calling thread."));
+
+	FAutoConsoleVariableRef CVarAsyncNumThreads(
+		TEXT("Ecryption.Async.NumThreads"),
+		AsyncNumThreads,
+		TEXT("Number of crypto pool threads. Read when the pool is first used."));
+
+	std::atomic<int32> NumQueuedJobs{ 0 };
+
+	/** 执行一个任务后删除自己. 线程池销毁时未执行的任务也在 Abandon 中完成, 保证每个 TFuture 都能就绪. */
+	class FCryptoWork final : public IQueuedWork
+	{
+	public:
+		explicit FCryptoWork(TUniqueFunction<void()>&& InFunction)
+			: Function(MoveTemp(InFunction))
+		{
+		}
+
+		virtual void DoThreadedWork() override
+		{
+			Function();
+			delete this;
+		}
+
+		virtual void Abandon() override
+		{
+			Function();
+			delete this;
+		}
+
+	private:
+		TUniqueFunction<void()> Function;
+	};
+
+	FCriticalSection PoolLock;
+	FQueuedThreadPool* Pool = nullptr;
+	bool bPoolShutDown = false;
+
+	/** 第一次派发时创建线程池, 在引擎退出前销毁. 已经销毁后返回 nullptr, 调用方改为同步执行. */
+	FQueuedThreadPool* GetPool()
+	{
+		FScopeLock Lock(&PoolLock);
+		if (Pool != nullptr || bPoolShutDown)
+		{
+			return Pool;
+		}
+
+		FQueuedThreadPool* NewPool = FQueuedThreadPool::Allocate();
+		if (!NewPool->Create(FMath::Max(AsyncNumThreads, 1), 128 * 1024, TPri_BelowNormal, TEXT("EcryptionThreadPool")))
+		{
+			delete NewPool;
+			bPoolShutDown = true;
+			return nullptr;
+		}
+		Pool = NewPool;
+		FCoreDelegates::OnPreExit.AddLambda([]()
+		{
+			FScopeLock Lock(&PoolLock);
+			bPoolShutDown = true;
+			if (Pool != nullptr)
+			{
+				Pool->Destroy();
+				delete Pool;
+				Pool = nullptr;
+			}
+		});
+		return Pool;
+	}
+
+	/** 占用一个排队名额, 队列已满时返回 false. */
+	bool TryReserveJob()
+	{
+		const int32 MaxQueuedJobs = FMath::Max(AsyncMaxQueuedJobs, 1);
+		int32 NumJobs = NumQueuedJobs.load(std::memory_order_relaxed);
+		do
+		{
+			if (NumJobs >= MaxQueuedJobs)
+			{
+				return false;
+			}
+		} while (!NumQueuedJobs.compare_exchange_weak(NumJobs, NumJobs + 1, std::memory_order_relaxed));
+		return true;
+	}
+
+	using FOperation = FString(*)(const FString&, const UnrealUtils::Common::FPreparedAESKey&);
+
+	/**
+	 * 小输入或队列已满时在调用线程上执行 Operation, 否则派发到线程池.
+	 * 任务共享调用方密钥的一份副本, 最后一个引用释放时由 FPreparedAESKey 的析构清除, 任务对象中不保存原始密钥.
+	 */
+	TFuture<FString> Dispatch(FString&& InputString, const UnrealUtils::Common::FPreparedAESKey& Key, FOperation Operation)
+	{
+		if (InputString.Len() < AsyncInlineThreshold || !TryReserveJob())
+		{
+			return MakeFulfilledPromise<FString>(Operation(InputString, Key)).GetFuture();
+		}
+
+		FQueuedThreadPool* ThreadPool = GetPool();
+		if (ThreadPool == nullptr)
+		{
+			NumQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			return MakeFulfilledPromise<FString>(Operation(InputString, Key)).GetFuture();
+		}
+
+		TPromise<FString> Promise;
+		TFuture<FString> Future = Promise.GetFuture();
+		const TSharedRef<const UnrealUtils::Common::FPreparedAESKey, ESPMode::ThreadSafe> SharedKey = MakeShared<UnrealUtils::Common::FPreparedAESKey, ESPMode::ThreadSafe>(Key);
+		ThreadPool->AddQueuedWork(new FCryptoWork([Promise = MoveTemp(Promise), InputString = MoveTemp(InputString), SharedKey, Operation]() mutable
+		{
+			FString Result = Operation(InputString, *SharedKey);
+			/** 先释放名额再完成, 让 Then 回调中发起的新任务能进入队列. */
+			NumQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			Promise.SetValue(MoveTemp(Result));
+		}));
+		return Future;
+	}
+}
+
+TFuture<FString> UnrealUtils::Common::EncryptAsync(FString InputString, const FAES::FAESKey& Key)
+{
+	return EncryptAsync(MoveTemp(InputString), FPreparedAESKey(Key));
+}
+
+TFuture<FString> UnrealUtils::Common::DecryptAsync(FString InputString, const FAES::FAESKey& Key)
+{
+	return DecryptAsync(MoveTemp(InputString), FPreparedAESKey(Key));
+}
+
+TFuture<FString> UnrealUtils::Common::EncryptAsync(FString InputString, const FPreparedAESKey& Key)
+{
+	return Dispatch(MoveTemp(InputString), Key, static_cast<FOperation>(&Encrypt));
+}
+
+TFuture<FString> UnrealUtils::Common::DecryptAsync(FString InputString, const FPreparedAESKey& Key)
+{
+	return Dispatch(MoveTemp(InputString), Key, static_cast<FOperation>(&Decrypt));
+}
+
+int32 UnrealUtils::Common::GetNumQueuedAsyncJobs()
+{
+	return NumQueuedJobs.load(std::memory_order_relaxed);
+}
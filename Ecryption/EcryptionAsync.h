@@ -0,0 +1,30 @@
+// EcryptionAsync.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Misc/AES.h"
+#include "EcryptionAES.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /**
+         * Encrypt/Decrypt 的异步版本, 在专用的加解密线程池上执行, 避免大负载在游戏线程上造成卡顿.
+         * 输入按值传入(可以 MoveTemp), 密钥被复制到任务中, 调用返回后原密钥可以立即销毁.
+         * 字符数小于 Ecryption.Async.InlineThreshold 时直接在调用线程上完成, 返回已就绪的 TFuture.
+         * 排队的任务达到 Ecryption.Async.MaxQueuedJobs 时新的调用同样在调用线程上完成, 以此限制队列长度和内存占用.
+         * 线程数由 Ecryption.Async.NumThreads 决定, 在第一次派发时创建线程池.
+         * 需要回调时使用 TFuture::Then/Next, 回调在工作线程上执行.
+         */
+        TFuture<FString> EncryptAsync(FString InputString, const FAES::FAESKey& Key);
+        TFuture<FString> DecryptAsync(FString InputString, const FAES::FAESKey& Key);
+        TFuture<FString> EncryptAsync(FString InputString, const FPreparedAESKey& Key);
+        TFuture<FString> DecryptAsync(FString InputString, const FPreparedAESKey& Key);
+
+        /** 当前在线程池中排队或执行的任务数. */
+        int32 GetNumQueuedAsyncJobs();
+    }
+}
@@ -0,0 +1,449 @@
+#include "EcryptionBase64.h"
+#include "EcryptionCPU.h"
+
+#if ECRYPTION_WITH_X86_INTRINSICS
+	#include <immintrin.h>
+#endif
+
+namespace
+{
+	static constexpr ANSICHAR EncodeTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	/** 非法字符在解码表中的值, 解码时把所有查表结果或在一起, 最后只需检查这一位. */
+	static constexpr uint8 InvalidValue = 0x80;
+
+	struct FDecodeTable
+	{
+		uint8 Values[256];
+
+		FDecodeTable()
+		{
+			FMemory::Memset(Values, InvalidValue, sizeof(Values));
+			for (int32 Index = 0; Index < 64; ++Index)
+			{
+				Values[(uint8)EncodeTable[Index]] = (uint8)Index;
+			}
+		}
+	};
+	const FDecodeTable DecodeTable;
+
+	FORCEINLINE uint32 DecodeChar(TCHAR Char)
+	{
+		return (uint32)Char < 256 ? DecodeTable.Values[(uint32)Char] : InvalidValue;
+	}
+
+	void EncodeScalar(const uint8* Source, uint32 Length, TCHAR* Dest)
+	{
+		for (; Length >= 3; Length -= 3, Source += 3, Dest += 4)
+		{
+			const uint32 Value = ((uint32)Source[0] << 16) | ((uint32)Source[1] << 8) | (uint32)Source[2];
+			Dest[0] = EncodeTable[Value >> 18];
+			Dest[1] = EncodeTable[(Value >> 12) & 63];
+			Dest[2] = EncodeTable[(Value >> 6) & 63];
+			Dest[3] = EncodeTable[Value & 63];
+		}
+		if (Length > 0)
+		{
+			const uint32 Value = ((uint32)Source[0] << 16) | (Length > 1 ? (uint32)Source[1] << 8 : 0);
+			Dest[0] = EncodeTable[Value >> 18];
+			Dest[1] = EncodeTable[(Value >> 12) & 63];
+			Dest[2] = Length > 1 ? EncodeTable[(Value >> 6) & 63] : TEXT('=');
+			Dest[3] = TEXT('=');
+		}
+	}
+
+	/** 解码完整的 4 字符组(不含 '='), 出现非法字符时返回值带有 InvalidValue 位. */
+	uint32 DecodeScalar(const TCHAR* Source, uint32 Length, uint8* Dest)
+	{
+		uint32 Error = 0;
+		for (; Length >= 4; Length -= 4, Source += 4, Dest += 3)
+		{
+			const uint32 A = DecodeChar(Source[0]);
+			const uint32 B = DecodeChar(Source[1]);
+			const uint32 C = DecodeChar(Source[2]);
+			const uint32 D = DecodeChar(Source[3]);
+			Error |= A | B | C | D;
+
+			const uint32 Value = (A << 18) | (B << 12) | (C << 6) | D;
+			Dest[0] = (uint8)(Value >> 16);
+			Dest[1] = (uint8)(Value >> 8);
+			Dest[2] = (uint8)Value;
+		}
+		return Error & InvalidValue;
+	}
+
+#if ECRYPTION_WITH_X86_INTRINSICS
+	/**
+	 * 向量化实现参考 Wojciech Muła 的 SSE/AVX2 Base64 算法:
+	 * 编码时用 pshufb 把 3 字节展开成 4 个 6 位索引, 再按区间查表得到 ASCII;
+	 * 解码时按高/低半字节查表, 一次得到偏移量并用位掩码校验字符.
+	 * 这里的字符都是 16 位 TCHAR, 因此额外做一次 8/16 位之间的宽化和收窄.
+	 */
+
+	/** 把 16 个 6 位索引转换为 ASCII. */
+	ECRYPTION_TARGET("ssse3") FORCEINLINE __m128i IndicesToASCII(__m128i Indices)
+	{
+		const __m128i ShiftLUT = _mm_setr_epi8(
+			'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+		/** 0..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12; 再把 0..25 区分为 13. */
+		__m128i Selector = _mm_subs_epu8(Indices, _mm_set1_epi8(51));
+		const __m128i IsUpper = _mm_cmpgt_epi8(_mm_set1_epi8(26), Indices);
+		Selector = _mm_or_si128(Selector, _mm_and_si128(IsUpper, _mm_set1_epi8(13)));
+		return _mm_add_epi8(_mm_shuffle_epi8(ShiftLUT, Selector), Indices);
+	}
+
+	/** 每个 32 位中的 3 个源字节(已经过 pshufb 排列)拆成 4 个 6 位索引. */
+	ECRYPTION_TARGET("ssse3") FORCEINLINE __m128i SplitIndices(__m128i Input)
+	{
+		const __m128i Shuffled = _mm_shuffle_epi8(Input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		const __m128i High = _mm_mulhi_epu16(_mm_and_si128(Shuffled, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+		const __m128i Low = _mm_mullo_epi16(_mm_and_si128(Shuffled, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+		return _mm_or_si128(High, Low);
+	}
+
+	/** 把 16 个 ASCII 字符转换为 6 位值, 非法字符在 Error 中对应的字节置位. */
+	ECRYPTION_TARGET("ssse3") FORCEINLINE __m128i ASCIIToValues(__m128i Input, __m128i& Error)
+	{
+		const __m128i ShiftLUT = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+		/** 按低半字节索引, 每一位表示允许的高半字节. */
+		const __m128i MaskLUT = _mm_setr_epi8(
+			(char)0xa8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8,
+			(char)0xf8, (char)0xf8, (char)0xf0, (char)0x54, (char)0x50, (char)0x50, (char)0x50, (char)0x54);
+		const __m128i BitLUT = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)0x80, 0, 0, 0, 0, 0, 0, 0, 0);
+
+		const __m128i HighNibbles = _mm_and_si128(_mm_srli_epi32(Input, 4), _mm_set1_epi8(0x0f));
+		const __m128i LowNibbles = _mm_and_si128(Input, _mm_set1_epi8(0x0f));
+		const __m128i Allowed = _mm_and_si128(_mm_shuffle_epi8(MaskLUT, LowNibbles), _mm_shuffle_epi8(BitLUT, HighNibbles));
+		Error = _mm_or_si128(Error, _mm_cmpeq_epi8(Allowed, _mm_setzero_si128()));
+
+		/** '+' 与 '/' 的高半字节相同, '/' 的偏移是 16 而不是 19. */
+		const __m128i IsSlash = _mm_cmpeq_epi8(Input, _mm_set1_epi8('/'));
+		const __m128i Shift = _mm_sub_epi8(_mm_shuffle_epi8(ShiftLUT, HighNibbles), _mm_and_si128(IsSlash, _mm_set1_epi8(3)));
+		return _mm_add_epi8(Input, Shift);
+	}
+
+	/** 每 4 个 6 位值合并为 3 字节, 结果位于低 12 字节. */
+	ECRYPTION_TARGET("ssse3") FORCEINLINE __m128i PackValues(__m128i Values)
+	{
+		const __m128i Merged = _mm_madd_epi16(_mm_maddubs_epi16(Values, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+		return _mm_shuffle_epi8(Merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	}
+
+	/** 每次读 16 字节(使用其中 12 字节), 写 16 个字符. 返回已处理的字节数. */
+	ECRYPTION_TARGET("ssse3") uint32 EncodeSSSE3(const uint8* Source, uint32 Length, TCHAR* Dest)
+	{
+		uint32 Consumed = 0;
+		for (; Length - Consumed >= 16; Consumed += 12, Dest += 16)
+		{
+			const __m128i ASCII = IndicesToASCII(SplitIndices(_mm_loadu_si128((const __m128i*)(Source + Consumed))));
+			_mm_storeu_si128((__m128i*)Dest, _mm_unpacklo_epi8(ASCII, _mm_setzero_si128()));
+			_mm_storeu_si128((__m128i*)(Dest + 8), _mm_unpackhi_epi8(ASCII, _mm_setzero_si128()));
+		}
+		return Consumed;
+	}
+
+	/** 每次读 16 个字符, 写 16 字节(其中 12 字节有效), 调用方保证 Dest 后面有足够空间. 返回已处理的字符数. */
+	ECRYPTION_TARGET("ssse3") uint32 DecodeSSSE3(const TCHAR* Source, uint32 Length, uint8* Dest, __m128i& Error)
+	{
+		uint32 Consumed = 0;
+		for (; Length - Consumed >= 24; Consumed += 16, Dest += 12)
+		{
+			/** 收窄到 8 位: 大于 255 的字符饱和为 0xFF, 负数饱和为 0, 两者都是非法字符. */
+			const __m128i Low = _mm_loadu_si128((const __m128i*)(Source + Consumed));
+			const __m128i High = _mm_loadu_si128((const __m128i*)(Source + Consumed + 8));
+			const __m128i Values = ASCIIToValues(_mm_packus_epi16(Low, High), Error);
+			_mm_storeu_si128((__m128i*)Dest, PackValues(Values));
+		}
+		return Consumed;
+	}
+
+	ECRYPTION_TARGET("avx2") FORCEINLINE __m256i IndicesToASCIIAVX2(__m256i Indices)
+	{
+		const __m256i ShiftLUT = _mm256_setr_epi8(
+			'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+			'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+		__m256i Selector = _mm256_subs_epu8(Indices, _mm256_set1_epi8(51));
+		const __m256i IsUpper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), Indices);
+		Selector = _mm256_or_si256(Selector, _mm256_and_si256(IsUpper, _mm256_set1_epi8(13)));
+		return _mm256_add_epi8(_mm256_shuffle_epi8(ShiftLUT, Selector), Indices);
+	}
+
+	ECRYPTION_TARGET("avx2") FORCEINLINE __m256i SplitIndicesAVX2(__m256i Input)
+	{
+		const __m256i Shuffled = _mm256_shuffle_epi8(Input, _mm256_set_epi8(
+			10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+			10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		const __m256i High = _mm256_mulhi_epu16(_mm256_and_si256(Shuffled, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+		const __m256i Low = _mm256_mullo_epi16(_mm256_and_si256(Shuffled, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+		return _mm256_or_si256(High, Low);
+	}
+
+	ECRYPTION_TARGET("avx2") FORCEINLINE __m256i ASCIIToValuesAVX2(__m256i Input, __m256i& Error)
+	{
+		const __m256i ShiftLUT = _mm256_setr_epi8(
+			0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+		const __m256i MaskLUT = _mm256_setr_epi8(
+			(char)0xa8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8,
+			(char)0xf8, (char)0xf8, (char)0xf0, (char)0x54, (char)0x50, (char)0x50, (char)0x50, (char)0x54,
+			(char)0xa8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8, (char)0xf8,
+			(char)0xf8, (char)0xf8, (char)0xf0, (char)0x54, (char)0x50, (char)0x50, (char)0x50, (char)0x54);
+		const __m256i BitLUT = _mm256_setr_epi8(
+			1, 2, 4, 8, 16, 32, 64, (char)0x80, 0, 0, 0, 0, 0, 0, 0, 0,
+			1, 2, 4, 8, 16, 32, 64, (char)0x80, 0, 0, 0, 0, 0, 0, 0, 0);
+
+		const __m256i HighNibbles = _mm256_and_si256(_mm256_srli_epi32(Input, 4), _mm256_set1_epi8(0x0f));
+		const __m256i LowNibbles = _mm256_and_si256(Input, _mm256_set1_epi8(0x0f));
+		const __m256i Allowed = _mm256_and_si256(_mm256_shuffle_epi8(MaskLUT, LowNibbles), _mm256_shuffle_epi8(BitLUT, HighNibbles));
+		Error = _mm256_or_si256(Error, _mm256_cmpeq_epi8(Allowed, _mm256_setzero_si256()));
+
+		const __m256i IsSlash = _mm256_cmpeq_epi8(Input, _mm256_set1_epi8('/'));
+		const __m256i Shift = _mm256_sub_epi8(_mm256_shuffle_epi8(ShiftLUT, HighNibbles), _mm256_and_si256(IsSlash, _mm256_set1_epi8(3)));
+		return _mm256_add_epi8(Input, Shift);
+	}
+
+	/** 每次读 28 字节(两条 128 位通道各取 12 字节), 写 32 个字符. */
+	ECRYPTION_TARGET("avx2") uint32 EncodeAVX2(const uint8* Source, uint32 Length, TCHAR* Dest)
+	{
+		uint32 Consumed = 0;
+		for (; Length - Consumed >= 28; Consumed += 24, Dest += 32)
+		{
+			const __m128i LowLane = _mm_loadu_si128((const __m128i*)(Source + Consumed));
+			const __m128i HighLane = _mm_loadu_si128((const __m128i*)(Source + Consumed + 12));
+			const __m256i Input = _mm256_inserti128_si256(_mm256_castsi128_si256(LowLane), HighLane, 1);
+			const __m256i ASCII = IndicesToASCIIAVX2(SplitIndicesAVX2(Input));
+			_mm256_storeu_si256((__m256i*)Dest, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(ASCII)));
+			_mm256_storeu_si256((__m256i*)(Dest + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(ASCII, 1)));
+		}
+		return Consumed;
+	}
+
+	/** 每次读 32 个字符, 写 32 字节(其中 24 字节有效). */
+	ECRYPTION_TARGET("avx2") uint32 DecodeAVX2(const TCHAR* Source, uint32 Length, uint8* Dest, __m128i& Error)
+	{
+		__m256i WideError = _mm256_setzero_si256();
+		uint32 Consumed = 0;
+		for (; Length - Consumed >= 48; Consumed += 32, Dest += 24)
+		{
+			const __m256i Low = _mm256_loadu_si256((const __m256i*)(Source + Consumed));
+			const __m256i High = _mm256_loadu_si256((const __m256i*)(Source + Consumed + 16));
+			/** packus 按 128 位通道交错, 再把 64 位块排回原来的顺序. */
+			const __m256i Input = _mm256_permute4x64_epi64(_mm256_packus_epi16(Low, High), 0xd8);
+			const __m256i Values = ASCIIToValuesAVX2(Input, WideError);
+
+			const __m256i Merged = _mm256_madd_epi16(_mm256_maddubs_epi16(Values, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+			const __m256i Packed = _mm256_shuffle_epi8(Merged, _mm256_setr_epi8(
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+			_mm256_storeu_si256((__m256i*)Dest, _mm256_permutevar8x32_epi32(Packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7)));
+		}
+		Error = _mm_or_si128(Error, _mm_or_si128(_mm256_castsi256_si128(WideError), _mm256_extracti128_si256(WideError, 1)));
+		return Consumed;
+	}
+
+	/** 只校验字符, 不写出任何结果. 返回已检查的字符数. */
+	ECRYPTION_TARGET("ssse3") uint32 ValidateSSSE3(const TCHAR* Source, uint32 Length, __m128i& Error)
+	{
+		uint32 Consumed = 0;
+		for (; Length - Consumed >= 16; Consumed += 16)
+		{
+			const __m128i Low = _mm_loadu_si128((const __m128i*)(Source + Consumed));
+			const __m128i High = _mm_loadu_si128((const __m128i*)(Source + Consumed + 8));
+			ASCIIToValues(_mm_packus_epi16(Low, High), Error);
+		}
+		return Consumed;
+	}
+
+	ECRYPTION_TARGET("avx2") uint32 ValidateAVX2(const TCHAR* Source, uint32 Length, __m128i& Error)
+	{
+		__m256i WideError = _mm256_setzero_si256();
+		uint32 Consumed = 0;
+		for (; Length - Consumed >= 32; Consumed += 32)
+		{
+			const __m256i Low = _mm256_loadu_si256((const __m256i*)(Source + Consumed));
+			const __m256i High = _mm256_loadu_si256((const __m256i*)(Source + Consumed + 16));
+			ASCIIToValuesAVX2(_mm256_packus_epi16(Low, High), WideError);
+		}
+		Error = _mm_or_si128(Error, _mm_or_si128(_mm256_castsi256_si128(WideError), _mm256_extracti128_si256(WideError, 1)));
+		return Consumed;
+	}
+#endif
+}
+
+uint32 UnrealUtils::Common::Base64::GetEncodedSize(uint32 NumBytes)
+{
+	return ((NumBytes + 2) / 3) * 4;
+}
+
+uint32 UnrealUtils::Common::Base64::Encode(const uint8* Source, uint32 Length, TCHAR* Dest)
+{
+	uint32 Consumed = 0;
+#if ECRYPTION_WITH_X86_INTRINSICS
+	if (sizeof(TCHAR) == 2)
+	{
+		const FCPUFeatures& Features = FCPUFeatures::Get();
+		if (Features.bAVX2)
+		{
+			Consumed += EncodeAVX2(Source, Length, Dest);
+		}
+		if (Features.bSSSE3)
+		{
+			Consumed += EncodeSSSE3(Source + Consumed, Length - Consumed, Dest + Consumed / 3 * 4);
+		}
+	}
+#endif
+	EncodeScalar(Source + Consumed, Length - Consumed, Dest + Consumed / 3 * 4);
+	return GetEncodedSize(Length);
+}
+
+FString UnrealUtils::Common::Base64::Encode(const uint8* Source, uint32 Length)
+{
+	FString Result;
+	const uint32 EncodedSize = GetEncodedSize(Length);
+	if (EncodedSize == 0)
+	{
+		return Result;
+	}
+	TArray<TCHAR>& Chars = Result.GetCharArray();
+	Chars.AddUninitialized(EncodedSize + 1);
+	Encode(Source, Length, Chars.GetData());
+	Chars[EncodedSize] = TEXT('\0');
+	return Result;
+}
+
+bool UnrealUtils::Common::Base64::GetDecodedSize(const TCHAR* Source, uint32 Length, uint32& OutSize)
+{
+	if (Length % 4 != 0)
+	{
+		return false;
+	}
+	uint32 Padding = 0;
+	if (Length > 0 && Source[Length - 1] == TEXT('='))
+	{
+		Padding = Source[Length - 2] == TEXT('=') ? 2 : 1;
+	}
+	OutSize = Length / 4 * 3 - Padding;
+	return true;
+}
+
+bool UnrealUtils::Common::Base64::Validate(const TCHAR* Source, uint32 Length, uint32& OutSize)
+{
+	if (Length == 0 || Length % 4 != 0)
+	{
+		return false;
+	}
+	/** '=' 只能出现在最后两个字符, 其余位置的 '=' 由下面的字符校验拒绝. */
+	uint32 Padding = 0;
+	if (Source[Length - 1] == TEXT('='))
+	{
+		Padding = Source[Length - 2] == TEXT('=') ? 2 : 1;
+	}
+	const uint32 NumChars = Length - Padding;
+
+	uint32 Consumed = 0;
+	uint32 Error = 0;
+#if ECRYPTION_WITH_X86_INTRINSICS
+	if (sizeof(TCHAR) == 2)
+	{
+		const FCPUFeatures& Features = FCPUFeatures::Get();
+		if (Features.bSSSE3)
+		{
+			__m128i VectorError = _mm_setzero_si128();
+			if (Features.bAVX2)
+			{
+				Consumed += ValidateAVX2(Source, NumChars, VectorError);
+			}
+			Consumed += ValidateSSSE3(Source + Consumed, NumChars - Consumed, VectorError);
+			Error |= (uint32)_mm_movemask_epi8(VectorError);
+		}
+	}
+#endif
+	for (; Consumed < NumChars; ++Consumed)
+	{
+		Error |= DecodeChar(Source[Consumed]) & InvalidValue;
+	}
+	if (Error != 0)
+	{
+		return false;
+	}
+	OutSize = Length / 4 * 3 - Padding;
+	return true;
+}
+
+bool UnrealUtils::Common::Base64::Decode(const TCHAR* Source, uint32 Length, uint8* Dest)
+{
+	uint32 DecodedSize = 0;
+	if (!GetDecodedSize(Source, Length, DecodedSize))
+	{
+		return false;
+	}
+	if (Length == 0)
+	{
+		return true;
+	}
+
+	/** 最后一组可能带 '=', 单独处理; 其余部分先走向量化实现. */
+	const uint32 MainLength = Length - 4;
+	uint32 Consumed = 0;
+	uint32 Error = 0;
+#if ECRYPTION_WITH_X86_INTRINSICS
+	if (sizeof(TCHAR) == 2)
+	{
+		const FCPUFeatures& Features = FCPUFeatures::Get();
+		if (Features.bSSSE3)
+		{
+			__m128i VectorError = _mm_setzero_si128();
+			if (Features.bAVX2)
+			{
+				Consumed += DecodeAVX2(Source, MainLength, Dest, VectorError);
+			}
+			Consumed += DecodeSSSE3(Source + Consumed, MainLength - Consumed, Dest + Consumed / 4 * 3, VectorError);
+			Error |= (uint32)_mm_movemask_epi8(VectorError);
+		}
+	}
+#endif
+	Error |= DecodeScalar(Source + Consumed, MainLength - Consumed, Dest + Consumed / 4 * 3);
+
+	/** 最后一组: "xx==" 得到 1 字节, "xxx=" 得到 2 字节. */
+	const TCHAR* Last = Source + MainLength;
+	uint8* LastDest = Dest + MainLength / 4 * 3;
+	const uint32 NumLastBytes = DecodedSize - MainLength / 4 * 3;
+	const uint32 A = DecodeChar(Last[0]);
+	const uint32 B = DecodeChar(Last[1]);
+	const uint32 C = NumLastBytes > 1 ? DecodeChar(Last[2]) : 0;
+	const uint32 D = NumLastBytes > 2 ? DecodeChar(Last[3]) : 0;
+	Error |= (A | B | C | D) & InvalidValue;
+	if (Error != 0)
+	{
+		return false;
+	}
+
+	const uint32 Value = (A << 18) | (B << 12) | (C << 6) | D;
+	LastDest[0] = (uint8)(Value >> 16);
+	if (NumLastBytes > 1)
+	{
+		LastDest[1] = (uint8)(Value >> 8);
+	}
+	if (NumLastBytes > 2)
+	{
+		LastDest[2] = (uint8)Value;
+	}
+	return true;
+}
+
+bool UnrealUtils::Common::Base64::Decode(FStringView Source, TArray<uint8>& OutBytes)
+{
+	uint32 DecodedSize = 0;
+	if (!GetDecodedSize(Source.GetData(), Source.Len(), DecodedSize))
+	{
+		return false;
+	}
+	OutBytes.Reset(DecodedSize);
+	OutBytes.AddUninitialized(DecodedSize);
+	return Decode(Source.GetData(), Source.Len(), OutBytes.GetData());
+}
@@ -0,0 +1,38 @@
+// EcryptionBase64.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /**
+         * 与 FBase64 标准模式兼容的编解码, 按 CPU 支持情况使用 AVX2/SSSE3 向量化, 否则走查表的标量实现.
+         * 解码时在同一趟中校验字符, 不需要额外的校验扫描.
+         */
+        namespace Base64
+        {
+            /** 编码后的字符数(含 '=' 补齐). */
+            uint32 GetEncodedSize(uint32 NumBytes);
+
+            /** 编码到 Dest, Dest 至少要有 GetEncodedSize(Length) 个字符. 返回写入的字符数. */
+            uint32 Encode(const uint8* Source, uint32 Length, TCHAR* Dest);
+            FString Encode(const uint8* Source, uint32 Length);
+
+            /** 由长度和末尾的 '=' 算出解码后的字节数. 长度不是 4 的倍数时返回 false. */
+            bool GetDecodedSize(const TCHAR* Source, uint32 Length, uint32& OutSize);
+
+            /**
+             * 不解码, 只检查长度, '=' 补齐和字符是否合法, 通过时给出解码后的字节数. 空字符串不合法.
+             * 用于在分配内存之前尽早拒绝无效的输入.
+             */
+            bool Validate(const TCHAR* Source, uint32 Length, uint32& OutSize);
+
+            /** 解码到 Dest, Dest 至少要有 GetDecodedSize 个字节. 长度或字符非法时返回 false. */
+            bool Decode(const TCHAR* Source, uint32 Length, uint8* Dest);
+            bool Decode(FStringView Source, TArray<uint8>& OutBytes);
+        }
+    }
+}
@@ -0,0 +1,606 @@
+#include "EcryptionBatch.h"
+#include "EcryptionBase64.h"
+#include "EcryptionEnvelope.h"
+#include "EcryptionScratch.h"
+#include "EcryptionStats.h"
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	/** 每个任务至少处理的字节数, 任务太小时调度开销会超过 AES 本身. */
+	static constexpr int64 MinBytesPerTask = 64 * 1024;
+
+	/** 每个条目固定的开销(信封头, 函数调用等), 折算成字节参与分块. */
+	static constexpr int64 PerItemCost = 64;
+
+	/** 不超过该大小的密文走多缓冲内核; 更长的消息单独处理也能填满 AES-NI 的流水线. */
+	static constexpr int32 MaxMultiBufferSize = UnrealUtils::Common::FEncryptWindow::MaxMessageSize;
+
+	/**
+	 * 攒一组短消息, 凑满 MaxMultiBufferLanes 条时用多缓冲内核一起原地加解密, 再依次调用 Finish(Index, Data, Size).
+	 * 消息可以直接放在输出中, 也可以放在组内的暂存空间 GetLaneStorage() 中. 最后必须调用一次 Flush.
+	 */
+	template <bool bEncrypt>
+	class TMultiBufferGroup
+	{
+	public:
+		explicit TMultiBufferGroup(const UnrealUtils::Common::FPreparedAESKey& InKey)
+			: Key(InKey)
+			, NumLanes(0)
+		{
+		}
+
+		~TMultiBufferGroup()
+		{
+			FMemory::Memzero(Storage, sizeof(Storage));
+		}
+
+		/** 下一条消息可以使用的暂存空间, MaxMultiBufferSize 字节. */
+		uint8* GetLaneStorage() { return Storage[NumLanes]; }
+
+		template <typename FinishType>
+		void Add(int32 Index, uint8* Data, int32 Size, FinishType&& Finish)
+		{
+			Buffers[NumLanes] = Data;
+			Sizes[NumLanes] = (uint64)Size;
+			Indices[NumLanes] = Index;
+			if (++NumLanes == NumMaxLanes)
+			{
+				Flush(Finish);
+			}
+		}
+
+		template <typename FinishType>
+		void Flush(FinishType&& Finish)
+		{
+			if (NumLanes == 0)
+			{
+				return;
+			}
+			if (bEncrypt)
+			{
+				UnrealUtils::Common::AESKernel::EncryptDataMulti(Buffers, Sizes, NumLanes, Key);
+			}
+			else
+			{
+				UnrealUtils::Common::AESKernel::DecryptDataMulti(Buffers, Sizes, NumLanes, Key);
+			}
+			for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+			{
+				Finish(Indices[Lane], Buffers[Lane], (int32)Sizes[Lane]);
+			}
+			NumLanes = 0;
+		}
+
+	private:
+		static constexpr int32 NumMaxLanes = UnrealUtils::Common::AESKernel::MaxMultiBufferLanes;
+
+		const UnrealUtils::Common::FPreparedAESKey& Key;
+		alignas(16) uint8 Storage[NumMaxLanes][MaxMultiBufferSize];
+		uint8* Buffers[NumMaxLanes];
+		uint64 Sizes[NumMaxLanes];
+		int32 Indices[NumMaxLanes];
+		int32 NumLanes;
+	};
+
+	/** 按 GetCost 把 [0, Num) 切成连续区间, 再用 ParallelFor 并行执行 Body(Begin, End). */
+	template <typename CostFunctionType, typename BodyType>
+	void ParallelForRanges(int32 Num, CostFunctionType&& GetCost, BodyType&& Body)
+	{
+		TArray<int32> RangeStarts{};
+		RangeStarts.Add(0);
+		int64 RangeCost = 0;
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			RangeCost += GetCost(Index) + PerItemCost;
+			if (RangeCost >= MinBytesPerTask)
+			{
+				RangeStarts.Add(Index + 1);
+				RangeCost = 0;
+			}
+		}
+		if (RangeStarts.Last() != Num)
+		{
+			RangeStarts.Add(Num);
+		}
+
+		ParallelFor(RangeStarts.Num() - 1, [&](int32 RangeIndex)
+		{
+			Body(RangeStarts[RangeIndex], RangeStarts[RangeIndex + 1]);
+		});
+	}
+
+	/** 按每个条目输出大小的上界排好 Offsets, 并一次性分配 Data. */
+	template <typename ElementType, typename SizeFunctionType>
+	bool LayoutBatch(int32 Num, SizeFunctionType&& GetMaxSize, UnrealUtils::Common::TEcryptionBatch<ElementType>& Out)
+	{
+		Out.Offsets.Reset(Num + 1);
+		Out.Offsets.AddUninitialized(Num + 1);
+		int64 TotalSize = 0;
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			Out.Offsets[Index] = (int32)TotalSize;
+			TotalSize += GetMaxSize(Index);
+			if (!ensureMsgf(TotalSize <= MAX_int32, TEXT("Batch output is too large.")))
+			{
+				Out.Reset();
+				return false;
+			}
+		}
+		Out.Offsets[Num] = (int32)TotalSize;
+		Out.Data.Reset((int32)TotalSize);
+		Out.Data.AddUninitialized((int32)TotalSize);
+		return true;
+	}
+
+	/** 实际长度小于预留的上界(或条目失败)时, 把结果依次前移使 Data 重新连续. 全部成功时返回 true. */
+	template <typename ElementType>
+	bool FinishBatch(const TArray<int32>& Lengths, UnrealUtils::Common::TEcryptionBatch<ElementType>& Out)
+	{
+		bool bAllSucceeded = true;
+		int32 WriteOffset = 0;
+		for (int32 Index = 0; Index < Lengths.Num(); ++Index)
+		{
+			const int32 ReadOffset = Out.Offsets[Index];
+			const int32 Length = Lengths[Index];
+			if (Length > 0 && WriteOffset != ReadOffset)
+			{
+				FMemory::Memmove(Out.Data.GetData() + WriteOffset, Out.Data.GetData() + ReadOffset, Length * sizeof(ElementType));
+			}
+			Out.Offsets[Index] = WriteOffset;
+			WriteOffset += Length;
+			bAllSucceeded &= Length > 0;
+		}
+		Out.Offsets[Lengths.Num()] = WriteOffset;
+		Out.Data.SetNum(WriteOffset, false);
+		return bAllSucceeded;
+	}
+
+	/**
+	 * 解压后放不进预留空间的条目. 预留空间按密文大小计算, 只有压缩过的负载才可能超出,
+	 * 这些条目先单独解出, 最后由 FinishDecryptBatch 按顺序合并进结果.
+	 */
+	struct FBatchOverflow
+	{
+		FCriticalSection Lock;
+		TArray<TPair<int32, FString>> Items;
+	};
+
+	/**
+	 * 按信封标记把负载还原为字符写入 OutChars(最多 Capacity 个), 返回写入的字符数, 失败时返回 0.
+	 * 解压后超出 Capacity 时结果放入 Overflow, 同样返回 0.
+	 */
+	int32 PayloadToBatchChars(TArrayView<const uint8> Payload, uint8 Flags, int32 Index, TCHAR* OutChars, int32 Capacity, FBatchOverflow& Overflow)
+	{
+		UnrealUtils::Common::Scratch::FScratchBuffer Inflated;
+		if (!UnrealUtils::Common::Envelope::Inflate(Payload, Flags, Inflated))
+		{
+			return 0;
+		}
+		if (Payload.Num() > Capacity)
+		{
+			FString Result = UnrealUtils::Common::Envelope::PayloadToString(Payload, Flags);
+			if (!Result.IsEmpty())
+			{
+				FScopeLock Lock(&Overflow.Lock);
+				Overflow.Items.Emplace(Index, MoveTemp(Result));
+			}
+			return 0;
+		}
+
+		int32 NumChars = 0;
+		if (!UnrealUtils::Common::Envelope::PayloadToChars(Payload, Flags, OutChars, NumChars))
+		{
+			return 0;
+		}
+		return NumChars;
+	}
+
+	/** 原地解密 Scratch 后同 PayloadToBatchChars. */
+	int32 OpenToChars(UnrealUtils::Common::Scratch::FScratchBuffer& Scratch, const UnrealUtils::Common::FPreparedAESKey& Key, int32 Index, TCHAR* OutChars, int32 Capacity, FBatchOverflow& Overflow)
+	{
+		TArrayView<const uint8> Payload;
+		uint8 Flags = 0;
+		if (!UnrealUtils::Common::Envelope::Open(Scratch.GetData(), Scratch.Num(), Key, Payload, Flags))
+		{
+			return 0;
+		}
+		return PayloadToBatchChars(Payload, Flags, Index, OutChars, Capacity, Overflow);
+	}
+
+	/** 多缓冲内核解密后的回调: 解析信封并写入 Out 中第 Index 个条目预留的位置. */
+	struct FOpenedToBatchChars
+	{
+		UnrealUtils::Common::TEcryptionBatch<TCHAR>& Out;
+		TArray<int32>& Lengths;
+		FBatchOverflow& Overflow;
+
+		void operator()(int32 Index, const uint8* Opened, int32 SealedSize) const
+		{
+			TArrayView<const uint8> Payload;
+			uint8 Flags = 0;
+			if (!UnrealUtils::Common::Envelope::ReadEnvelope(Opened, SealedSize, Payload, Flags))
+			{
+				return;
+			}
+			const int32 Capacity = Out.Offsets[Index + 1] - Out.Offsets[Index];
+			Lengths[Index] = PayloadToBatchChars(Payload, Flags, Index, Out.Data.GetData() + Out.Offsets[Index], Capacity, Overflow);
+		}
+	};
+
+	/** 把密文写成 Encrypt(BytesToString 形式)或 EncryptBase64 的结果. */
+	void SealedToCipher(const uint8* Sealed, int32 SealedSize, bool bBase64, FString& OutCipher)
+	{
+		const int32 NumChars = bBase64 ? (int32)UnrealUtils::Common::Base64::GetEncodedSize(SealedSize) : SealedSize;
+		TArray<TCHAR>& CipherChars = OutCipher.GetCharArray();
+		CipherChars.Reset(NumChars + 1);
+		CipherChars.AddUninitialized(NumChars + 1);
+		if (bBase64)
+		{
+			UnrealUtils::Common::Base64::Encode(Sealed, SealedSize, CipherChars.GetData());
+		}
+		else
+		{
+			UnrealUtils::Common::Envelope::BytesToChars(Sealed, SealedSize, CipherChars.GetData());
+		}
+		CipherChars[NumChars] = TEXT('\0');
+	}
+
+	/** 能否走多缓冲内核解密: 非空, 是整块且不超过 MaxMultiBufferSize. 其余的交给 Open 处理(包括报告无效的大小). */
+	bool IsMultiBufferCipher(int32 SealedSize)
+	{
+		return SealedSize <= MaxMultiBufferSize && UnrealUtils::Common::Envelope::IsValidSealedSize(SealedSize);
+	}
+
+	/** 同 FinishBatch, 另外按顺序合并 Overflow 中的条目. */
+	bool FinishDecryptBatch(const TArray<int32>& Lengths, FBatchOverflow& Overflow, UnrealUtils::Common::TEcryptionBatch<TCHAR>& Out)
+	{
+		if (Overflow.Items.Num() == 0)
+		{
+			return FinishBatch(Lengths, Out);
+		}
+
+		Overflow.Items.Sort([](const TPair<int32, FString>& A, const TPair<int32, FString>& B) { return A.Key < B.Key; });
+		int64 TotalSize = 0;
+		for (int32 Index = 0; Index < Lengths.Num(); ++Index)
+		{
+			TotalSize += Lengths[Index];
+		}
+		for (const TPair<int32, FString>& Item : Overflow.Items)
+		{
+			TotalSize += Item.Value.Len();
+		}
+		if (!ensureMsgf(TotalSize <= MAX_int32, TEXT("Batch output is too large.")))
+		{
+			Out.Reset();
+			return false;
+		}
+
+		TArray<TCHAR> Data{};
+		Data.Reserve((int32)TotalSize);
+		bool bAllSucceeded = true;
+		int32 NextOverflow = 0;
+		for (int32 Index = 0; Index < Lengths.Num(); ++Index)
+		{
+			const TCHAR* Source = Out.Data.GetData() + Out.Offsets[Index];
+			int32 Length = Lengths[Index];
+			if (NextOverflow < Overflow.Items.Num() && Overflow.Items[NextOverflow].Key == Index)
+			{
+				Source = *Overflow.Items[NextOverflow].Value;
+				Length = Overflow.Items[NextOverflow].Value.Len();
+				++NextOverflow;
+			}
+			Out.Offsets[Index] = Data.Num();
+			Data.Append(Source, Length);
+			bAllSucceeded &= Length > 0;
+		}
+		Out.Offsets[Lengths.Num()] = Data.Num();
+		Out.Data = MoveTemp(Data);
+		return bAllSucceeded;
+	}
+
+	/** 并行算出每个字符串的 UTF-8 负载大小. */
+	TArray<int32> GetStringPayloadSizes(TArrayView<const FString> Inputs)
+	{
+		TArray<int32> PayloadSizes{};
+		PayloadSizes.AddUninitialized(Inputs.Num());
+		ParallelForRanges(Inputs.Num(), [&](int32 Index) { return (int64)Inputs[Index].Len(); }, [&](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				PayloadSizes[Index] = UnrealUtils::Common::Envelope::GetStringPayloadSize(FStringView(Inputs[Index]));
+			}
+		});
+		return PayloadSizes;
+	}
+}
+
+bool UnrealUtils::Common::EncryptBatch(TArrayView<const FString> Inputs, const FPreparedAESKey& Key, TEcryptionBatch<uint8>& OutCiphers)
+{
+	OutCiphers.Reset();
+	if (!ensure(Key.IsValid())) { return false; }
+
+	const int32 Num = Inputs.Num();
+	const TArray<int32> PayloadSizes = GetStringPayloadSizes(Inputs);
+	if (!LayoutBatch(Num, [&](int32 Index) { return Envelope::GetSealedSize(PayloadSizes[Index]); }, OutCiphers)) { return false; }
+
+	TArray<int32> Lengths{};
+	Lengths.AddZeroed(Num);
+	ParallelForRanges(Num, [&](int32 Index) { return (int64)Inputs[Index].Len(); }, [&](int32 Begin, int32 End)
+	{
+		/** 短消息直接在输出中写好信封, 每 8 条一起加密. */
+		TMultiBufferGroup<true> Group(Key);
+		const auto Finish = [&Lengths](int32 Index, const uint8*, int32 SealedSize) { Lengths[Index] = SealedSize; };
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			/** 空条目长度为 0, 结果为 false, 不影响其他条目. */
+			const FString& Input = Inputs[Index];
+			if (Input.IsEmpty()) { continue; }
+
+			uint8* Sealed = OutCiphers.Data.GetData() + OutCiphers.Offsets[Index];
+			const int32 SealedSize = Envelope::GetSealedSize(PayloadSizes[Index]);
+			Envelope::WriteStringPayload(FStringView(Input), Sealed + Envelope::HeaderSize);
+			if (SealedSize <= MaxMultiBufferSize)
+			{
+				Envelope::WriteEnvelope(Sealed, PayloadSizes[Index], Envelope::FlagUTF8);
+				Group.Add(Index, Sealed, SealedSize, Finish);
+				continue;
+			}
+			Envelope::Seal(Sealed, PayloadSizes[Index], Envelope::FlagUTF8, Key);
+			Lengths[Index] = SealedSize;
+		}
+		Group.Flush(Finish);
+	});
+	return FinishBatch(Lengths, OutCiphers);
+}
+
+bool UnrealUtils::Common::DecryptBatch(const TEcryptionBatch<uint8>& Ciphers, const FPreparedAESKey& Key, TEcryptionBatch<TCHAR>& OutStrings)
+{
+	OutStrings.Reset();
+	if (!ensure(Key.IsValid())) { return false; }
+
+	/** 负载不会超过密文大小, 先按密文大小预留. */
+	const int32 Num = Ciphers.Num();
+	if (!LayoutBatch(Num, [&](int32 Index) { return Ciphers[Index].Num(); }, OutStrings)) { return false; }
+
+	TArray<int32> Lengths{};
+	Lengths.AddZeroed(Num);
+	FBatchOverflow Overflow;
+	ParallelForRanges(Num, [&](int32 Index) { return (int64)Ciphers[Index].Num(); }, [&](int32 Begin, int32 End)
+	{
+		TMultiBufferGroup<false> Group(Key);
+		const FOpenedToBatchChars Finish{ OutStrings, Lengths, Overflow };
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			const TArrayView<const uint8> Cipher = Ciphers[Index];
+			if (!Envelope::IsValidSealedSize(Cipher.Num()))
+			{
+				Stats::RecordFailure(Stats::EFailure::MalformedInput);
+				continue;
+			}
+
+			if (IsMultiBufferCipher(Cipher.Num()))
+			{
+				uint8* Opened = Group.GetLaneStorage();
+				FMemory::Memcpy(Opened, Cipher.GetData(), Cipher.Num());
+				Group.Add(Index, Opened, Cipher.Num(), Finish);
+				continue;
+			}
+			Scratch::FScratchBuffer Scratch(Cipher.Num());
+			FMemory::Memcpy(Scratch.GetData(), Cipher.GetData(), Cipher.Num());
+			Lengths[Index] = OpenToChars(Scratch, Key, Index, OutStrings.Data.GetData() + OutStrings.Offsets[Index], Cipher.Num(), Overflow);
+		}
+		Group.Flush(Finish);
+	});
+	return FinishDecryptBatch(Lengths, Overflow, OutStrings);
+}
+
+bool UnrealUtils::Common::DecryptBatch(TArrayView<const FString> Inputs, const FPreparedAESKey& Key, TEcryptionBatch<TCHAR>& OutStrings)
+{
+	OutStrings.Reset();
+	if (!ensure(Key.IsValid())) { return false; }
+
+	const int32 Num = Inputs.Num();
+	if (!LayoutBatch(Num, [&](int32 Index) { return Inputs[Index].Len(); }, OutStrings)) { return false; }
+
+	TArray<int32> Lengths{};
+	Lengths.AddZeroed(Num);
+	FBatchOverflow Overflow;
+	ParallelForRanges(Num, [&](int32 Index) { return (int64)Inputs[Index].Len(); }, [&](int32 Begin, int32 End)
+	{
+		TMultiBufferGroup<false> Group(Key);
+		const FOpenedToBatchChars Finish{ OutStrings, Lengths, Overflow };
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			const FString& Input = Inputs[Index];
+			if (!Envelope::IsValidCipherString(FStringView(Input)))
+			{
+				Stats::RecordFailure(Stats::EFailure::MalformedInput);
+				continue;
+			}
+
+			if (IsMultiBufferCipher(Input.Len()))
+			{
+				uint8* Opened = Group.GetLaneStorage();
+				Envelope::CharsToBytes(FStringView(Input), Opened);
+				Group.Add(Index, Opened, Input.Len(), Finish);
+				continue;
+			}
+			Scratch::FScratchBuffer Scratch(Input.Len());
+			Envelope::CharsToBytes(FStringView(Input), Scratch.GetData());
+			Lengths[Index] = OpenToChars(Scratch, Key, Index, OutStrings.Data.GetData() + OutStrings.Offsets[Index], Input.Len(), Overflow);
+		}
+		Group.Flush(Finish);
+	});
+	return FinishDecryptBatch(Lengths, Overflow, OutStrings);
+}
+
+bool UnrealUtils::Common::EncryptBase64Batch(TArrayView<const FString> Inputs, const FPreparedAESKey& Key, TEcryptionBatch<TCHAR>& OutStrings)
+{
+	OutStrings.Reset();
+	if (!ensure(Key.IsValid())) { return false; }
+
+	const int32 Num = Inputs.Num();
+	const TArray<int32> PayloadSizes = GetStringPayloadSizes(Inputs);
+	if (!LayoutBatch(Num, [&](int32 Index) { return (int32)Base64::GetEncodedSize(Envelope::GetSealedSize(PayloadSizes[Index])); }, OutStrings)) { return false; }
+
+	TArray<int32> Lengths{};
+	Lengths.AddZeroed(Num);
+	ParallelForRanges(Num, [&](int32 Index) { return (int64)Inputs[Index].Len(); }, [&](int32 Begin, int32 End)
+	{
+		TMultiBufferGroup<true> Group(Key);
+		const auto Finish = [&](int32 Index, const uint8* Sealed, int32 SealedSize)
+		{
+			Lengths[Index] = (int32)Base64::Encode(Sealed, SealedSize, OutStrings.Data.GetData() + OutStrings.Offsets[Index]);
+		};
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			const FString& Input = Inputs[Index];
+			if (Input.IsEmpty()) { continue; }
+
+			const int32 SealedSize = Envelope::GetSealedSize(PayloadSizes[Index]);
+			if (SealedSize <= MaxMultiBufferSize)
+			{
+				uint8* Sealed = Group.GetLaneStorage();
+				Envelope::WriteStringPayload(FStringView(Input), Sealed + Envelope::HeaderSize);
+				Envelope::WriteEnvelope(Sealed, PayloadSizes[Index], Envelope::FlagUTF8);
+				Group.Add(Index, Sealed, SealedSize, Finish);
+				continue;
+			}
+			Scratch::FScratchBuffer Scratch(SealedSize);
+			Envelope::WriteStringPayload(FStringView(Input), Scratch.GetData() + Envelope::HeaderSize);
+			Envelope::Seal(Scratch.GetData(), PayloadSizes[Index], Envelope::FlagUTF8, Key);
+			Lengths[Index] = (int32)Base64::Encode(Scratch.GetData(), SealedSize, OutStrings.Data.GetData() + OutStrings.Offsets[Index]);
+		}
+		Group.Flush(Finish);
+	});
+	return FinishBatch(Lengths, OutStrings);
+}
+
+bool UnrealUtils::Common::DecryptBase64Batch(TArrayView<const FString> Inputs, const FPreparedAESKey& Key, TEcryptionBatch<TCHAR>& OutStrings)
+{
+	OutStrings.Reset();
+	if (!ensure(Key.IsValid())) { return false; }
+
+	/** 与 DecryptBase64 相同, 先不分配内存地校验每个条目, 无效的条目预留 0 个字符, 解码时直接跳过. */
+	const int32 Num = Inputs.Num();
+	TArray<int32> DecodedSizes{};
+	DecodedSizes.AddZeroed(Num);
+	ParallelForRanges(Num, [&](int32 Index) { return (int64)Inputs[Index].Len(); }, [&](int32 Begin, int32 End)
+	{
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			uint32 DecodedSize = 0;
+			if (!Base64::Validate(*Inputs[Index], Inputs[Index].Len(), DecodedSize) || !Envelope::IsValidSealedSize(DecodedSize))
+			{
+				Stats::RecordFailure(Stats::EFailure::MalformedInput);
+				continue;
+			}
+			DecodedSizes[Index] = (int32)DecodedSize;
+		}
+	});
+	if (!LayoutBatch(Num, [&](int32 Index) { return DecodedSizes[Index]; }, OutStrings)) { return false; }
+
+	TArray<int32> Lengths{};
+	Lengths.AddZeroed(Num);
+	FBatchOverflow Overflow;
+	ParallelForRanges(Num, [&](int32 Index) { return (int64)Inputs[Index].Len(); }, [&](int32 Begin, int32 End)
+	{
+		TMultiBufferGroup<false> Group(Key);
+		const FOpenedToBatchChars Finish{ OutStrings, Lengths, Overflow };
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			const FString& Input = Inputs[Index];
+			const int32 DecodedSize = DecodedSizes[Index];
+			if (DecodedSize == 0) { continue; }
+
+			/** 已经校验过, 解码不会失败. */
+			if (IsMultiBufferCipher(DecodedSize))
+			{
+				uint8* Opened = Group.GetLaneStorage();
+				Base64::Decode(*Input, Input.Len(), Opened);
+				Group.Add(Index, Opened, DecodedSize, Finish);
+				continue;
+			}
+			Scratch::FScratchBuffer Scratch(DecodedSize);
+			Base64::Decode(*Input, Input.Len(), Scratch.GetData());
+			Lengths[Index] = OpenToChars(Scratch, Key, Index, OutStrings.Data.GetData() + OutStrings.Offsets[Index], Scratch.Num(), Overflow);
+		}
+		Group.Flush(Finish);
+	});
+	return FinishDecryptBatch(Lengths, Overflow, OutStrings);
+}
+
+UnrealUtils::Common::FEncryptWindow::FEncryptWindow(const FPreparedAESKey& InKey)
+	: Key(InKey)
+	, NumPending(0)
+{
+}
+
+UnrealUtils::Common::FEncryptWindow::~FEncryptWindow()
+{
+	Flush();
+}
+
+void UnrealUtils::Common::FEncryptWindow::Encrypt(FStringView InputString, FString& OutCipher)
+{
+	Add(InputString, OutCipher, false);
+}
+
+void UnrealUtils::Common::FEncryptWindow::EncryptBase64(FStringView InputString, FString& OutCipher)
+{
+	Add(InputString, OutCipher, true);
+}
+
+void UnrealUtils::Common::FEncryptWindow::Add(FStringView InputString, FString& OutCipher, bool bBase64)
+{
+	if (!ensure(!InputString.IsEmpty()) || !ensure(Key.IsValid()))
+	{
+		OutCipher.Reset();
+		return;
+	}
+
+	const int32 PayloadSize = Envelope::GetStringPayloadSize(InputString);
+	const int32 SealedSize = Envelope::GetSealedSize(PayloadSize);
+	if (SealedSize > MaxMessageSize)
+	{
+		Scratch::FScratchBuffer Buffer(SealedSize);
+		Envelope::WriteStringPayload(InputString, Buffer.GetData() + Envelope::HeaderSize);
+		Envelope::Seal(Buffer.GetData(), PayloadSize, Envelope::FlagUTF8, Key);
+		SealedToCipher(Buffer.GetData(), SealedSize, bBase64, OutCipher);
+		return;
+	}
+
+	uint8* Sealed = Storage[NumPending];
+	Envelope::WriteStringPayload(InputString, Sealed + Envelope::HeaderSize);
+	Envelope::WriteEnvelope(Sealed, PayloadSize, Envelope::FlagUTF8);
+	Sizes[NumPending] = (uint64)SealedSize;
+	Outputs[NumPending] = &OutCipher;
+	bBase64s[NumPending] = bBase64;
+	if (++NumPending == AESKernel::MaxMultiBufferLanes)
+	{
+		Flush();
+	}
+}
+
+void UnrealUtils::Common::FEncryptWindow::Flush()
+{
+	if (NumPending == 0)
+	{
+		return;
+	}
+	uint8* Buffers[AESKernel::MaxMultiBufferLanes];
+	for (int32 Lane = 0; Lane < NumPending; ++Lane)
+	{
+		Buffers[Lane] = Storage[Lane];
+	}
+	AESKernel::EncryptDataMulti(Buffers, Sizes, NumPending, Key);
+	for (int32 Lane = 0; Lane < NumPending; ++Lane)
+	{
+		SealedToCipher(Storage[Lane], (int32)Sizes[Lane], bBase64s[Lane], *Outputs[Lane]);
+	}
+	/** 等待中的明文留在窗口里, 加密后整体清零. */
+	FMemory::Memzero(Storage, NumPending * sizeof(Storage[0]));
+	NumPending = 0;
+}
@@ -0,0 +1,76 @@
+// EcryptionBatch.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EcryptionAES.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /**
+         * 批量加解密的结果. 所有输出连续存放在 Data 中, 第 Index 个结果为 [Offsets[Index], Offsets[Index + 1]).
+         * 处理失败的条目长度为 0.
+         */
+        template <typename ElementType>
+        struct TEcryptionBatch
+        {
+            TArray<ElementType> Data;
+            TArray<int32> Offsets;
+
+            int32 Num() const { return Offsets.Num() > 0 ? Offsets.Num() - 1 : 0; }
+            void Reset() { Data.Reset(); Offsets.Reset(); }
+
+            TArrayView<const ElementType> operator[](int32 Index) const
+            {
+                return TArrayView<const ElementType>(Data.GetData() + Offsets[Index], Offsets[Index + 1] - Offsets[Index]);
+            }
+        };
+
+        /**
+         * 批量版本的 Encrypt/Decrypt/EncryptBase64/DecryptBase64, 按工作量分块后用 ParallelFor 分到所有核心.
+         * EncryptBatch 输出密文字节(与 Encrypt 的 FString 结果之间是 BytesToString 的关系), 其余输出字符.
+         * 全部成功时返回 true. 调用方可以复用 Out 来避免重新分配.
+         */
+        bool EncryptBatch(TArrayView<const FString> Inputs, const FPreparedAESKey& Key, TEcryptionBatch<uint8>& OutCiphers);
+        bool DecryptBatch(const TEcryptionBatch<uint8>& Ciphers, const FPreparedAESKey& Key, TEcryptionBatch<TCHAR>& OutStrings);
+        bool DecryptBatch(TArrayView<const FString> Inputs, const FPreparedAESKey& Key, TEcryptionBatch<TCHAR>& OutStrings);
+        bool EncryptBase64Batch(TArrayView<const FString> Inputs, const FPreparedAESKey& Key, TEcryptionBatch<TCHAR>& OutStrings);
+        bool DecryptBase64Batch(TArrayView<const FString> Inputs, const FPreparedAESKey& Key, TEcryptionBatch<TCHAR>& OutStrings);
+
+        /**
+         * 单个线程上的短消息聚合窗口: 攒够 AESKernel::MaxMultiBufferLanes 条短消息后用多缓冲内核一起加密, 不需要额外的线程.
+         * 结果与 Encrypt/EncryptBase64 相同, 但写入 OutCipher 的时机推迟到窗口满, Flush 或析构时, 在此之前 OutCipher 必须保持有效.
+         * 密文超过 MaxMessageSize 的消息立即加密. 不是线程安全的, 每个线程使用自己的窗口.
+         */
+        class FEncryptWindow
+        {
+        public:
+            /** 一次多缓冲加密能容纳的最大密文, 更长的消息不进入窗口. */
+            static constexpr int32 MaxMessageSize = 8 * FAES::AESBlockSize;
+
+            explicit FEncryptWindow(const FPreparedAESKey& InKey);
+            ~FEncryptWindow();
+
+            void Encrypt(FStringView InputString, FString& OutCipher);
+            void EncryptBase64(FStringView InputString, FString& OutCipher);
+
+            /** 加密窗口中所有等待的消息并写入各自的 OutCipher. */
+            void Flush();
+
+        private:
+            FEncryptWindow(const FEncryptWindow&) = delete;
+            FEncryptWindow& operator=(const FEncryptWindow&) = delete;
+
+            void Add(FStringView InputString, FString& OutCipher, bool bBase64);
+
+            FPreparedAESKey Key;
+            alignas(16) uint8 Storage[AESKernel::MaxMultiBufferLanes][MaxMessageSize];
+            uint64 Sizes[AESKernel::MaxMultiBufferLanes];
+            FString* Outputs[AESKernel::MaxMultiBufferLanes];
+            bool bBase64s[AESKernel::MaxMultiBufferLanes];
+            int32 NumPending;
+        };
+    }
+}
@@ -0,0 +1,285 @@
+#include "EcryptionBenchmark.h"
+#include "Ecryption.h"
+#include "EcryptionCPU.h"
+#include "EcryptionScratch.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if ECRYPTION_WITH_X86_INTRINSICS
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+	#else
+		#include <x86intrin.h>
+	#endif
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogEcryptionBenchmark, Log, All);
+
+namespace
+{
+	static constexpr int64 MinPayloadSize = 16;
+	static constexpr int64 MaxPayloadSize = 64 * 1024 * 1024;
+
+	/** 每组测量至少持续的时间, 避免小输入的计时误差. */
+	static constexpr double MinMeasureSeconds = 0.25;
+
+	/** 快速模式只测到 1 MB, 每组至少 20 ms, 整轮几秒内结束, 适合在 perf/valgrind 下反复运行. */
+	static constexpr int64 QuickMaxPayloadSize = 1024 * 1024;
+	static constexpr double QuickMinMeasureSeconds = 0.02;
+
+	/** 统计经过 GMalloc 的分配次数, 测量期间临时替换 GMalloc. 其他线程同时分配时也会被计入. */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		FCountingMalloc() : Inner(nullptr), NumAllocations(0) {}
+
+		/** 把 GMalloc 换成自身并清零计数. */
+		void Install()
+		{
+			Inner = GMalloc;
+			NumAllocations = 0;
+			GMalloc = this;
+		}
+
+		/** 恢复原来的 GMalloc, 返回期间的分配次数. 测量期间分配的内存都来自 Inner, 之后可以直接由它释放. */
+		int64 Uninstall()
+		{
+			GMalloc = Inner;
+			return NumAllocations.load(std::memory_order_relaxed);
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override { ++NumAllocations; return Inner->Malloc(Count, Alignment); }
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override { ++NumAllocations; return Inner->TryMalloc(Count, Alignment); }
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override { ++NumAllocations; return Inner->Realloc(Original, Count, Alignment); }
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override { ++NumAllocations; return Inner->TryRealloc(Original, Count, Alignment); }
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("EcryptionCountingMalloc"); }
+
+	private:
+		FMalloc* Inner;
+		std::atomic<int64> NumAllocations;
+	};
+
+	/** 当前 CPU 的时间戳计数器, 不支持时返回 0. */
+	FORCEINLINE uint64 ReadCycleCounter()
+	{
+#if ECRYPTION_WITH_X86_INTRINSICS
+		return __rdtsc();
+#else
+		return 0;
+#endif
+	}
+
+	struct FMeasurement
+	{
+		int64 NumIterations = 0;
+		double Seconds = 0.0;
+		uint64 Cycles = 0;
+		int64 NumAllocations = 0;
+		int64 NumScratchAllocations = 0;
+
+		double GetOpsPerSecond() const { return (double)NumIterations / Seconds; }
+		double GetMegabytesPerSecond(int64 PayloadSize) const { return (double)(PayloadSize * NumIterations) / Seconds / (1024.0 * 1024.0); }
+		double GetCyclesPerByte(int64 PayloadSize) const { return (double)Cycles / (double)(PayloadSize * NumIterations); }
+		double GetAllocationsPerCall() const { return (double)NumAllocations / (double)NumIterations; }
+		double GetScratchAllocationsPerCall() const { return (double)NumScratchAllocations / (double)NumIterations; }
+	};
+
+	/** 反复调用 Function 直到超过 MinSeconds. bCountAllocations 时同时统计堆分配次数和暂存池向堆申请的次数. */
+	template <typename FunctionType>
+	FMeasurement Measure(FunctionType&& Function, int64 PayloadSize, bool bCountAllocations, double MinSeconds = MinMeasureSeconds)
+	{
+		/** 预热一次, 让缓存和 CPUID 检测不计入结果. */
+		Function();
+
+		/** 其他线程可能在恢复后仍短暂持有它的指针, 所以使用静态对象. */
+		static FCountingMalloc CountingMalloc;
+		if (bCountAllocations)
+		{
+			CountingMalloc.Install();
+		}
+
+		/** 小输入成批调用后再读时钟, 避免计时本身的开销占主导. */
+		const int64 BatchSize = FMath::Max<int64>(1, 1024 * 1024 / PayloadSize);
+		FMeasurement Result;
+		const int64 StartScratchAllocations = UnrealUtils::Common::Scratch::GetNumHeapAllocations();
+		const double StartTime = FPlatformTime::Seconds();
+		const uint64 StartCycles = ReadCycleCounter();
+		do
+		{
+			for (int64 Index = 0; Index < BatchSize; ++Index)
+			{
+				Function();
+			}
+			Result.NumIterations += BatchSize;
+			Result.Seconds = FPlatformTime::Seconds() - StartTime;
+		} while (Result.Seconds < MinSeconds);
+		Result.Cycles = ReadCycleCounter() - StartCycles;
+
+		if (bCountAllocations)
+		{
+			Result.NumAllocations = CountingMalloc.Uninstall();
+			Result.NumScratchAllocations = UnrealUtils::Common::Scratch::GetNumHeapAllocations() - StartScratchAllocations;
+		}
+		return Result;
+	}
+
+	/** 反复调用 Function 直到超过 MinSeconds, 返回 MB/s. */
+	template <typename FunctionType>
+	double MeasureThroughput(FunctionType&& Function, int64 PayloadSize, double MinSeconds)
+	{
+		return Measure(Forward<FunctionType>(Function), PayloadSize, false, MinSeconds).GetMegabytesPerSecond(PayloadSize);
+	}
+
+	FAES::FAESKey MakeBenchmarkKey()
+	{
+		FAES::FAESKey Key;
+		for (int32 Index = 0; Index < FAES::FAESKey::KeySize; ++Index)
+		{
+			Key.Key[Index] = (uint8)(Index * 13 + 1);
+		}
+		return Key;
+	}
+
+	/** 一组测量结果写成 JSON 对象. */
+	void AppendResult(FString& Json, const TCHAR* FunctionName, int64 PayloadSize, const FMeasurement& Measurement)
+	{
+		Json += FString::Printf(TEXT("    {\"function\": \"%s\", \"payload_bytes\": %lld, \"iterations\": %lld, \"seconds\": %.6f, ")
+			TEXT("\"ops_per_sec\": %.2f, \"mb_per_sec\": %.2f, \"cycles_per_byte\": %.4f, \"allocations_per_call\": %.3f, \"scratch_allocations_per_call\": %.3f}"),
+			FunctionName, PayloadSize, Measurement.NumIterations, Measurement.Seconds,
+			Measurement.GetOpsPerSecond(), Measurement.GetMegabytesPerSecond(PayloadSize),
+			Measurement.GetCyclesPerByte(PayloadSize), Measurement.GetAllocationsPerCall(), Measurement.GetScratchAllocationsPerCall());
+	}
+}
+
+void UnrealUtils::Common::BenchmarkAESKernels(bool bQuick)
+{
+	const int64 LastPayloadSize = bQuick ? QuickMaxPayloadSize : MaxPayloadSize;
+	const double MinSeconds = bQuick ? QuickMinMeasureSeconds : MinMeasureSeconds;
+	const FAES::FAESKey Key = MakeBenchmarkKey();
+	const FPreparedAESKey PreparedKey(Key);
+
+	TArray<uint8> Buffer{};
+	Buffer.AddZeroed(LastPayloadSize);
+	uint8* Data = Buffer.GetData();
+
+	const bool bHasHardwareSupport = AESKernel::HasHardwareSupport();
+	UE_LOG(LogEcryptionBenchmark, Display, TEXT("AES-NI supported: %d"), bHasHardwareSupport ? 1 : 0);
+
+	for (int64 PayloadSize = MinPayloadSize; PayloadSize <= LastPayloadSize; PayloadSize *= 4)
+	{
+		const double EngineEncrypt = MeasureThroughput([&]() { FAES::EncryptData(Data, PayloadSize, Key); }, PayloadSize, MinSeconds);
+		const double EngineDecrypt = MeasureThroughput([&]() { FAES::DecryptData(Data, PayloadSize, Key); }, PayloadSize, MinSeconds);
+		if (!bHasHardwareSupport)
+		{
+			UE_LOG(LogEcryptionBenchmark, Display, TEXT("%10lld B | FAES enc %9.1f MB/s dec %9.1f MB/s"),
+				PayloadSize, EngineEncrypt, EngineDecrypt);
+			continue;
+		}
+
+		const double HardwareEncrypt = MeasureThroughput([&]() { AESKernel::EncryptDataHardware(Data, PayloadSize, Key); }, PayloadSize, MinSeconds);
+		const double HardwareDecrypt = MeasureThroughput([&]() { AESKernel::DecryptDataHardware(Data, PayloadSize, Key); }, PayloadSize, MinSeconds);
+		const double PreparedEncrypt = MeasureThroughput([&]() { AESKernel::EncryptData(Data, PayloadSize, PreparedKey); }, PayloadSize, MinSeconds);
+		const double PreparedDecrypt = MeasureThroughput([&]() { AESKernel::DecryptData(Data, PayloadSize, PreparedKey); }, PayloadSize, MinSeconds);
+		UE_LOG(LogEcryptionBenchmark, Display, TEXT("%10lld B | FAES enc %9.1f MB/s dec %9.1f MB/s | AES-NI enc %9.1f MB/s dec %9.1f MB/s | prepared enc %9.1f MB/s dec %9.1f MB/s"),
+			PayloadSize, EngineEncrypt, EngineDecrypt, HardwareEncrypt, HardwareDecrypt, PreparedEncrypt, PreparedDecrypt);
+	}
+}
+
+void UnrealUtils::Common::BenchmarkEcryption(const FString& OutputPath, bool bQuick)
+{
+	const int64 LastPayloadSize = bQuick ? QuickMaxPayloadSize : MaxPayloadSize;
+	const double MinSeconds = bQuick ? QuickMinMeasureSeconds : MinMeasureSeconds;
+	const FAES::FAESKey Key = MakeBenchmarkKey();
+	const FCPUFeatures& Features = FCPUFeatures::Get();
+
+	FString Json = FString::Printf(TEXT("{\n  \"cpu\": {\"ssse3\": %s, \"aesni\": %s, \"pclmulqdq\": %s, \"avx2\": %s},\n  \"results\": [\n"),
+		Features.bSSSE3 ? TEXT("true") : TEXT("false"), Features.bAESNI ? TEXT("true") : TEXT("false"),
+		Features.bPCLMULQDQ ? TEXT("true") : TEXT("false"), Features.bAVX2 ? TEXT("true") : TEXT("false"));
+
+	bool bFirstResult = true;
+	const auto Report = [&](const TCHAR* FunctionName, int64 PayloadSize, const FMeasurement& Measurement)
+	{
+		if (!bFirstResult)
+		{
+			Json += TEXT(",\n");
+		}
+		bFirstResult = false;
+		AppendResult(Json, FunctionName, PayloadSize, Measurement);
+		UE_LOG(LogEcryptionBenchmark, Display, TEXT("%-14s %10lld B | %12.1f ops/s %9.1f MB/s %8.2f cycles/B %6.2f allocs/call %6.2f scratch allocs/call"),
+			FunctionName, PayloadSize, Measurement.GetOpsPerSecond(), Measurement.GetMegabytesPerSecond(PayloadSize),
+			Measurement.GetCyclesPerByte(PayloadSize), Measurement.GetAllocationsPerCall(), Measurement.GetScratchAllocationsPerCall());
+	};
+
+	for (int64 PayloadSize = MinPayloadSize; PayloadSize <= LastPayloadSize; PayloadSize *= 4)
+	{
+		/** 字符都在 [1, 256] 中, 经过 StringToBytes 的映射后可以原样还原. */
+		FString Plaintext;
+		TArray<TCHAR>& PlaintextChars = Plaintext.GetCharArray();
+		PlaintextChars.AddUninitialized((int32)PayloadSize + 1);
+		for (int32 Index = 0; Index < (int32)PayloadSize; ++Index)
+		{
+			PlaintextChars[Index] = (TCHAR)(TEXT('a') + Index % 26);
+		}
+		PlaintextChars[(int32)PayloadSize] = TEXT('\0');
+
+		const FString Cipher = Encrypt(Plaintext, Key);
+		const FString CipherBase64 = EncryptBase64(Plaintext, Key);
+		if (!ensure(Decrypt(Cipher, Key) == Plaintext && DecryptBase64(CipherBase64, Key) == Plaintext))
+		{
+			return;
+		}
+
+		FString Output;
+		Report(TEXT("Encrypt"), PayloadSize, Measure([&]() { Output = Encrypt(Plaintext, Key); }, PayloadSize, true, MinSeconds));
+		Report(TEXT("Decrypt"), PayloadSize, Measure([&]() { Output = Decrypt(Cipher, Key); }, PayloadSize, true, MinSeconds));
+		Report(TEXT("EncryptBase64"), PayloadSize, Measure([&]() { Output = EncryptBase64(Plaintext, Key); }, PayloadSize, true, MinSeconds));
+		Report(TEXT("DecryptBase64"), PayloadSize, Measure([&]() { Output = DecryptBase64(CipherBase64, Key); }, PayloadSize, true, MinSeconds));
+	}
+	Json += TEXT("\n  ]\n}\n");
+
+	if (FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(LogEcryptionBenchmark, Display, TEXT("Benchmark results written to %s"), *OutputPath);
+	}
+	else
+	{
+		UE_LOG(LogEcryptionBenchmark, Error, TEXT("Unable to write benchmark results to %s"), *OutputPath);
+	}
+}
+
+static FAutoConsoleCommand BenchmarkAESCommand(
+	TEXT("Ecryption.BenchmarkAES"),
+	TEXT("Compares the AES-NI kernel against FAES on 16 B to 64 MB payloads. Pass Quick to stop at 1 MB with short measurements."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		UnrealUtils::Common::BenchmarkAESKernels(Args.Num() > 0 && Args[0].Equals(TEXT("Quick"), ESearchCase::IgnoreCase));
+	}));
+
+static FAutoConsoleCommand BenchmarkCommand(
+	TEXT("Ecryption.Benchmark"),
+	TEXT("Measures Encrypt/Decrypt/EncryptBase64/DecryptBase64 on 16 B to 64 MB payloads and writes JSON to bench_output.txt (or the given path). ")
+	TEXT("Pass Quick to stop at 1 MB with short measurements so the run finishes in seconds."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		bool bQuick = false;
+		FString OutputPath = FPaths::Combine(FPaths::ProjectDir(), TEXT("bench_output.txt"));
+		for (const FString& Arg : Args)
+		{
+			if (Arg.Equals(TEXT("Quick"), ESearchCase::IgnoreCase))
+			{
+				bQuick = true;
+			}
+			else
+			{
+				OutputPath = Arg;
+			}
+		}
+		UnrealUtils::Common::BenchmarkEcryption(OutputPath, bQuick);
+	}));
@@ -0,0 +1,26 @@
+// EcryptionBenchmark.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /**
+         * 对比 FAES, AES-NI 内核以及预展开密钥在 16 B 到 64 MB 输入上的吞吐, 结果输出到日志.
+         * bQuick 时只测到 1 MB 且缩短每组测量时间.
+         * 控制台命令: Ecryption.BenchmarkAES [Quick]
+         */
+        void BenchmarkAESKernels(bool bQuick = false);
+
+        /**
+         * 测量 Encrypt/Decrypt/EncryptBase64/DecryptBase64 在 16 B 到 64 MB 负载上的
+         * ops/s, MB/s, cycles/byte, 每次调用的堆分配次数以及暂存池(EcryptionScratch.h)向堆申请的次数, 结果输出到日志并以 JSON 写入 OutputPath.
+         * bQuick 时只测到 1 MB 且缩短每组测量时间, 几秒内结束, 便于在 perf/valgrind 下运行.
+         * 控制台命令: Ecryption.Benchmark [Quick] [OutputPath], 默认写入项目目录下的 bench_output.txt.
+         */
+        void BenchmarkEcryption(const FString& OutputPath, bool bQuick = false);
+    }
+}
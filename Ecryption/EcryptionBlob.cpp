@@ -0,0 +1,108 @@
+#include "EcryptionBlob.h"
+#include "Ecryption.h"
+#include "EcryptionBase64.h"
+#include "EcryptionEnvelope.h"
+#include "EcryptionScratch.h"
+#include "EcryptionStats.h"
+
+FString UnrealUtils::Common::FEncryptedBlob::ToLegacyString() const
+{
+	if (!ensure(Format == EEncryptedBlobFormat::Envelope)) { return{}; }
+	return BytesToString(Bytes.GetData(), Bytes.Num());
+}
+
+FString UnrealUtils::Common::FEncryptedBlob::ToBase64() const
+{
+	if (!ensure(Format == EEncryptedBlobFormat::Envelope)) { return{}; }
+	return Base64::Encode(Bytes.GetData(), Bytes.Num());
+}
+
+bool UnrealUtils::Common::FEncryptedBlob::FromLegacyString(FStringView InputString, FEncryptedBlob& OutBlob)
+{
+	OutBlob = FEncryptedBlob();
+	if (!Envelope::IsValidCipherString(InputString)) { return false; }
+
+	TArray<uint8> Cipher{};
+	Cipher.AddUninitialized(InputString.Len());
+	Envelope::CharsToBytes(InputString, Cipher.GetData());
+	OutBlob = FEncryptedBlob(MoveTemp(Cipher), EEncryptedBlobFormat::Envelope);
+	return true;
+}
+
+bool UnrealUtils::Common::FEncryptedBlob::FromBase64(FStringView InputString, FEncryptedBlob& OutBlob)
+{
+	OutBlob = FEncryptedBlob();
+	uint32 CipherSize = 0;
+	if (!Base64::Validate(InputString.GetData(), InputString.Len(), CipherSize) || !Envelope::IsValidSealedSize(CipherSize)) { return false; }
+
+	TArray<uint8> Cipher{};
+	if (!Base64::Decode(InputString, Cipher)) { return false; }
+
+	OutBlob = FEncryptedBlob(MoveTemp(Cipher), EEncryptedBlobFormat::Envelope);
+	return true;
+}
+
+UnrealUtils::Common::FEncryptedBlob UnrealUtils::Common::EncryptBlob(FStringView InputString, const FPreparedAESKey& Key)
+{
+	TArray<uint8> Cipher{};
+	if (!Encrypt(InputString, Key, Cipher)) { return{}; }
+	return FEncryptedBlob(MoveTemp(Cipher), EEncryptedBlobFormat::Envelope);
+}
+
+UnrealUtils::Common::FEncryptedBlob UnrealUtils::Common::EncryptBlob(TArrayView<const uint8> InputBytes, const FPreparedAESKey& Key, EEncryptedBlobFormat Format)
+{
+	TArray<uint8> Cipher{};
+	const bool bSucceeded = Format == EEncryptedBlobFormat::CTR ? EncryptCTR(InputBytes, Key, Cipher) : Encrypt(InputBytes, Key, Cipher);
+	if (!bSucceeded) { return{}; }
+	return FEncryptedBlob(MoveTemp(Cipher), Format);
+}
+
+bool UnrealUtils::Common::DecryptBlob(const FEncryptedBlob& Blob, const FPreparedAESKey& Key, TArray<uint8>& OutBytes)
+{
+	return Blob.GetFormat() == EEncryptedBlobFormat::CTR ? DecryptCTR(Blob.GetView(), Key, OutBytes) : Decrypt(Blob.GetView(), Key, OutBytes);
+}
+
+FString UnrealUtils::Common::DecryptBlobToString(const FEncryptedBlob& Blob, const FPreparedAESKey& Key)
+{
+	if (!ensure(Key.IsValid())) { return{}; }
+
+	/** CTR 没有信封, 负载按字节处理, 不能还原为字符串. */
+	if (!ensure(Blob.GetFormat() == EEncryptedBlobFormat::Envelope)) { return{}; }
+
+	/** 与 Decrypt 相同, 先拒绝无效的大小再分配暂存内存. */
+	if (!Envelope::IsValidSealedSize(Blob.Num()))
+	{
+		Stats::RecordFailure(Stats::EFailure::MalformedInput);
+		return{};
+	}
+
+	Scratch::FScratchBuffer Buffer(Blob.Num());
+	FMemory::Memcpy(Buffer.GetData(), Blob.GetBytes().GetData(), Blob.Num());
+	TArrayView<const uint8> Payload;
+	uint8 Flags = 0;
+	if (!Envelope::Open(Buffer.GetData(), Buffer.Num(), Key, Payload, Flags)) { return{}; }
+	Scratch::FScratchBuffer Inflated;
+	if (!Envelope::Inflate(Payload, Flags, Inflated)) { return{}; }
+
+	return Envelope::PayloadToString(Payload, Flags);
+}
+
+UnrealUtils::Common::FEncryptedBlob UnrealUtils::Common::EncryptBlob(FStringView InputString, const FAES::FAESKey& Key)
+{
+	return EncryptBlob(InputString, FPreparedAESKey(Key));
+}
+
+UnrealUtils::Common::FEncryptedBlob UnrealUtils::Common::EncryptBlob(TArrayView<const uint8> InputBytes, const FAES::FAESKey& Key, EEncryptedBlobFormat Format)
+{
+	return EncryptBlob(InputBytes, FPreparedAESKey(Key), Format);
+}
+
+bool UnrealUtils::Common::DecryptBlob(const FEncryptedBlob& Blob, const FAES::FAESKey& Key, TArray<uint8>& OutBytes)
+{
+	return DecryptBlob(Blob, FPreparedAESKey(Key), OutBytes);
+}
+
+FString UnrealUtils::Common::DecryptBlobToString(const FEncryptedBlob& Blob, const FAES::FAESKey& Key)
+{
+	return DecryptBlobToString(Blob, FPreparedAESKey(Key));
+}
@@ -0,0 +1,64 @@
+// EcryptionBlob.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /** FEncryptedBlob 中密文的格式. */
+        enum class EEncryptedBlobFormat : uint8
+        {
+            /** 信封格式, 与 Encrypt/EncryptBase64 的结果相同. */
+            Envelope,
+            /** EncryptCTR 的结果. */
+            CTR,
+        };
+
+        /**
+         * 以原始字节保存的密文. Encrypt 的 FString 结果每个字节占一个 TCHAR(2 或 4 字节),
+         * 需要长期保存或排队发送的密文应当使用这个类型, 只在确实需要时再转换成旧的字符串形式.
+         * 可以移动, 移动后原对象为空.
+         */
+        class FEncryptedBlob
+        {
+        public:
+            FEncryptedBlob() = default;
+            FEncryptedBlob(TArray<uint8>&& InBytes, EEncryptedBlobFormat InFormat)
+                : Bytes(MoveTemp(InBytes))
+                , Format(InFormat)
+            {
+            }
+
+            bool IsEmpty() const { return Bytes.Num() == 0; }
+            int32 Num() const { return Bytes.Num(); }
+            EEncryptedBlobFormat GetFormat() const { return Format; }
+            const TArray<uint8>& GetBytes() const { return Bytes; }
+            TArrayView<const uint8> GetView() const { return TArrayView<const uint8>(Bytes.GetData(), Bytes.Num()); }
+
+            /** 取走内部的字节数组, 之后对象为空. */
+            TArray<uint8> Release()
+            {
+                TArray<uint8> Result = MoveTemp(Bytes);
+                Bytes.Reset();
+                return Result;
+            }
+
+            /** 转换成 Encrypt 返回的字符串形式(BytesToString), 仅用于信封格式. */
+            FString ToLegacyString() const;
+
+            /** 转换成 EncryptBase64 返回的字符串形式, 仅用于信封格式. */
+            FString ToBase64() const;
+
+            /** 由 Encrypt/EncryptBase64 的字符串结果得到信封格式的密文. 字符串无效时返回 false. */
+            static bool FromLegacyString(FStringView InputString, FEncryptedBlob& OutBlob);
+            static bool FromBase64(FStringView InputString, FEncryptedBlob& OutBlob);
+
+        private:
+            TArray<uint8> Bytes;
+            EEncryptedBlobFormat Format = EEncryptedBlobFormat::Envelope;
+        };
+    }
+}
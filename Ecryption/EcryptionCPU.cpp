@@ -0,0 +1,80 @@
+#include "EcryptionCPU.h"
+
+#if ECRYPTION_WITH_X86_INTRINSICS
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+namespace
+{
+#if ECRYPTION_WITH_X86_INTRINSICS
+	void QueryCPUID(uint32 Leaf, uint32 SubLeaf, uint32 OutRegisters[4])
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		int32 Registers[4];
+		__cpuidex(Registers, (int32)Leaf, (int32)SubLeaf);
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			OutRegisters[Index] = (uint32)Registers[Index];
+		}
+#else
+		__cpuid_count(Leaf, SubLeaf, OutRegisters[0], OutRegisters[1], OutRegisters[2], OutRegisters[3]);
+#endif
+	}
+
+	/** 操作系统是否会保存 YMM 寄存器, 否则即使 CPU 支持 AVX2 也不能使用. */
+	bool IsYMMStateEnabled()
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		return (_xgetbv(0) & 0x6) == 0x6;
+#else
+		uint32 Eax = 0, Edx = 0;
+		__asm__ volatile("xgetbv" : "=a"(Eax), "=d"(Edx) : "c"(0));
+		return (Eax & 0x6) == 0x6;
+#endif
+	}
+
+	UnrealUtils::Common::FCPUFeatures DetectFeatures()
+	{
+		UnrealUtils::Common::FCPUFeatures Features;
+		uint32 Registers[4] = {};
+		QueryCPUID(0, 0, Registers);
+		const uint32 MaxLeaf = Registers[0];
+		if (MaxLeaf < 1)
+		{
+			return Features;
+		}
+
+		/** CPUID.1:ECX. */
+		QueryCPUID(1, 0, Registers);
+		const uint32 Ecx = Registers[2];
+		Features.bSSSE3 = (Ecx & (1u << 9)) != 0;
+		Features.bPCLMULQDQ = (Ecx & (1u << 1)) != 0;
+		Features.bAESNI = (Ecx & (1u << 25)) != 0;
+		const bool bOSXSAVE = (Ecx & (1u << 27)) != 0;
+		const bool bAVX = (Ecx & (1u << 28)) != 0;
+
+		/** CPUID.7.0:EBX.AVX2[bit 5]. */
+		if (MaxLeaf >= 7 && bOSXSAVE && bAVX && IsYMMStateEnabled())
+		{
+			QueryCPUID(7, 0, Registers);
+			Features.bAVX2 = (Registers[1] & (1u << 5)) != 0;
+		}
+		return Features;
+	}
+#else
+	UnrealUtils::Common::FCPUFeatures DetectFeatures()
+	{
+		return UnrealUtils::Common::FCPUFeatures();
+	}
+#endif
+}
+
+const UnrealUtils::Common::FCPUFeatures& UnrealUtils::Common::FCPUFeatures::Get()
+{
+	static const FCPUFeatures Features = DetectFeatures();
+	return Features;
+}
@@ -0,0 +1,36 @@
+// EcryptionCPU.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** x86 上可以使用 SSE/AVX/AES-NI 等指令的内联函数, 具体能否执行由 FCPUFeatures 在运行时决定. */
+#if PLATFORM_CPU_X86_FAMILY
+    #define ECRYPTION_WITH_X86_INTRINSICS 1
+#else
+    #define ECRYPTION_WITH_X86_INTRINSICS 0
+#endif
+
+/** GCC/Clang 需要为使用扩展指令的函数单独声明目标特性, MSVC 不需要. */
+#if ECRYPTION_WITH_X86_INTRINSICS && !(defined(_MSC_VER) && !defined(__clang__))
+    #define ECRYPTION_TARGET(Features) __attribute__((target(Features)))
+#else
+    #define ECRYPTION_TARGET(Features)
+#endif
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /** 运行时检测到的 CPU 指令集, 首次调用 Get() 时通过 CPUID 检测. */
+        struct FCPUFeatures
+        {
+            bool bSSSE3 = false;
+            bool bAESNI = false;
+            bool bPCLMULQDQ = false;
+            bool bAVX2 = false;
+
+            static const FCPUFeatures& Get();
+        };
+    }
+}
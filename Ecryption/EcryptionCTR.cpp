@@ -0,0 +1,85 @@
+#include "Ecryption.h"
+#include "EcryptionRandom.h"
+#include "EcryptionStats.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	/** 初始计数器块的大小. */
+	static constexpr int32 CounterSize = FAES::AESBlockSize;
+
+	/** 多线程时每个任务处理的字节数, 必须是 16 的倍数. */
+	static constexpr int64 BytesPerTask = 256 * 1024;
+
+	/** 把 Input 按计数器段分给各个线程, 结果写入 Output. */
+	void TransformCTRParallel(const uint8* Input, uint8* Output, int32 NumBytes, const uint8* InitialCounter, const UnrealUtils::Common::FPreparedAESKey& Key)
+	{
+		if (NumBytes < UnrealUtils::Common::CTRParallelThreshold)
+		{
+			UnrealUtils::Common::AESKernel::TransformCTR(Input, Output, NumBytes, InitialCounter, 0, Key);
+			return;
+		}
+
+		const int32 NumTasks = (int32)((NumBytes + BytesPerTask - 1) / BytesPerTask);
+		ParallelFor(NumTasks, [&](int32 TaskIndex)
+		{
+			const int64 Begin = TaskIndex * BytesPerTask;
+			const int64 End = FMath::Min<int64>(Begin + BytesPerTask, NumBytes);
+			UnrealUtils::Common::AESKernel::TransformCTR(Input + Begin, Output + Begin, End - Begin, InitialCounter, Begin / FAES::AESBlockSize, Key);
+		});
+	}
+}
+
+bool UnrealUtils::Common::EncryptCTR(TArrayView<const uint8> InputBytes, const FPreparedAESKey& Key, TArray<uint8>& OutCipher)
+{
+	Stats::FScopedCall Call(Stats::EFunction::EncryptCTR, InputBytes.Num());
+	if (!ensure(!InputBytes.IsEmpty())) { return false; }
+	if (!ensure(Key.IsValid())) { return false; }
+	if (!ensureMsgf(InputBytes.Num() <= MAX_int32 - CounterSize, TEXT("Message is too large."))) { return false; }
+
+	OutCipher.Reset(CounterSize + InputBytes.Num());
+	OutCipher.AddUninitialized(CounterSize + InputBytes.Num());
+
+	/**
+	 * 每条消息使用 128 位密码学随机的初始计数器块, 同一个密钥下两条消息的计数器范围重叠的概率可以忽略.
+	 * 拿不到随机数时不加密, 以免用可预测的计数器泄露明文.
+	 */
+	if (!ensureMsgf(SecureRandom::GenerateBytes(OutCipher.GetData(), CounterSize), TEXT("Unable to encrypt message because no secure random counter is available.")))
+	{
+		OutCipher.Reset();
+		return false;
+	}
+
+	TransformCTRParallel(InputBytes.GetData(), OutCipher.GetData() + CounterSize, InputBytes.Num(), OutCipher.GetData(), Key);
+	Call.Succeed(OutCipher.Num());
+	return true;
+}
+
+bool UnrealUtils::Common::DecryptCTR(TArrayView<const uint8> InputCipher, const FPreparedAESKey& Key, TArray<uint8>& OutBytes)
+{
+	Stats::FScopedCall Call(Stats::EFunction::DecryptCTR, InputCipher.Num());
+	if (!ensure(Key.IsValid())) { return false; }
+	if (InputCipher.Num() <= CounterSize)
+	{
+		/** 由于大小无效, 消息无法解密. */
+		Stats::RecordFailure(Stats::EFailure::MalformedInput);
+		return false;
+	}
+
+	const int32 NumBytes = InputCipher.Num() - CounterSize;
+	OutBytes.Reset(NumBytes);
+	OutBytes.AddUninitialized(NumBytes);
+	TransformCTRParallel(InputCipher.GetData() + CounterSize, OutBytes.GetData(), NumBytes, InputCipher.GetData(), Key);
+	Call.Succeed(NumBytes);
+	return true;
+}
+
+bool UnrealUtils::Common::EncryptCTR(TArrayView<const uint8> InputBytes, const FAES::FAESKey& Key, TArray<uint8>& OutCipher)
+{
+	return EncryptCTR(InputBytes, FPreparedAESKey(Key), OutCipher);
+}
+
+bool UnrealUtils::Common::DecryptCTR(TArrayView<const uint8> InputCipher, const FAES::FAESKey& Key, TArray<uint8>& OutBytes)
+{
+	return DecryptCTR(InputCipher, FPreparedAESKey(Key), OutBytes);
+}
@@ -0,0 +1,231 @@
+#include "EcryptionCache.h"
+#include "Hash/CityHash.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	/** 分片数, 必须是 2 的幂. 每个分片有自己的锁, 内存上限平均分到各个分片. */
+	static constexpr int32 NumShards = 16;
+	static constexpr int32 ShardShift = 64 - 4;
+	static_assert((1 << (64 - ShardShift)) == NumShards, "ShardShift must match NumShards.");
+
+	/** 每个条目在 TMap 中的大致额外开销. */
+	static constexpr int64 LookupOverhead = 32;
+
+	int32 DecryptCacheMaxBytes = 0;
+
+	void OnMaxBytesChanged(IConsoleVariable*);
+
+	FAutoConsoleVariableRef CVarDecryptCacheMaxBytes(
+		TEXT("Ecryption.DecryptCache.MaxBytes"),
+		DecryptCacheMaxBytes,
+		TEXT("Memory limit of the Decrypt/DecryptBase64 result cache. 0 disables the cache and wipes its contents."),
+		FConsoleVariableDelegate::CreateStatic(&OnMaxBytesChanged));
+
+	/** 先清零再释放, 不在堆上留下明文. */
+	void WipeString(FString& String)
+	{
+		TArray<TCHAR>& Chars = String.GetCharArray();
+		FMemory::Memzero(Chars.GetData(), Chars.Num() * sizeof(TCHAR));
+		Chars.Empty();
+	}
+
+	struct FEntry
+	{
+		uint64 Hash = 0;
+		FEntry* Prev = nullptr;
+		FEntry* Next = nullptr;
+		FString Cipher;
+		FString Plaintext;
+		uint8 Fingerprint[FAES::AESBlockSize];
+		UnrealUtils::Common::DecryptCache::EFormat Format;
+		int64 Size = 0;
+
+		~FEntry()
+		{
+			WipeString(Plaintext);
+		}
+	};
+
+	/** 一个分片: 按哈希查找, 同时串成双向链表, 表头是最近使用的条目. */
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FShard
+	{
+		FCriticalSection Lock;
+		TMap<uint64, FEntry*> Lookup;
+		FEntry* Head = nullptr;
+		FEntry* Tail = nullptr;
+		int64 NumBytes = 0;
+		int64 NumHits = 0;
+		int64 NumMisses = 0;
+		int64 NumEvictions = 0;
+
+		~FShard()
+		{
+			Empty();
+		}
+
+		void Unlink(FEntry* Entry)
+		{
+			(Entry->Prev != nullptr ? Entry->Prev->Next : Head) = Entry->Next;
+			(Entry->Next != nullptr ? Entry->Next->Prev : Tail) = Entry->Prev;
+			Entry->Prev = nullptr;
+			Entry->Next = nullptr;
+		}
+
+		void PushFront(FEntry* Entry)
+		{
+			Entry->Next = Head;
+			(Head != nullptr ? Head->Prev : Tail) = Entry;
+			Head = Entry;
+		}
+
+		void Remove(FEntry* Entry)
+		{
+			Unlink(Entry);
+			Lookup.Remove(Entry->Hash);
+			NumBytes -= Entry->Size;
+			delete Entry;
+		}
+
+		/** 淘汰最久未用的条目, 直到不超过 MaxBytes. */
+		void Trim(int64 MaxBytes)
+		{
+			while (NumBytes > MaxBytes && Tail != nullptr)
+			{
+				Remove(Tail);
+				++NumEvictions;
+			}
+		}
+
+		void Empty()
+		{
+			while (Tail != nullptr)
+			{
+				Remove(Tail);
+			}
+		}
+	};
+
+	FShard Shards[NumShards];
+
+	int64 GetShardMaxBytes()
+	{
+		return (int64)DecryptCacheMaxBytes / NumShards;
+	}
+
+	void OnMaxBytesChanged(IConsoleVariable*)
+	{
+		const int64 ShardMaxBytes = FMath::Max<int64>(GetShardMaxBytes(), 0);
+		for (FShard& Shard : Shards)
+		{
+			FScopeLock ScopeLock(&Shard.Lock);
+			Shard.Trim(ShardMaxBytes);
+		}
+	}
+}
+
+UnrealUtils::Common::DecryptCache::FLookup::FLookup(EFormat InFormat, const FString& InCipher, const FPreparedAESKey& Key)
+	: Cipher(InCipher)
+	, Hash(0)
+	, Format(InFormat)
+	, bEnabled(DecryptCacheMaxBytes > 0 && !InCipher.IsEmpty())
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+	/** 密钥指纹: 用密钥加密一个全零块(即常见的 KCV), 不暴露密钥本身. */
+	FMemory::Memzero(Fingerprint, sizeof(Fingerprint));
+	AESKernel::EncryptData(Fingerprint, sizeof(Fingerprint), Key);
+
+	uint64 Seed = 0;
+	FMemory::Memcpy(&Seed, Fingerprint, sizeof(Seed));
+	Hash = CityHash64WithSeed((const char*)*Cipher, Cipher.Len() * sizeof(TCHAR), Seed ^ (uint64)Format);
+}
+
+bool UnrealUtils::Common::DecryptCache::FLookup::Find(FString& OutPlaintext) const
+{
+	if (!bEnabled)
+	{
+		return false;
+	}
+	FShard& Shard = Shards[Hash >> ShardShift];
+	FScopeLock ScopeLock(&Shard.Lock);
+	FEntry* const* Found = Shard.Lookup.Find(Hash);
+	FEntry* Entry = Found != nullptr ? *Found : nullptr;
+	if (Entry == nullptr || Entry->Format != Format || FMemory::Memcmp(Entry->Fingerprint, Fingerprint, sizeof(Fingerprint)) != 0
+		|| Entry->Cipher.Len() != Cipher.Len() || FMemory::Memcmp(*Entry->Cipher, *Cipher, Cipher.Len() * sizeof(TCHAR)) != 0)
+	{
+		++Shard.NumMisses;
+		return false;
+	}
+	++Shard.NumHits;
+	Shard.Unlink(Entry);
+	Shard.PushFront(Entry);
+	OutPlaintext = Entry->Plaintext;
+	return true;
+}
+
+void UnrealUtils::Common::DecryptCache::FLookup::Add(const FString& Plaintext) const
+{
+	if (!bEnabled || Plaintext.IsEmpty())
+	{
+		return;
+	}
+	const int64 Size = (int64)sizeof(FEntry) + LookupOverhead + (int64)(Cipher.Len() + Plaintext.Len()) * (int64)sizeof(TCHAR);
+	const int64 ShardMaxBytes = GetShardMaxBytes();
+	if (Size > ShardMaxBytes)
+	{
+		return;
+	}
+
+	FEntry* Entry = new FEntry();
+	Entry->Hash = Hash;
+	Entry->Cipher = Cipher;
+	Entry->Plaintext = Plaintext;
+	FMemory::Memcpy(Entry->Fingerprint, Fingerprint, sizeof(Fingerprint));
+	Entry->Format = Format;
+	Entry->Size = Size;
+
+	FShard& Shard = Shards[Hash >> ShardShift];
+	FScopeLock ScopeLock(&Shard.Lock);
+	/** 同一个哈希(重复添加或哈希碰撞)只保留最新的条目. */
+	if (FEntry** Existing = Shard.Lookup.Find(Hash))
+	{
+		Shard.Remove(*Existing);
+	}
+	Shard.Lookup.Add(Hash, Entry);
+	Shard.PushFront(Entry);
+	Shard.NumBytes += Size;
+	Shard.Trim(ShardMaxBytes);
+}
+
+UnrealUtils::Common::FDecryptCacheStats UnrealUtils::Common::GetDecryptCacheStats()
+{
+	FDecryptCacheStats Stats;
+	for (FShard& Shard : Shards)
+	{
+		FScopeLock ScopeLock(&Shard.Lock);
+		Stats.NumHits += Shard.NumHits;
+		Stats.NumMisses += Shard.NumMisses;
+		Stats.NumEvictions += Shard.NumEvictions;
+		Stats.NumEntries += Shard.Lookup.Num();
+		Stats.NumBytes += Shard.NumBytes;
+	}
+	return Stats;
+}
+
+void UnrealUtils::Common::EmptyDecryptCache()
+{
+	for (FShard& Shard : Shards)
+	{
+		FScopeLock ScopeLock(&Shard.Lock);
+		Shard.Empty();
+	}
+}
+
+static FAutoConsoleCommand DecryptCacheEmptyCommand(
+	TEXT("Ecryption.DecryptCache.Empty"),
+	TEXT("Wipes and removes every entry of the Decrypt/DecryptBase64 result cache."),
+	FConsoleCommandDelegate::CreateStatic(&UnrealUtils::Common::EmptyDecryptCache));
@@ -0,0 +1,62 @@
+// EcryptionCache.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EcryptionAES.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /**
+         * Decrypt/DecryptBase64 的结果缓存, 适合每帧或每个请求都解密同一批配置值的场合.
+         * 默认关闭, 由 Ecryption.DecryptCache.MaxBytes 设置内存上限后启用, 设为 0 时清空并关闭.
+         * 按密文的哈希和密钥指纹分片查找, 命中时再逐字比较密文, 哈希碰撞不会返回别的明文.
+         * 被淘汰或清空的明文先清零再释放.
+         * 控制台命令: Ecryption.DecryptCache.Empty
+         */
+        struct FDecryptCacheStats
+        {
+            int64 NumHits = 0;
+            int64 NumMisses = 0;
+            int64 NumEvictions = 0;
+            int64 NumEntries = 0;
+            /** 缓存占用的内存(密文和明文的字符以及条目本身). */
+            int64 NumBytes = 0;
+        };
+
+        FDecryptCacheStats GetDecryptCacheStats();
+
+        /** 清空缓存(明文清零). 不影响统计. */
+        void EmptyDecryptCache();
+
+        /** 供 Decrypt/DecryptBase64 使用的内部接口. */
+        namespace DecryptCache
+        {
+            /** 同一个字符串作为两种格式解密的结果不同, 分开缓存. */
+            enum class EFormat : uint8
+            {
+                String,
+                Base64,
+            };
+
+            /** 一次解密的查找键: 构造时计算哈希, 之后先 Find, 未命中时解密成功后再 Add. 缓存关闭时两者都什么都不做. */
+            class FLookup
+            {
+            public:
+                FLookup(EFormat InFormat, const FString& InCipher, const FPreparedAESKey& Key);
+
+                bool Find(FString& OutPlaintext) const;
+                void Add(const FString& Plaintext) const;
+
+            private:
+                const FString& Cipher;
+                uint64 Hash;
+                uint8 Fingerprint[FAES::AESBlockSize];
+                EFormat Format;
+                bool bEnabled;
+            };
+        }
+    }
+}
@@ -0,0 +1,428 @@
+#include "EcryptionEnvelope.h"
+#include "EcryptionCPU.h"
+#include "EcryptionStats.h"
+#include "EcryptionUTF8.h"
+#include "Misc/Compression.h"
+#if ECRYPTION_WITH_X86_INTRINSICS
+	#include <immintrin.h>
+#endif
+
+#define SPLIT_SYMBOL "52168@E4B9!13Fe-33!B0D9CF6!$@!~"
+namespace
+{
+	/** 垃圾符号按 StringToBytes 的规则映射后的字节. */
+	struct FSplitSymbolBytes
+	{
+		static constexpr int32 Num = UE_ARRAY_COUNT(SPLIT_SYMBOL) - 1;
+		uint8 Bytes[Num];
+
+		FSplitSymbolBytes()
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				Bytes[Index] = (uint8)(SPLIT_SYMBOL[Index] - 1);
+			}
+		}
+	};
+	const FSplitSymbolBytes SplitSymbol;
+
+	/** 从 Start 开始逐字节查找垃圾符号, 返回第一次出现的位置, 没有时返回 INDEX_NONE. 也用于处理 SIMD 版本剩下的尾部. */
+	int32 FindSplitSymbolScalar(const uint8* Data, int32 Num, int32 Start)
+	{
+		for (int32 Index = Start; Index + FSplitSymbolBytes::Num <= Num; ++Index)
+		{
+			if (Data[Index] == SplitSymbol.Bytes[0] && FMemory::Memcmp(Data + Index, SplitSymbol.Bytes, FSplitSymbolBytes::Num) == 0)
+			{
+				return Index;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+#if ECRYPTION_WITH_X86_INTRINSICS
+	/**
+	 * 每次检查 16 个起始位置: 同时比较符号的首字节和末字节, 两者都相符的位置才比较中间的字节.
+	 * 负载中首尾两个字节恰好同时相符的位置很少, 绝大部分数据只经过两次比较和一次 movemask.
+	 */
+	ECRYPTION_TARGET("sse2") int32 FindSplitSymbolSSE2(const uint8* Data, int32 Num, int32 Start)
+	{
+		static constexpr int32 NumLanes = 16;
+		const __m128i First = _mm_set1_epi8((char)SplitSymbol.Bytes[0]);
+		const __m128i Last = _mm_set1_epi8((char)SplitSymbol.Bytes[FSplitSymbolBytes::Num - 1]);
+		int32 Index = Start;
+		for (; Index + FSplitSymbolBytes::Num - 1 + NumLanes <= Num; Index += NumLanes)
+		{
+			const __m128i FirstBytes = _mm_loadu_si128((const __m128i*)(Data + Index));
+			const __m128i LastBytes = _mm_loadu_si128((const __m128i*)(Data + Index + FSplitSymbolBytes::Num - 1));
+			uint32 Candidates = (uint32)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(FirstBytes, First), _mm_cmpeq_epi8(LastBytes, Last)));
+			while (Candidates != 0)
+			{
+				const int32 Position = Index + (int32)FMath::CountTrailingZeros(Candidates);
+				if (FMemory::Memcmp(Data + Position + 1, SplitSymbol.Bytes + 1, FSplitSymbolBytes::Num - 2) == 0)
+				{
+					return Position;
+				}
+				Candidates &= Candidates - 1;
+			}
+		}
+		return FindSplitSymbolScalar(Data, Num, Index);
+	}
+
+	/** 同上, 每次 32 个起始位置, 剩下的交给 SSE2 版本. */
+	ECRYPTION_TARGET("avx2") int32 FindSplitSymbolAVX2(const uint8* Data, int32 Num)
+	{
+		static constexpr int32 NumLanes = 32;
+		const __m256i First = _mm256_set1_epi8((char)SplitSymbol.Bytes[0]);
+		const __m256i Last = _mm256_set1_epi8((char)SplitSymbol.Bytes[FSplitSymbolBytes::Num - 1]);
+		int32 Index = 0;
+		for (; Index + FSplitSymbolBytes::Num - 1 + NumLanes <= Num; Index += NumLanes)
+		{
+			const __m256i FirstBytes = _mm256_loadu_si256((const __m256i*)(Data + Index));
+			const __m256i LastBytes = _mm256_loadu_si256((const __m256i*)(Data + Index + FSplitSymbolBytes::Num - 1));
+			uint32 Candidates = (uint32)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(FirstBytes, First), _mm256_cmpeq_epi8(LastBytes, Last)));
+			while (Candidates != 0)
+			{
+				const int32 Position = Index + (int32)FMath::CountTrailingZeros(Candidates);
+				if (FMemory::Memcmp(Data + Position + 1, SplitSymbol.Bytes + 1, FSplitSymbolBytes::Num - 2) == 0)
+				{
+					return Position;
+				}
+				Candidates &= Candidates - 1;
+			}
+		}
+		return FindSplitSymbolSSE2(Data, Num, Index);
+	}
+#endif
+
+	/** 在解密后的字节中查找垃圾符号. */
+	int32 FindSplitSymbol(const uint8* Data, int32 Num)
+	{
+#if ECRYPTION_WITH_X86_INTRINSICS
+		if (UnrealUtils::Common::FCPUFeatures::Get().bAVX2)
+		{
+			return FindSplitSymbolAVX2(Data, Num);
+		}
+		return FindSplitSymbolSSE2(Data, Num, 0);
+#else
+		return FindSplitSymbolScalar(Data, Num, 0);
+#endif
+	}
+
+	static constexpr uint8 Magic[] = { 0x00, 0xEC, 0x52, 0x7A };
+	static constexpr uint8 Version = 1;
+
+	/** 压缩负载中记录的算法, 写入密文, 不能改动已有的值. */
+	static constexpr uint8 CodecLZ4 = 1;
+	static constexpr uint8 CodecZlib = 2;
+
+	/** 小于该大小的负载压缩后几乎不会少一个 AES 块, 直接跳过. */
+	static constexpr int32 MinCompressSize = 128;
+
+	/** 超过 SampleThreshold 的负载先压缩开头的 SampleSize 字节, 压不到 SampleMaxRatio 以下就不再压缩整体. */
+	static constexpr int32 SampleThreshold = 64 * 1024;
+	static constexpr int32 SampleSize = 4 * 1024;
+	static constexpr float SampleMaxRatio = 0.9f;
+
+	/** 解压后大小的上限, 防止损坏的密文要求分配过大的内存. */
+	static constexpr int32 MaxInflatedSize = 1 << 30;
+
+	FName GetFormatName(UnrealUtils::Common::EEcryptionCompression Compression)
+	{
+		return Compression == UnrealUtils::Common::EEcryptionCompression::Zlib ? NAME_Zlib : NAME_LZ4;
+	}
+
+	uint8 GetCodec(UnrealUtils::Common::EEcryptionCompression Compression)
+	{
+		return Compression == UnrealUtils::Common::EEcryptionCompression::Zlib ? CodecZlib : CodecLZ4;
+	}
+
+	/** 压缩开头的一段, 判断整体是否值得压缩. */
+	bool IsWorthCompressing(FName FormatName, TArrayView<const uint8> Payload)
+	{
+		if (Payload.Num() <= SampleThreshold)
+		{
+			return true;
+		}
+		UnrealUtils::Common::Scratch::FScratchBuffer Sample(FCompression::CompressMemoryBound(FormatName, SampleSize));
+		int32 CompressedSize = Sample.Num();
+		if (!FCompression::CompressMemory(FormatName, Sample.GetData(), CompressedSize, Payload.GetData(), SampleSize))
+		{
+			return false;
+		}
+		return CompressedSize < SampleSize * SampleMaxRatio;
+	}
+}
+
+int32 UnrealUtils::Common::Envelope::GetSealedSize(int32 PayloadSize)
+{
+	return Align(HeaderSize + PayloadSize, FAES::AESBlockSize);
+}
+
+void UnrealUtils::Common::Envelope::WriteHeader(uint8* Header, uint8 Flags, int32 PayloadSize)
+{
+	FMemory::Memcpy(Header, Magic, sizeof(Magic));
+	Header[4] = Version;
+	Header[5] = Flags;
+	Header[6] = 0;
+	Header[7] = 0;
+	Header[8] = (uint8)(PayloadSize);
+	Header[9] = (uint8)(PayloadSize >> 8);
+	Header[10] = (uint8)(PayloadSize >> 16);
+	Header[11] = (uint8)(PayloadSize >> 24);
+}
+
+bool UnrealUtils::Common::Envelope::ReadHeader(const uint8* Header, int32 SealedSize, uint8& OutFlags, int32& OutPayloadSize)
+{
+	if (SealedSize < HeaderSize)
+	{
+		return false;
+	}
+	uint8 Flags = 0;
+	int32 PayloadSize = 0;
+	if (!ReadHeader(Header, Flags, PayloadSize) || GetSealedSize(PayloadSize) != SealedSize)
+	{
+		return false;
+	}
+	OutFlags = Flags;
+	OutPayloadSize = PayloadSize;
+	return true;
+}
+
+bool UnrealUtils::Common::Envelope::ReadHeader(const uint8* Header, uint8& OutFlags, int32& OutPayloadSize)
+{
+	if (FMemory::Memcmp(Header, Magic, sizeof(Magic)) != 0 || Header[4] != Version)
+	{
+		return false;
+	}
+	const uint32 PayloadSize = (uint32)Header[8] | ((uint32)Header[9] << 8) | ((uint32)Header[10] << 16) | ((uint32)Header[11] << 24);
+	/** 保证 GetSealedSize 不会溢出. */
+	if (PayloadSize > (uint32)(MAX_int32 - HeaderSize - FAES::AESBlockSize))
+	{
+		return false;
+	}
+	OutFlags = Header[5];
+	OutPayloadSize = (int32)PayloadSize;
+	return true;
+}
+
+void UnrealUtils::Common::Envelope::CharsToBytes(FStringView InputString, uint8* OutBytes)
+{
+	const TCHAR* Chars = InputString.GetData();
+	const int32 Num = InputString.Len();
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		OutBytes[Index] = (uint8)(Chars[Index] - 1);
+	}
+}
+
+bool UnrealUtils::Common::Envelope::IsValidSealedSize(int64 SealedSize)
+{
+	return SealedSize > 0 && SealedSize % FAES::AESBlockSize == 0;
+}
+
+bool UnrealUtils::Common::Envelope::IsValidCipherString(FStringView InputString)
+{
+	const int32 Num = InputString.Len();
+	if (!IsValidSealedSize(Num))
+	{
+		return false;
+	}
+	/** 没有分支的循环, 编译器可以直接向量化. */
+	const TCHAR* Chars = InputString.GetData();
+	uint32 OutOfRange = 0;
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		OutOfRange |= ((uint32)Chars[Index] - 1) >> 8;
+	}
+	return OutOfRange == 0;
+}
+
+void UnrealUtils::Common::Envelope::BytesToChars(const uint8* Bytes, int32 Num, TCHAR* OutChars)
+{
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		OutChars[Index] = (TCHAR)((int16)Bytes[Index] + 1);
+	}
+}
+
+void UnrealUtils::Common::Envelope::WriteEnvelope(uint8* Sealed, int32 PayloadSize, uint8 Flags)
+{
+	const int32 UsedSize = HeaderSize + PayloadSize;
+	const int32 SealedSize = GetSealedSize(PayloadSize);
+	WriteHeader(Sealed, Flags, PayloadSize);
+	FMemory::Memzero(Sealed + UsedSize, SealedSize - UsedSize);
+}
+
+void UnrealUtils::Common::Envelope::Seal(uint8* Sealed, int32 PayloadSize, uint8 Flags, const FPreparedAESKey& Key)
+{
+	WriteEnvelope(Sealed, PayloadSize, Flags);
+
+	/** 加密. */
+	AESKernel::EncryptData(Sealed, GetSealedSize(PayloadSize), Key);
+}
+
+bool UnrealUtils::Common::Envelope::Open(uint8* Sealed, int32 SealedSize, const FPreparedAESKey& Key, TArrayView<const uint8>& OutPayload, uint8& OutFlags)
+{
+	/** 由于大小无效，消息无法解密. */
+	if (!IsValidSealedSize(SealedSize))
+	{
+		Stats::RecordFailure(Stats::EFailure::MalformedInput);
+		return false;
+	}
+
+	/** 解密 */
+	AESKernel::DecryptData(Sealed, SealedSize, Key);
+	return ReadEnvelope(Sealed, SealedSize, OutPayload, OutFlags);
+}
+
+bool UnrealUtils::Common::Envelope::ReadEnvelope(const uint8* Opened, int32 SealedSize, TArrayView<const uint8>& OutPayload, uint8& OutFlags)
+{
+	uint8 Flags = 0;
+	int32 PayloadSize = 0;
+	if (ReadHeader(Opened, SealedSize, Flags, PayloadSize))
+	{
+		if ((Flags & ~KnownFlags) != 0)
+		{
+			Stats::RecordFailure(Stats::EFailure::InvalidEnvelope);
+			return false;
+		}
+		OutPayload = TArrayView<const uint8>(Opened + HeaderSize, PayloadSize);
+		OutFlags = Flags;
+		return true;
+	}
+
+	/** 旧格式: 直接在解密后的字节中查找垃圾符号, 之前的部分就是负载, 只有这部分会被转换成字符串. */
+	const int32 SplitIndex = FindSplitSymbol(Opened, SealedSize);
+	if (SplitIndex != INDEX_NONE)
+	{
+		OutPayload = TArrayView<const uint8>(Opened, SplitIndex);
+		OutFlags = 0;
+		return true;
+	}
+	Stats::RecordFailure(Stats::EFailure::InvalidEnvelope);
+	return false;
+}
+
+int32 UnrealUtils::Common::Envelope::GetStringPayloadSize(FStringView InputString)
+{
+	return UTF8::GetEncodedSize(InputString.GetData(), InputString.Len());
+}
+
+int32 UnrealUtils::Common::Envelope::WriteStringPayload(FStringView InputString, uint8* OutPayload)
+{
+	return UTF8::Encode(InputString.GetData(), InputString.Len(), OutPayload);
+}
+
+int32 UnrealUtils::Common::Envelope::GetMaxCompressedSize(EEcryptionCompression Compression, int32 PayloadSize)
+{
+	return CompressedHeaderSize + FCompression::CompressMemoryBound(GetFormatName(Compression), PayloadSize);
+}
+
+int32 UnrealUtils::Common::Envelope::Compress(EEcryptionCompression Compression, TArrayView<const uint8> Payload, uint8* OutCompressed)
+{
+	if (Compression == EEcryptionCompression::None || Payload.Num() < MinCompressSize)
+	{
+		return 0;
+	}
+	const FName FormatName = GetFormatName(Compression);
+	if (!IsWorthCompressing(FormatName, Payload))
+	{
+		return 0;
+	}
+
+	int32 CompressedSize = GetMaxCompressedSize(Compression, Payload.Num()) - CompressedHeaderSize;
+	if (!FCompression::CompressMemory(FormatName, OutCompressed + CompressedHeaderSize, CompressedSize, Payload.GetData(), Payload.Num()))
+	{
+		return 0;
+	}
+
+	/** 按补齐后的密文大小比较, 省不下一个块就没有意义. */
+	const int32 TotalSize = CompressedHeaderSize + CompressedSize;
+	if (GetSealedSize(TotalSize) >= GetSealedSize(Payload.Num()))
+	{
+		return 0;
+	}
+
+	const uint32 PayloadSize = (uint32)Payload.Num();
+	OutCompressed[0] = GetCodec(Compression);
+	OutCompressed[1] = (uint8)(PayloadSize);
+	OutCompressed[2] = (uint8)(PayloadSize >> 8);
+	OutCompressed[3] = (uint8)(PayloadSize >> 16);
+	OutCompressed[4] = (uint8)(PayloadSize >> 24);
+	return TotalSize;
+}
+
+bool UnrealUtils::Common::Envelope::Inflate(TArrayView<const uint8>& InOutPayload, uint8& InOutFlags, Scratch::FScratchBuffer& OutStorage)
+{
+	if ((InOutFlags & FlagCompressed) == 0)
+	{
+		return true;
+	}
+
+	const uint8* Compressed = InOutPayload.GetData();
+	if (InOutPayload.Num() < CompressedHeaderSize || (Compressed[0] != CodecLZ4 && Compressed[0] != CodecZlib))
+	{
+		Stats::RecordFailure(Stats::EFailure::CorruptPayload);
+		return false;
+	}
+	const uint32 InflatedSize = (uint32)Compressed[1] | ((uint32)Compressed[2] << 8) | ((uint32)Compressed[3] << 16) | ((uint32)Compressed[4] << 24);
+	if (InflatedSize == 0 || InflatedSize > (uint32)MaxInflatedSize)
+	{
+		Stats::RecordFailure(Stats::EFailure::CorruptPayload);
+		return false;
+	}
+
+	const FName FormatName = Compressed[0] == CodecZlib ? NAME_Zlib : NAME_LZ4;
+	OutStorage.Allocate((int32)InflatedSize);
+	if (!FCompression::UncompressMemory(FormatName, OutStorage.GetData(), (int32)InflatedSize, Compressed + CompressedHeaderSize, InOutPayload.Num() - CompressedHeaderSize))
+	{
+		Stats::RecordFailure(Stats::EFailure::CorruptPayload);
+		return false;
+	}
+	InOutPayload = TArrayView<const uint8>(OutStorage.GetData(), (int32)InflatedSize);
+	InOutFlags &= ~FlagCompressed;
+	return true;
+}
+
+bool UnrealUtils::Common::Envelope::PayloadToChars(TArrayView<const uint8> Payload, uint8 Flags, TCHAR* OutChars, int32& OutNumChars)
+{
+	if ((Flags & FlagUTF8) == 0)
+	{
+		BytesToChars(Payload.GetData(), Payload.Num(), OutChars);
+		OutNumChars = Payload.Num();
+		return true;
+	}
+
+	int32 NumConsumed = 0;
+	if (!UTF8::Decode(Payload.GetData(), Payload.Num(), OutChars, OutNumChars, NumConsumed))
+	{
+		Stats::RecordFailure(Stats::EFailure::CorruptPayload);
+		return false;
+	}
+	return true;
+}
+
+FString UnrealUtils::Common::Envelope::PayloadToString(TArrayView<const uint8> Payload, uint8 Flags)
+{
+	if ((Flags & FlagUTF8) == 0)
+	{
+		return BytesToString(Payload.GetData(), Payload.Num());
+	}
+
+	FString Result;
+	if (Payload.Num() == 0)
+	{
+		return Result;
+	}
+	TArray<TCHAR>& ResultChars = Result.GetCharArray();
+	ResultChars.AddUninitialized(Payload.Num() + 1);
+	int32 NumChars = 0;
+	if (!PayloadToChars(Payload, Flags, ResultChars.GetData(), NumChars))
+	{
+		return {};
+	}
+	ResultChars.SetNum(NumChars + 1, false);
+	ResultChars[NumChars] = TEXT('\0');
+	return Result;
+}
+#undef SPLIT_SYMBOL
@@ -0,0 +1,105 @@
+// EcryptionEnvelope.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Ecryption.h"
+#include "EcryptionScratch.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /**
+         * 密文内部格式, 仅供本模块各个实现文件共用.
+         * 明文 = 信封头(12 字节) + 负载 + 补零到 16 的倍数, 整体以 AES 加密.
+         * 信封头: Magic[4] | Version | Flags | Reserved[2] | PayloadSize (uint32, 小端).
+         */
+        namespace Envelope
+        {
+            static constexpr int32 HeaderSize = 12;
+
+            /** 负载是 UTF-8 编码的字符串; 没有该标记时字符串负载按 StringToBytes 的规则映射. */
+            static constexpr uint8 FlagUTF8 = 1 << 0;
+
+            /**
+             * 负载经过压缩: Codec(1 字节) | 原始大小(uint32, 小端) | 压缩数据.
+             * 其余标记描述的是解压后的负载.
+             */
+            static constexpr uint8 FlagCompressed = 1 << 1;
+
+            /** 当前版本能够处理的全部标记, 带有其他标记的密文一律拒绝. */
+            static constexpr uint8 KnownFlags = FlagUTF8 | FlagCompressed;
+
+            /** 压缩负载前面的 Codec 和原始大小. */
+            static constexpr int32 CompressedHeaderSize = 5;
+
+            /** 加上信封头并补零到 16 的倍数后的总大小. */
+            int32 GetSealedSize(int32 PayloadSize);
+
+            /** 密文大小是否可能有效: 非空且是 16 的倍数. 所有解密路径在分配暂存内存和解密之前都用它拒绝无效的输入. */
+            bool IsValidSealedSize(int64 SealedSize);
+
+            /** 与 StringToBytes 相同的映射, 但不要求以 0 结尾. */
+            void CharsToBytes(FStringView InputString, uint8* OutBytes);
+
+            /**
+             * 字符串形式的密文能否映射回密文: 非空, 长度是 16 的倍数, 且每个字符都在 BytesToChars 的结果范围 [1, 256] 内.
+             * 不分配内存, 用于尽早拒绝无效的输入.
+             */
+            bool IsValidCipherString(FStringView InputString);
+
+            /** 与 BytesToString 相同的映射, 写入调用方提供的字符缓冲区. */
+            void BytesToChars(const uint8* Bytes, int32 Num, TCHAR* OutChars);
+
+            /** 写入信封头. */
+            void WriteHeader(uint8* Header, uint8 Flags, int32 PayloadSize);
+
+            /**
+             * 解析已解密的信封头, 只读取前 HeaderSize 字节, SealedSize 是整个密文的大小.
+             * 不是信封格式(例如旧的垃圾符号格式)时返回 false.
+             */
+            bool ReadHeader(const uint8* Header, int32 SealedSize, uint8& OutFlags, int32& OutPayloadSize);
+
+            /** 同上, 但不知道密文总大小(流式解密), 由调用方在结束时自行核对 GetSealedSize(OutPayloadSize). */
+            bool ReadHeader(const uint8* Header, uint8& OutFlags, int32& OutPayloadSize);
+
+            /** Sealed 中 [HeaderSize, HeaderSize + PayloadSize) 已写好负载, 写入信封头并补零后原地加密. */
+            void Seal(uint8* Sealed, int32 PayloadSize, uint8 Flags, const FPreparedAESKey& Key);
+
+            /** 原地解密 Sealed, 返回其中负载所在的范围和信封标记. 同时兼容旧的以垃圾符号结尾的格式(标记为 0). */
+            bool Open(uint8* Sealed, int32 SealedSize, const FPreparedAESKey& Key, TArrayView<const uint8>& OutPayload, uint8& OutFlags);
+
+            /** Seal 中加密之前的部分: 写入信封头并补零, 由调用方自行加密(例如多条消息一起走多缓冲内核). */
+            void WriteEnvelope(uint8* Sealed, int32 PayloadSize, uint8 Flags);
+
+            /** Open 中解密之后的部分: 解析已解密的 Opened, 返回负载所在的范围和信封标记. */
+            bool ReadEnvelope(const uint8* Opened, int32 SealedSize, TArrayView<const uint8>& OutPayload, uint8& OutFlags);
+
+            /** 字符串负载(UTF-8)的准确字节数. */
+            int32 GetStringPayloadSize(FStringView InputString);
+
+            /** 把字符串写成 UTF-8 负载, OutPayload 至少要有 GetStringPayloadSize 字节. 返回写入的字节数, 密封时使用 FlagUTF8. */
+            int32 WriteStringPayload(FStringView InputString, uint8* OutPayload);
+
+            /** Compress 的输出至少需要的空间. */
+            int32 GetMaxCompressedSize(EEcryptionCompression Compression, int32 PayloadSize);
+
+            /**
+             * 把负载压缩到 OutCompressed, 返回压缩后的大小(含 CompressedHeaderSize), 密封时加上 FlagCompressed.
+             * 负载太小, 开头的采样压缩不下来, 或压缩后密文不会变小时返回 0, 调用方按原样加密.
+             */
+            int32 Compress(EEcryptionCompression Compression, TArrayView<const uint8> Payload, uint8* OutCompressed);
+
+            /**
+             * 负载带 FlagCompressed 时解压到 OutStorage, InOutPayload 改为指向解压后的数据并去掉该标记.
+             * 没有该标记时什么都不做. 数据损坏时返回 false.
+             */
+            bool Inflate(TArrayView<const uint8>& InOutPayload, uint8& InOutFlags, Scratch::FScratchBuffer& OutStorage);
+
+            /** 按 Flags 把负载还原为字符, OutChars 至少要有 Payload.Num() 个字符. UTF-8 非法时返回 false. */
+            bool PayloadToChars(TArrayView<const uint8> Payload, uint8 Flags, TCHAR* OutChars, int32& OutNumChars);
+            FString PayloadToString(TArrayView<const uint8> Payload, uint8 Flags);
+        }
+    }
+}
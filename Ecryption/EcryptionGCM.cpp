@@ -0,0 +1,602 @@
+#include "Ecryption.h"
+#include "EcryptionBase64.h"
+#include "EcryptionCPU.h"
+#include "EcryptionEnvelope.h"
+#include "EcryptionRandom.h"
+#include "EcryptionScratch.h"
+#include "EcryptionStats.h"
+#include "EcryptionUTF8.h"
+
+#define ECRYPTION_WITH_GCM_INTRINSICS ECRYPTION_WITH_X86_INTRINSICS
+#define ECRYPTION_TARGET_GCM ECRYPTION_TARGET("aes,pclmul,ssse3,sse2")
+#if ECRYPTION_WITH_GCM_INTRINSICS
+	#include <wmmintrin.h>
+	#include <emmintrin.h>
+	#include <tmmintrin.h>
+#endif
+
+namespace
+{
+	static constexpr int32 BlockSize = FAES::AESBlockSize;
+
+	/** 密文前的随机 nonce, 使用 GCM 推荐的 96 位. */
+	static constexpr int32 NonceSize = 12;
+
+	/** 密文末尾的认证标签. */
+	static constexpr int32 TagSize = 16;
+
+	static constexpr int32 OverheadSize = NonceSize + TagSize;
+
+	/** 以大端的两个 64 位整数表示的 GF(2^128) 元素, 用于没有 PCLMULQDQ 时的 GHASH. */
+	struct FGHashValue
+	{
+		uint64 High = 0;
+		uint64 Low = 0;
+	};
+
+	FORCEINLINE uint64 LoadBigEndian64(const uint8* Bytes)
+	{
+		uint64 Value;
+		FMemory::Memcpy(&Value, Bytes, sizeof(Value));
+#if PLATFORM_LITTLE_ENDIAN
+		Value = BYTESWAP_ORDER64(Value);
+#endif
+		return Value;
+	}
+
+	FORCEINLINE void StoreBigEndian64(uint8* Bytes, uint64 Value)
+	{
+#if PLATFORM_LITTLE_ENDIAN
+		Value = BYTESWAP_ORDER64(Value);
+#endif
+		FMemory::Memcpy(Bytes, &Value, sizeof(Value));
+	}
+
+	/** 逐位的 GF(2^128) 乘法, 用掩码代替分支, 耗时与数据无关. */
+	FGHashValue MultiplyGHash(FGHashValue X, FGHashValue H)
+	{
+		FGHashValue Result;
+		FGHashValue V = H;
+		for (int32 Bit = 0; Bit < 128; ++Bit)
+		{
+			const uint64 Word = Bit < 64 ? X.High : X.Low;
+			const uint64 Mask = 0 - ((Word >> (63 - (Bit & 63))) & 1);
+			Result.High ^= V.High & Mask;
+			Result.Low ^= V.Low & Mask;
+
+			const uint64 ReduceMask = 0 - (V.Low & 1);
+			V.Low = (V.Low >> 1) | (V.High << 63);
+			V.High = (V.High >> 1) ^ (0xE100000000000000ull & ReduceMask);
+		}
+		return Result;
+	}
+
+	/** GHASH 累加 Data 中的若干块, 最后不足一块的部分补零. */
+	void UpdateGHash(FGHashValue& Hash, FGHashValue H, const uint8* Data, int64 NumBytes)
+	{
+		for (; NumBytes > 0; Data += BlockSize, NumBytes -= BlockSize)
+		{
+			uint8 Block[BlockSize] = {};
+			FMemory::Memcpy(Block, Data, FMath::Min<int64>(NumBytes, BlockSize));
+			Hash.High ^= LoadBigEndian64(Block);
+			Hash.Low ^= LoadBigEndian64(Block + 8);
+			Hash = MultiplyGHash(Hash, H);
+		}
+	}
+
+	/** 计数器块 J0 = Nonce || 0x00000001, 数据从 J0 + 1 开始. */
+	void MakeInitialCounter(const uint8* Nonce, uint8* OutCounter)
+	{
+		FMemory::Memcpy(OutCounter, Nonce, NonceSize);
+		OutCounter[12] = 0;
+		OutCounter[13] = 0;
+		OutCounter[14] = 0;
+		OutCounter[15] = 1;
+	}
+
+	/** 最后一块 GHASH 输入: 附加数据和密文的位长度, 各 64 位大端. 这里没有附加数据. */
+	void MakeLengthBlock(int64 NumBytes, uint8* OutBlock)
+	{
+		StoreBigEndian64(OutBlock, 0);
+		StoreBigEndian64(OutBlock + 8, (uint64)NumBytes * 8);
+	}
+
+	/**
+	 * 通用实现: CTR 复用 AESKernel::TransformCTR, GHASH 逐位计算.
+	 * 消息不超过 2^31 字节, 计数器的低 32 位不会溢出, 与 GCM 的 32 位递增一致.
+	 */
+	void TransformGCMGeneric(bool bEncrypt, const uint8* Nonce, const uint8* Input, uint8* Output, int64 NumBytes, const UnrealUtils::Common::FPreparedAESKey& Key, uint8* OutTag)
+	{
+		uint8 HashKeyBlock[BlockSize] = {};
+		UnrealUtils::Common::AESKernel::EncryptData(HashKeyBlock, BlockSize, Key);
+		const FGHashValue H{ LoadBigEndian64(HashKeyBlock), LoadBigEndian64(HashKeyBlock + 8) };
+
+		uint8 Counter[BlockSize];
+		MakeInitialCounter(Nonce, Counter);
+		uint8 TagMask[BlockSize];
+		FMemory::Memcpy(TagMask, Counter, BlockSize);
+		UnrealUtils::Common::AESKernel::EncryptData(TagMask, BlockSize, Key);
+
+		FGHashValue Hash;
+		if (!bEncrypt)
+		{
+			UpdateGHash(Hash, H, Input, NumBytes);
+		}
+		Counter[15] = 2;
+		UnrealUtils::Common::AESKernel::TransformCTR(Input, Output, NumBytes, Counter, 0, Key);
+		if (bEncrypt)
+		{
+			UpdateGHash(Hash, H, Output, NumBytes);
+		}
+
+		uint8 LengthBlock[BlockSize];
+		MakeLengthBlock(NumBytes, LengthBlock);
+		UpdateGHash(Hash, H, LengthBlock, BlockSize);
+
+		StoreBigEndian64(OutTag, Hash.High);
+		StoreBigEndian64(OutTag + 8, Hash.Low);
+		for (int32 Index = 0; Index < TagSize; ++Index)
+		{
+			OutTag[Index] ^= TagMask[Index];
+		}
+		FMemory::Memzero(HashKeyBlock, sizeof(HashKeyBlock));
+		FMemory::Memzero(TagMask, sizeof(TagMask));
+	}
+}
+
+#if ECRYPTION_WITH_GCM_INTRINSICS
+namespace
+{
+	/** 一次交错处理的块数, 同时也是 GHASH 聚合的块数(预先算好 H^1..H^8). */
+	static constexpr int32 NumParallelBlocks = 8;
+
+	/** GHASH 按位反序定义, 先把每块的字节顺序反过来, 就能直接用 pclmulqdq 做乘法. */
+	ECRYPTION_TARGET_GCM FORCEINLINE __m128i ReverseBytes(__m128i Value)
+	{
+		return _mm_shuffle_epi8(Value, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+	}
+
+	/** 累加 A * B 的 256 位无约简乘积, Middle 为两个交叉项之和. */
+	ECRYPTION_TARGET_GCM FORCEINLINE void MultiplyAccumulate(__m128i A, __m128i B, __m128i& Low, __m128i& Middle, __m128i& High)
+	{
+		Low = _mm_xor_si128(Low, _mm_clmulepi64_si128(A, B, 0x00));
+		High = _mm_xor_si128(High, _mm_clmulepi64_si128(A, B, 0x11));
+		Middle = _mm_xor_si128(Middle, _mm_xor_si128(_mm_clmulepi64_si128(A, B, 0x10), _mm_clmulepi64_si128(A, B, 0x01)));
+	}
+
+	/** 把累加的乘积左移一位(补偿位反序)后按 x^128 + x^7 + x^2 + x + 1 约简. */
+	ECRYPTION_TARGET_GCM FORCEINLINE __m128i Reduce(__m128i Low, __m128i Middle, __m128i High)
+	{
+		Low = _mm_xor_si128(Low, _mm_slli_si128(Middle, 8));
+		High = _mm_xor_si128(High, _mm_srli_si128(Middle, 8));
+
+		const __m128i LowCarry = _mm_srli_epi32(Low, 31);
+		const __m128i HighCarry = _mm_srli_epi32(High, 31);
+		Low = _mm_or_si128(_mm_slli_epi32(Low, 1), _mm_slli_si128(LowCarry, 4));
+		High = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(High, 1), _mm_slli_si128(HighCarry, 4)), _mm_srli_si128(LowCarry, 12));
+
+		__m128i Fold = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(Low, 31), _mm_slli_epi32(Low, 30)), _mm_slli_epi32(Low, 25));
+		const __m128i FoldHigh = _mm_srli_si128(Fold, 4);
+		Low = _mm_xor_si128(Low, _mm_slli_si128(Fold, 12));
+		Fold = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(Low, 1), _mm_srli_epi32(Low, 2)), _mm_srli_epi32(Low, 7));
+		Fold = _mm_xor_si128(Fold, FoldHigh);
+		return _mm_xor_si128(High, _mm_xor_si128(Low, Fold));
+	}
+
+	ECRYPTION_TARGET_GCM FORCEINLINE __m128i MultiplyGHash(__m128i A, __m128i B)
+	{
+		__m128i Low = _mm_setzero_si128();
+		__m128i Middle = _mm_setzero_si128();
+		__m128i High = _mm_setzero_si128();
+		MultiplyAccumulate(A, B, Low, Middle, High);
+		return Reduce(Low, Middle, High);
+	}
+
+	/** 在编译期展开第 Round 到 LastRound - 1 轮. */
+	template <int32 Round, int32 LastRound>
+	ECRYPTION_TARGET_GCM FORCEINLINE __m128i AESRounds1(__m128i Block, const __m128i* RoundKeys)
+	{
+		if constexpr (Round < LastRound)
+		{
+			return AESRounds1<Round + 1, LastRound>(_mm_aesenc_si128(Block, RoundKeys[Round]), RoundKeys);
+		}
+		else
+		{
+			return Block;
+		}
+	}
+
+	template <int32 NumRounds>
+	ECRYPTION_TARGET_GCM FORCEINLINE __m128i EncryptBlock(__m128i Block, const __m128i* RoundKeys)
+	{
+		Block = AESRounds1<1, NumRounds>(_mm_xor_si128(Block, RoundKeys[0]), RoundKeys);
+		return _mm_aesenclast_si128(Block, RoundKeys[NumRounds]);
+	}
+
+	/** 8 个状态各做一轮 aesenc. */
+	ECRYPTION_TARGET_GCM FORCEINLINE void AESRound8(__m128i* State, __m128i RoundKey)
+	{
+		State[0] = _mm_aesenc_si128(State[0], RoundKey);
+		State[1] = _mm_aesenc_si128(State[1], RoundKey);
+		State[2] = _mm_aesenc_si128(State[2], RoundKey);
+		State[3] = _mm_aesenc_si128(State[3], RoundKey);
+		State[4] = _mm_aesenc_si128(State[4], RoundKey);
+		State[5] = _mm_aesenc_si128(State[5], RoundKey);
+		State[6] = _mm_aesenc_si128(State[6], RoundKey);
+		State[7] = _mm_aesenc_si128(State[7], RoundKey);
+	}
+
+	template <int32 Round, int32 LastRound>
+	ECRYPTION_TARGET_GCM FORCEINLINE void AESRounds8(__m128i* State, const __m128i* RoundKeys)
+	{
+		if constexpr (Round < LastRound)
+		{
+			AESRound8(State, RoundKeys[Round]);
+			AESRounds8<Round + 1, LastRound>(State, RoundKeys);
+		}
+	}
+
+	/**
+	 * 每次 8 块: 8 个计数器块的 aesenc 与 8 块密文的 GHASH 乘法交错执行, 乘法掩盖在 AES 的延迟里,
+	 * 8 个乘积只约简一次. 加密时哈希的是上一组刚生成的密文, 解密时直接哈希本组输入.
+	 * 前 8 轮每轮之后插入一次乘法, 其余的轮按 NumRounds 在编译期展开, 状态和待哈希的块都留在寄存器中.
+	 * Counter 和 Hash 都是字节反序后的形式.
+	 */
+	template <int32 NumRounds, bool bEncrypt>
+	ECRYPTION_TARGET_GCM void TransformBlocksGCM(const uint8* Input, uint8* Output, int64 NumBlocks, __m128i& Counter, __m128i& Hash, const __m128i* RoundKeys, const __m128i* HashKeyPowers)
+	{
+		const __m128i One = _mm_set_epi32(0, 0, 0, 1);
+		const __m128i* InBlocks = (const __m128i*)Input;
+		__m128i* OutBlocks = (__m128i*)Output;
+
+		/** 加密时第一组之前没有待哈希的密文, 先单独处理一组, 让循环体里不再有分支. */
+		__m128i Pending[NumParallelBlocks];
+		if (bEncrypt && NumBlocks >= NumParallelBlocks)
+		{
+			for (int32 Index = 0; Index < NumParallelBlocks; ++Index)
+			{
+				Counter = _mm_add_epi32(Counter, One);
+				const __m128i Block = _mm_xor_si128(EncryptBlock<NumRounds>(ReverseBytes(Counter), RoundKeys), _mm_loadu_si128(InBlocks + Index));
+				_mm_storeu_si128(OutBlocks + Index, Block);
+				Pending[Index] = ReverseBytes(Block);
+			}
+			Pending[0] = _mm_xor_si128(Pending[0], Hash);
+			NumBlocks -= NumParallelBlocks;
+			InBlocks += NumParallelBlocks;
+			OutBlocks += NumParallelBlocks;
+		}
+
+		for (; NumBlocks >= NumParallelBlocks; NumBlocks -= NumParallelBlocks, InBlocks += NumParallelBlocks, OutBlocks += NumParallelBlocks)
+		{
+			if (!bEncrypt)
+			{
+				for (int32 Index = 0; Index < NumParallelBlocks; ++Index)
+				{
+					Pending[Index] = ReverseBytes(_mm_loadu_si128(InBlocks + Index));
+				}
+				Pending[0] = _mm_xor_si128(Pending[0], Hash);
+			}
+
+			__m128i State[NumParallelBlocks];
+			for (int32 Index = 0; Index < NumParallelBlocks; ++Index)
+			{
+				Counter = _mm_add_epi32(Counter, One);
+				State[Index] = _mm_xor_si128(ReverseBytes(Counter), RoundKeys[0]);
+			}
+
+			__m128i Low = _mm_setzero_si128();
+			__m128i Middle = _mm_setzero_si128();
+			__m128i High = _mm_setzero_si128();
+			AESRound8(State, RoundKeys[1]);
+			MultiplyAccumulate(Pending[0], HashKeyPowers[7], Low, Middle, High);
+			AESRound8(State, RoundKeys[2]);
+			MultiplyAccumulate(Pending[1], HashKeyPowers[6], Low, Middle, High);
+			AESRound8(State, RoundKeys[3]);
+			MultiplyAccumulate(Pending[2], HashKeyPowers[5], Low, Middle, High);
+			AESRound8(State, RoundKeys[4]);
+			MultiplyAccumulate(Pending[3], HashKeyPowers[4], Low, Middle, High);
+			AESRound8(State, RoundKeys[5]);
+			MultiplyAccumulate(Pending[4], HashKeyPowers[3], Low, Middle, High);
+			AESRound8(State, RoundKeys[6]);
+			MultiplyAccumulate(Pending[5], HashKeyPowers[2], Low, Middle, High);
+			AESRound8(State, RoundKeys[7]);
+			MultiplyAccumulate(Pending[6], HashKeyPowers[1], Low, Middle, High);
+			AESRound8(State, RoundKeys[8]);
+			MultiplyAccumulate(Pending[7], HashKeyPowers[0], Low, Middle, High);
+			AESRound8(State, RoundKeys[9]);
+			Hash = Reduce(Low, Middle, High);
+			AESRounds8<10, NumRounds>(State, RoundKeys);
+
+			const __m128i LastKey = RoundKeys[NumRounds];
+			for (int32 Index = 0; Index < NumParallelBlocks; ++Index)
+			{
+				const __m128i Block = _mm_xor_si128(_mm_aesenclast_si128(State[Index], LastKey), _mm_loadu_si128(InBlocks + Index));
+				_mm_storeu_si128(OutBlocks + Index, Block);
+				if (bEncrypt)
+				{
+					Pending[Index] = ReverseBytes(Block);
+				}
+			}
+			if (bEncrypt)
+			{
+				Pending[0] = _mm_xor_si128(Pending[0], Hash);
+			}
+		}
+
+		/** 加密时最后一组密文还没有哈希. */
+		if (bEncrypt && InBlocks != (const __m128i*)Input)
+		{
+			__m128i Low = _mm_setzero_si128();
+			__m128i Middle = _mm_setzero_si128();
+			__m128i High = _mm_setzero_si128();
+			for (int32 Index = 0; Index < NumParallelBlocks; ++Index)
+			{
+				MultiplyAccumulate(Pending[Index], HashKeyPowers[NumParallelBlocks - 1 - Index], Low, Middle, High);
+			}
+			Hash = Reduce(Low, Middle, High);
+		}
+
+		for (; NumBlocks > 0; --NumBlocks, ++InBlocks, ++OutBlocks)
+		{
+			const __m128i InBlock = _mm_loadu_si128(InBlocks);
+			Counter = _mm_add_epi32(Counter, One);
+			const __m128i OutBlock = _mm_xor_si128(EncryptBlock<NumRounds>(ReverseBytes(Counter), RoundKeys), InBlock);
+			_mm_storeu_si128(OutBlocks, OutBlock);
+			Hash = MultiplyGHash(_mm_xor_si128(Hash, ReverseBytes(bEncrypt ? OutBlock : InBlock)), HashKeyPowers[0]);
+		}
+	}
+
+	template <int32 NumRounds>
+	ECRYPTION_TARGET_GCM void TransformGCMHardware(bool bEncrypt, const uint8* Nonce, const uint8* Input, uint8* Output, int64 NumBytes, const UnrealUtils::Common::FPreparedAESKey& Key, uint8* OutTag)
+	{
+		const __m128i* RoundKeys = (const __m128i*)Key.GetEncryptRoundKeys();
+
+		__m128i HashKeyPowers[NumParallelBlocks];
+		HashKeyPowers[0] = ReverseBytes(EncryptBlock<NumRounds>(_mm_setzero_si128(), RoundKeys));
+		for (int32 Index = 1; Index < NumParallelBlocks; ++Index)
+		{
+			HashKeyPowers[Index] = MultiplyGHash(HashKeyPowers[Index - 1], HashKeyPowers[0]);
+		}
+
+		uint8 InitialCounter[BlockSize];
+		MakeInitialCounter(Nonce, InitialCounter);
+		const __m128i InitialCounterBlock = _mm_loadu_si128((const __m128i*)InitialCounter);
+		__m128i Counter = ReverseBytes(InitialCounterBlock);
+		__m128i Hash = _mm_setzero_si128();
+
+		const int64 NumFullBlocks = NumBytes / BlockSize;
+		if (bEncrypt)
+		{
+			TransformBlocksGCM<NumRounds, true>(Input, Output, NumFullBlocks, Counter, Hash, RoundKeys, HashKeyPowers);
+		}
+		else
+		{
+			TransformBlocksGCM<NumRounds, false>(Input, Output, NumFullBlocks, Counter, Hash, RoundKeys, HashKeyPowers);
+		}
+
+		const int64 NumTailBytes = NumBytes - NumFullBlocks * BlockSize;
+		if (NumTailBytes > 0)
+		{
+			alignas(16) uint8 Tail[BlockSize] = {};
+			FMemory::Memcpy(Tail, Input + NumFullBlocks * BlockSize, NumTailBytes);
+			const __m128i InBlock = _mm_load_si128((const __m128i*)Tail);
+			Counter = _mm_add_epi32(Counter, _mm_set_epi32(0, 0, 0, 1));
+			_mm_store_si128((__m128i*)Tail, _mm_xor_si128(EncryptBlock<NumRounds>(ReverseBytes(Counter), RoundKeys), InBlock));
+			FMemory::Memcpy(Output + NumFullBlocks * BlockSize, Tail, NumTailBytes);
+
+			/** 哈希的是补零后的密文, 解密时就是补零后的输入. */
+			if (bEncrypt)
+			{
+				FMemory::Memzero(Tail + NumTailBytes, BlockSize - NumTailBytes);
+			}
+			else
+			{
+				_mm_store_si128((__m128i*)Tail, InBlock);
+			}
+			Hash = MultiplyGHash(_mm_xor_si128(Hash, ReverseBytes(_mm_load_si128((const __m128i*)Tail))), HashKeyPowers[0]);
+			FMemory::Memzero(Tail, sizeof(Tail));
+		}
+
+		uint8 LengthBlock[BlockSize];
+		MakeLengthBlock(NumBytes, LengthBlock);
+		Hash = MultiplyGHash(_mm_xor_si128(Hash, ReverseBytes(_mm_loadu_si128((const __m128i*)LengthBlock))), HashKeyPowers[0]);
+
+		const __m128i Tag = _mm_xor_si128(ReverseBytes(Hash), EncryptBlock<NumRounds>(InitialCounterBlock, RoundKeys));
+		_mm_storeu_si128((__m128i*)OutTag, Tag);
+
+		for (int32 Index = 0; Index < NumParallelBlocks; ++Index)
+		{
+			HashKeyPowers[Index] = _mm_setzero_si128();
+		}
+	}
+}
+#endif
+
+namespace
+{
+	bool HasGCMHardwareSupport(const UnrealUtils::Common::FPreparedAESKey& Key)
+	{
+		const UnrealUtils::Common::FCPUFeatures& Features = UnrealUtils::Common::FCPUFeatures::Get();
+		return Key.IsExpanded() && Features.bPCLMULQDQ && Features.bSSSE3;
+	}
+
+	/** 加密或解密 NumBytes 字节, 同时算出认证标签. Input 可以等于 Output. */
+	void TransformGCM(bool bEncrypt, const uint8* Nonce, const uint8* Input, uint8* Output, int64 NumBytes, const UnrealUtils::Common::FPreparedAESKey& Key, uint8* OutTag)
+	{
+#if ECRYPTION_WITH_GCM_INTRINSICS
+		if (HasGCMHardwareSupport(Key))
+		{
+			switch (Key.GetNumRounds())
+			{
+			case 10:
+				TransformGCMHardware<10>(bEncrypt, Nonce, Input, Output, NumBytes, Key, OutTag);
+				break;
+			case 12:
+				TransformGCMHardware<12>(bEncrypt, Nonce, Input, Output, NumBytes, Key, OutTag);
+				break;
+			default:
+				TransformGCMHardware<14>(bEncrypt, Nonce, Input, Output, NumBytes, Key, OutTag);
+				break;
+			}
+			return;
+		}
+#endif
+		TransformGCMGeneric(bEncrypt, Nonce, Input, Output, NumBytes, Key, OutTag);
+	}
+
+	/** 常数时间比较标签, 耗时不暴露第一个不同字节的位置. */
+	bool TagsEqual(const uint8* A, const uint8* B)
+	{
+		uint8 Difference = 0;
+		for (int32 Index = 0; Index < TagSize; ++Index)
+		{
+			Difference |= A[Index] ^ B[Index];
+		}
+		return Difference == 0;
+	}
+
+	/**
+	 * Sealed = Nonce + 明文 + 标签空间, 原地加密并写入 nonce 和标签.
+	 * 每条消息使用 96 位密码学随机的 nonce; 拿不到随机数时不加密并返回 false, nonce 重复会同时破坏保密性和认证.
+	 */
+	bool SealGCM(uint8* Sealed, int32 PayloadSize, const UnrealUtils::Common::FPreparedAESKey& Key)
+	{
+		if (!ensureMsgf(UnrealUtils::Common::SecureRandom::GenerateBytes(Sealed, NonceSize), TEXT("Unable to encrypt message because no secure random nonce is available.")))
+		{
+			return false;
+		}
+		uint8* Payload = Sealed + NonceSize;
+		TransformGCM(true, Sealed, Payload, Payload, PayloadSize, Key, Payload + PayloadSize);
+		return true;
+	}
+
+	/**
+	 * 解密 Sealed 中的数据到 OutPayload(可以与 Sealed + NonceSize 相同), 同时校验标签.
+	 * 标签不符时把已写出的数据清零并返回 false, 调用方不会拿到任何明文.
+	 */
+	bool OpenGCM(const uint8* Sealed, int32 SealedSize, const UnrealUtils::Common::FPreparedAESKey& Key, uint8* OutPayload)
+	{
+		const int32 PayloadSize = SealedSize - OverheadSize;
+		uint8 Tag[TagSize];
+		TransformGCM(false, Sealed, Sealed + NonceSize, OutPayload, PayloadSize, Key, Tag);
+		if (!TagsEqual(Tag, Sealed + NonceSize + PayloadSize))
+		{
+			FMemory::Memzero(OutPayload, PayloadSize);
+			UnrealUtils::Common::Stats::RecordFailure(UnrealUtils::Common::Stats::EFailure::AuthenticationFailed);
+			return false;
+		}
+		return true;
+	}
+
+	/** 装不下 nonce 和标签的密文无法解密. */
+	bool IsValidSealedSize(int64 SealedSize)
+	{
+		if (SealedSize <= OverheadSize)
+		{
+			UnrealUtils::Common::Stats::RecordFailure(UnrealUtils::Common::Stats::EFailure::MalformedInput);
+			return false;
+		}
+		return true;
+	}
+}
+
+bool UnrealUtils::Common::EncryptGCM(TArrayView<const uint8> InputBytes, const FPreparedAESKey& Key, TArray<uint8>& OutCipher)
+{
+	Stats::FScopedCall Call(Stats::EFunction::EncryptGCM, InputBytes.Num());
+	if (!ensure(!InputBytes.IsEmpty())) { return false; }
+	if (!ensure(Key.IsValid())) { return false; }
+	if (!ensureMsgf(InputBytes.Num() <= MAX_int32 - OverheadSize, TEXT("Message is too large."))) { return false; }
+
+	OutCipher.Reset(InputBytes.Num() + OverheadSize);
+	OutCipher.AddUninitialized(InputBytes.Num() + OverheadSize);
+	FMemory::Memcpy(OutCipher.GetData() + NonceSize, InputBytes.GetData(), InputBytes.Num());
+	if (!SealGCM(OutCipher.GetData(), InputBytes.Num(), Key))
+	{
+		OutCipher.Reset();
+		return false;
+	}
+	Call.Succeed(OutCipher.Num());
+	return true;
+}
+
+bool UnrealUtils::Common::DecryptGCM(TArrayView<const uint8> InputCipher, const FPreparedAESKey& Key, TArray<uint8>& OutBytes)
+{
+	Stats::FScopedCall Call(Stats::EFunction::DecryptGCM, InputCipher.Num());
+	OutBytes.Reset();
+	if (!ensure(Key.IsValid())) { return false; }
+	if (!IsValidSealedSize(InputCipher.Num())) { return false; }
+
+	OutBytes.AddUninitialized(InputCipher.Num() - OverheadSize);
+	if (!OpenGCM(InputCipher.GetData(), InputCipher.Num(), Key, OutBytes.GetData()))
+	{
+		OutBytes.Reset();
+		return false;
+	}
+	Call.Succeed(OutBytes.Num());
+	return true;
+}
+
+FString UnrealUtils::Common::EncryptGCMBase64(const FString& InputString, const FPreparedAESKey& Key)
+{
+	Stats::FScopedCall Call(Stats::EFunction::EncryptGCM, InputString.Len());
+	if (!ensure(!InputString.IsEmpty())) { return{}; }
+	if (!ensure(Key.IsValid())) { return{}; }
+
+	const FStringView Input(InputString);
+	const int32 PayloadSize = Envelope::GetStringPayloadSize(Input);
+	if (!ensureMsgf(PayloadSize <= MAX_int32 / 4 * 3 - OverheadSize, TEXT("Message is too large."))) { return{}; }
+
+	Scratch::FScratchBuffer Buffer(PayloadSize + OverheadSize);
+	Envelope::WriteStringPayload(Input, Buffer.GetData() + NonceSize);
+	if (!SealGCM(Buffer.GetData(), PayloadSize, Key)) { return{}; }
+	FString Result = Base64::Encode(Buffer.GetData(), Buffer.Num());
+	Call.Succeed(Result.Len());
+	return Result;
+}
+
+FString UnrealUtils::Common::DecryptGCMBase64(const FString& InputString, const FPreparedAESKey& Key)
+{
+	Stats::FScopedCall Call(Stats::EFunction::DecryptGCM, InputString.Len());
+	if (!ensure(Key.IsValid())) { return{}; }
+
+	/** 与 DecryptBase64 相同, 先不分配内存地校验输入. */
+	uint32 SealedSize = 0;
+	if (!Base64::Validate(*InputString, InputString.Len(), SealedSize))
+	{
+		Stats::RecordFailure(Stats::EFailure::MalformedInput);
+		return{};
+	}
+	if (!IsValidSealedSize(SealedSize)) { return{}; }
+
+	/** 已经校验过, 解码不会失败. */
+	Scratch::FScratchBuffer Buffer((int32)SealedSize);
+	Base64::Decode(*InputString, InputString.Len(), Buffer.GetData());
+
+	/** 原地解密, 标签通过后才构造字符串. */
+	if (!OpenGCM(Buffer.GetData(), Buffer.Num(), Key, Buffer.GetData() + NonceSize)) { return{}; }
+
+	const TArrayView<const uint8> Payload(Buffer.GetData() + NonceSize, Buffer.Num() - OverheadSize);
+	FString Result = Envelope::PayloadToString(Payload, Envelope::FlagUTF8);
+	Call.Succeed(Result.Len());
+	return Result;
+}
+
+bool UnrealUtils::Common::EncryptGCM(TArrayView<const uint8> InputBytes, const FAES::FAESKey& Key, TArray<uint8>& OutCipher)
+{
+	return EncryptGCM(InputBytes, FPreparedAESKey(Key), OutCipher);
+}
+
+bool UnrealUtils::Common::DecryptGCM(TArrayView<const uint8> InputCipher, const FAES::FAESKey& Key, TArray<uint8>& OutBytes)
+{
+	return DecryptGCM(InputCipher, FPreparedAESKey(Key), OutBytes);
+}
+
+FString UnrealUtils::Common::EncryptGCMBase64(const FString& InputString, const FAES::FAESKey& Key)
+{
+	return EncryptGCMBase64(InputString, FPreparedAESKey(Key));
+}
+
+FString UnrealUtils::Common::DecryptGCMBase64(const FString& InputString, const FAES::FAESKey& Key)
+{
+	return DecryptGCMBase64(InputString, FPreparedAESKey(Key));
+}
@@ -0,0 +1,80 @@
+#include "EcryptionRandom.h"
+
+#if PLATFORM_WINDOWS
+	#include "Windows/AllowWindowsPlatformTypes.h"
+	#include <bcrypt.h>
+	#include "Windows/HideWindowsPlatformTypes.h"
+	#pragma comment(lib, "bcrypt.lib")
+#elif PLATFORM_LINUX || PLATFORM_ANDROID
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#elif PLATFORM_APPLE
+	#include <stdlib.h>
+#endif
+
+namespace
+{
+#if PLATFORM_LINUX || PLATFORM_ANDROID
+	/** 内核不支持 getrandom(3.17 之前)时退回 /dev/urandom. */
+	bool ReadDevURandom(uint8* OutBytes, int32 NumBytes)
+	{
+		const int FileHandle = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+		if (FileHandle < 0)
+		{
+			return false;
+		}
+		int32 NumRead = 0;
+		while (NumRead < NumBytes)
+		{
+			const ssize_t Result = read(FileHandle, OutBytes + NumRead, NumBytes - NumRead);
+			if (Result > 0)
+			{
+				NumRead += (int32)Result;
+			}
+			else if (Result == 0 || errno != EINTR)
+			{
+				break;
+			}
+		}
+		close(FileHandle);
+		return NumRead == NumBytes;
+	}
+#endif
+}
+
+bool UnrealUtils::Common::SecureRandom::GenerateBytes(uint8* OutBytes, int32 NumBytes)
+{
+	check(NumBytes >= 0);
+#if PLATFORM_WINDOWS
+	return BCryptGenRandom(nullptr, OutBytes, (ULONG)NumBytes, BCRYPT_USE_SYSTEM_PREFERRED_RNG) >= 0;
+#elif PLATFORM_LINUX || PLATFORM_ANDROID
+	/** 直接走系统调用, 旧的 glibc/bionic 没有 getrandom 的封装. */
+	int32 NumRead = 0;
+	while (NumRead < NumBytes)
+	{
+		const long Result = syscall(SYS_getrandom, OutBytes + NumRead, (size_t)(NumBytes - NumRead), 0);
+		if (Result > 0)
+		{
+			NumRead += (int32)Result;
+		}
+		else if (Result < 0 && errno == ENOSYS)
+		{
+			return ReadDevURandom(OutBytes + NumRead, NumBytes - NumRead);
+		}
+		else if (Result == 0 || errno != EINTR)
+		{
+			return false;
+		}
+	}
+	return true;
+#elif PLATFORM_APPLE
+	/** Apple 平台上 arc4random_buf 由内核的 CSPRNG 提供, 不会失败. */
+	arc4random_buf(OutBytes, (size_t)NumBytes);
+	return true;
+#else
+	ensureMsgf(false, TEXT("No secure random source on this platform."));
+	return false;
+#endif
+}
@@ -0,0 +1,21 @@
+// EcryptionRandom.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /**
+         * 操作系统提供的密码学安全随机数, 用于 CTR 的初始计数器和 GCM 的 nonce.
+         * FGuid::NewGuid 由时间戳, 计数器和普通随机数拼成, 不能用在这里: nonce 或计数器一旦在同一个密钥下重复, 密钥流就会重合.
+         */
+        namespace SecureRandom
+        {
+            /** 用随机字节填满 OutBytes. 系统随机源不可用时返回 false, 调用方必须放弃加密. */
+            bool GenerateBytes(uint8* OutBytes, int32 NumBytes);
+        }
+    }
+}
@@ -0,0 +1,165 @@
+#include "EcryptionScratch.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+
+namespace
+{
+	static constexpr int32 MinSizeClassLog2 = 8;
+	static constexpr int32 MaxSizeClassLog2 = 22;
+	static constexpr int32 NumSizeClasses = MaxSizeClassLog2 - MinSizeClassLog2 + 1;
+
+	/** 同一线程中同时借出同一级的情况很少超过两块(例如解密时的密文和负载). */
+	static constexpr int32 MaxBlocksPerClass = 2;
+
+	std::atomic<int64> NumHeapAllocations{ 0 };
+
+	/** 默认 1 MB: 足以覆盖常见消息的密文和负载, 又不会让每个工作线程长期占用大块内存. */
+	int32 ScratchMaxRetainedKB = 1024;
+
+	FAutoConsoleVariableRef CVarScratchMaxRetainedKB(
+		TEXT("Ecryption.Scratch.MaxRetainedKB"),
+		ScratchMaxRetainedKB,
+		TEXT("Maximum scratch memory in KB each thread keeps cached between Ecryption calls. Blocks beyond this are returned to the heap."));
+
+	/** 每次内存整理加一. 池无法从其他线程访问, 各线程发现代数变化后自行释放缓存. */
+	std::atomic<uint32> TrimGeneration{ 0 };
+
+	void OnMemoryTrim()
+	{
+		TrimGeneration.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	FORCEINLINE int32 GetSizeClass(int32 Size)
+	{
+		const int32 SizeLog2 = Size <= 1 ? 0 : (int32)FMath::CeilLogTwo((uint32)Size);
+		const int32 SizeClass = FMath::Max(SizeLog2, MinSizeClassLog2) - MinSizeClassLog2;
+		return SizeClass < NumSizeClasses ? SizeClass : INDEX_NONE;
+	}
+
+	FORCEINLINE int32 GetClassSize(int32 SizeClass)
+	{
+		return 1 << (SizeClass + MinSizeClassLog2);
+	}
+
+	uint8* AllocateFromHeap(int32 Size)
+	{
+		NumHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+		return (uint8*)FMemory::Malloc(Size, 16);
+	}
+
+	struct FScratchPool
+	{
+		uint8* Blocks[NumSizeClasses][MaxBlocksPerClass] = {};
+		int32 NumBlocks[NumSizeClasses] = {};
+		int64 NumRetainedBytes = 0;
+		uint32 SeenTrimGeneration = 0;
+
+		FScratchPool()
+		{
+			/** 第一个线程池创建时注册一次. */
+			[[maybe_unused]] static const bool bTrimRegistered = (FCoreDelegates::GetMemoryTrimDelegate().AddStatic(&OnMemoryTrim), true);
+			SeenTrimGeneration = TrimGeneration.load(std::memory_order_relaxed);
+		}
+
+		~FScratchPool()
+		{
+			FreeAll();
+		}
+
+		void FreeAll()
+		{
+			for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+			{
+				for (int32 Index = 0; Index < NumBlocks[SizeClass]; ++Index)
+				{
+					FMemory::Free(Blocks[SizeClass][Index]);
+				}
+				NumBlocks[SizeClass] = 0;
+			}
+			NumRetainedBytes = 0;
+		}
+
+		/** 其他线程请求过内存整理时释放全部缓存. */
+		void TrimIfRequested()
+		{
+			const uint32 Generation = TrimGeneration.load(std::memory_order_relaxed);
+			if (Generation != SeenTrimGeneration)
+			{
+				SeenTrimGeneration = Generation;
+				FreeAll();
+			}
+		}
+
+		uint8* Acquire(int32 SizeClass)
+		{
+			TrimIfRequested();
+			if (NumBlocks[SizeClass] > 0)
+			{
+				NumRetainedBytes -= GetClassSize(SizeClass);
+				return Blocks[SizeClass][--NumBlocks[SizeClass]];
+			}
+			return AllocateFromHeap(GetClassSize(SizeClass));
+		}
+
+		void Release(int32 SizeClass, uint8* Block)
+		{
+			TrimIfRequested();
+			const int64 ClassSize = GetClassSize(SizeClass);
+			if (NumBlocks[SizeClass] < MaxBlocksPerClass && NumRetainedBytes + ClassSize <= (int64)ScratchMaxRetainedKB * 1024)
+			{
+				Blocks[SizeClass][NumBlocks[SizeClass]++] = Block;
+				NumRetainedBytes += ClassSize;
+				return;
+			}
+			FMemory::Free(Block);
+		}
+	};
+
+	FScratchPool& GetThreadPool()
+	{
+		static thread_local FScratchPool Pool;
+		return Pool;
+	}
+}
+
+UnrealUtils::Common::Scratch::FScratchBuffer::FScratchBuffer()
+	: Data(nullptr)
+	, Size(0)
+	, SizeClass(INDEX_NONE)
+{
+}
+
+UnrealUtils::Common::Scratch::FScratchBuffer::FScratchBuffer(int32 InSize)
+	: FScratchBuffer()
+{
+	Allocate(InSize);
+}
+
+void UnrealUtils::Common::Scratch::FScratchBuffer::Allocate(int32 InSize)
+{
+	check(Data == nullptr);
+	Size = FMath::Max(InSize, 0);
+	SizeClass = GetSizeClass(Size);
+	Data = SizeClass != INDEX_NONE ? GetThreadPool().Acquire(SizeClass) : AllocateFromHeap(Size);
+}
+
+UnrealUtils::Common::Scratch::FScratchBuffer::~FScratchBuffer()
+{
+	if (Data == nullptr)
+	{
+		return;
+	}
+	/** 暂存内存中可能有明文, 归还前清零. */
+	FMemory::Memzero(Data, Size);
+	if (SizeClass != INDEX_NONE)
+	{
+		GetThreadPool().Release(SizeClass, Data);
+		return;
+	}
+	FMemory::Free(Data);
+}
+
+int64 UnrealUtils::Common::Scratch::GetNumHeapAllocations()
+{
+	return NumHeapAllocations.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,47 @@
+// EcryptionScratch.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /**
+         * 线程本地的暂存内存, 供加解密过程中的中间缓冲区使用, 稳态下不再访问堆.
+         * 按 2 的幂分级(256 B 到 4 MB), 每级每个线程最多缓存两块; 更大的请求直接走堆, 用完即释放.
+         * 每个线程缓存的总量不超过 Ecryption.Scratch.MaxRetainedKB, 超出的块归还时直接释放.
+         * 收到 FCoreDelegates::GetMemoryTrimDelegate() 时, 各线程在下一次借出或归还时释放全部缓存.
+         */
+        namespace Scratch
+        {
+            /** 从本线程的池中借出至少 Size 字节, 析构时清零已借出的部分并归还. 只能在同一线程中使用和析构. */
+            class FScratchBuffer
+            {
+            public:
+                /** 空的缓冲区, 需要时再调用 Allocate, 用于事先不知道是否需要暂存内存的场合. */
+                FScratchBuffer();
+                explicit FScratchBuffer(int32 InSize);
+                ~FScratchBuffer();
+
+                /** 只能在空的缓冲区上调用一次. */
+                void Allocate(int32 InSize);
+
+                FScratchBuffer(const FScratchBuffer&) = delete;
+                FScratchBuffer& operator=(const FScratchBuffer&) = delete;
+
+                uint8* GetData() const { return Data; }
+                int32 Num() const { return Size; }
+
+            private:
+                uint8* Data;
+                int32 Size;
+                int32 SizeClass;
+            };
+
+            /** 所有线程的暂存池累计向堆申请内存的次数. 稳态下多次调用前后的差值应为 0. */
+            int64 GetNumHeapAllocations();
+        }
+    }
+}
@@ -0,0 +1,377 @@
+#include "EcryptionStats.h"
+#include "EcryptionCPU.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+#if ECRYPTION_WITH_X86_INTRINSICS
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+	#else
+		#include <x86intrin.h>
+	#endif
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogEcryptionStats, Log, All);
+
+namespace
+{
+	static constexpr int32 NumFunctions = (int32)UnrealUtils::Common::Stats::EFunction::Num;
+	static constexpr int32 NumFailureReasons = (int32)UnrealUtils::Common::Stats::EFailure::Num;
+
+	/** 第 i 个桶是 [2^i, 2^(i+1)) 个时钟周期, 最后一个桶同时收下更慢的调用(几分钟以上). */
+	static constexpr int32 NumLatencyBuckets = 40;
+
+	/** 换算周期和纳秒时至少需要经过的时间. */
+	static constexpr double MinCalibrationSeconds = 0.01;
+
+	static constexpr const TCHAR* FunctionNames[] = {
+		TEXT("Encrypt"), TEXT("Decrypt"), TEXT("EncryptBase64"), TEXT("DecryptBase64"),
+		TEXT("EncryptCTR"), TEXT("DecryptCTR"), TEXT("EncryptGCM"), TEXT("DecryptGCM") };
+	static_assert(UE_ARRAY_COUNT(FunctionNames) == NumFunctions, "FunctionNames must match EFunction.");
+
+	static constexpr const TCHAR* FailureNames[] = {
+		TEXT("invalid_argument"), TEXT("malformed_input"), TEXT("invalid_envelope"), TEXT("corrupt_payload"), TEXT("authentication_failed") };
+	static_assert(UE_ARRAY_COUNT(FailureNames) == NumFailureReasons, "FailureNames must match EFailure.");
+
+	bool bStatsEnabled = true;
+	FAutoConsoleVariableRef CVarStatsEnabled(
+		TEXT("Ecryption.Stats.Enabled"),
+		bStatsEnabled,
+		TEXT("Records call counts, sizes, failures and latency histograms for the Ecryption functions."));
+
+	/**
+	 * 记录耗时用的时钟. x86 上直接读时间戳计数器, 比 FPlatformTime::Cycles64 快得多(后者在部分平台上是系统调用),
+	 * 计数器的频率在读取快照时才根据经过的时间算出.
+	 */
+	FORCEINLINE uint64 ReadTicks()
+	{
+#if ECRYPTION_WITH_X86_INTRINSICS
+		return __rdtsc();
+#else
+		return FPlatformTime::Cycles64();
+#endif
+	}
+
+	/** 一个函数的全部计数. 线程分片中用 std::atomic, 汇总时用 uint64. */
+	template <typename CounterType>
+	struct TFunctionCounters
+	{
+		CounterType NumCalls{};
+		CounterType NumInput{};
+		CounterType NumOutput{};
+		CounterType TotalTicks{};
+		CounterType Failures[NumFailureReasons]{};
+		CounterType LatencyBuckets[NumLatencyBuckets]{};
+	};
+
+	using FCounters = TFunctionCounters<uint64>;
+
+	FORCEINLINE uint64 Load(const std::atomic<uint64>& Counter)
+	{
+		return Counter.load(std::memory_order_relaxed);
+	}
+
+	/** 分片只由所属线程写入, 普通的读加写即可, 不需要带锁前缀的原子加法. */
+	FORCEINLINE void Add(std::atomic<uint64>& Counter, uint64 Value)
+	{
+		Counter.store(Counter.load(std::memory_order_relaxed) + Value, std::memory_order_relaxed);
+	}
+
+	void Accumulate(FCounters& Total, const TFunctionCounters<std::atomic<uint64>>& Shard)
+	{
+		Total.NumCalls += Load(Shard.NumCalls);
+		Total.NumInput += Load(Shard.NumInput);
+		Total.NumOutput += Load(Shard.NumOutput);
+		Total.TotalTicks += Load(Shard.TotalTicks);
+		for (int32 Reason = 0; Reason < NumFailureReasons; ++Reason)
+		{
+			Total.Failures[Reason] += Load(Shard.Failures[Reason]);
+		}
+		for (int32 Bucket = 0; Bucket < NumLatencyBuckets; ++Bucket)
+		{
+			Total.LatencyBuckets[Bucket] += Load(Shard.LatencyBuckets[Bucket]);
+		}
+	}
+
+	void Accumulate(FCounters& Total, const FCounters& Other, bool bSubtract = false)
+	{
+		const auto Combine = [bSubtract](uint64& Value, uint64 OtherValue) { Value = bSubtract ? Value - OtherValue : Value + OtherValue; };
+		Combine(Total.NumCalls, Other.NumCalls);
+		Combine(Total.NumInput, Other.NumInput);
+		Combine(Total.NumOutput, Other.NumOutput);
+		Combine(Total.TotalTicks, Other.TotalTicks);
+		for (int32 Reason = 0; Reason < NumFailureReasons; ++Reason)
+		{
+			Combine(Total.Failures[Reason], Other.Failures[Reason]);
+		}
+		for (int32 Bucket = 0; Bucket < NumLatencyBuckets; ++Bucket)
+		{
+			Combine(Total.LatencyBuckets[Bucket], Other.LatencyBuckets[Bucket]);
+		}
+	}
+
+	/** 直方图中累计达到 Percent% 的桶的上界(周期). */
+	uint64 GetPercentile(const FCounters& Counters, uint64 Percent)
+	{
+		uint64 NumSamples = 0;
+		for (int32 Bucket = 0; Bucket < NumLatencyBuckets; ++Bucket)
+		{
+			NumSamples += Counters.LatencyBuckets[Bucket];
+		}
+		if (NumSamples == 0)
+		{
+			return 0;
+		}
+		const uint64 Target = (NumSamples * Percent + 99) / 100;
+		uint64 Seen = 0;
+		for (int32 Bucket = 0; Bucket < NumLatencyBuckets; ++Bucket)
+		{
+			Seen += Counters.LatencyBuckets[Bucket];
+			if (Seen >= Target)
+			{
+				return (uint64)1 << (Bucket + 1);
+			}
+		}
+		return (uint64)1 << NumLatencyBuckets;
+	}
+}
+
+/** 每个线程一份的计数, 第一次统计时注册, 线程退出时并入已退出线程的合计. */
+struct UnrealUtils::Common::Stats::FThreadShard
+{
+	TFunctionCounters<std::atomic<uint64>> Functions[NumFunctions];
+
+	/** 当前正在统计的调用, 没有时为 INDEX_NONE. 只由所属线程访问. */
+	int32 ActiveFunction = INDEX_NONE;
+	int32 ActiveFailure = INDEX_NONE;
+
+	FThreadShard();
+	~FThreadShard();
+};
+
+namespace
+{
+	struct FStatsRegistry
+	{
+		FCriticalSection Lock;
+		TArray<UnrealUtils::Common::Stats::FThreadShard*> Shards;
+		FCounters Retired[NumFunctions];
+		FCounters Baseline[NumFunctions];
+
+		/** 换算时钟频率的起点. */
+		const double StartSeconds = FPlatformTime::Seconds();
+		const uint64 StartTicks = ReadTicks();
+
+		double GetNanosecondsPerTick() const
+		{
+#if ECRYPTION_WITH_X86_INTRINSICS
+			double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+			while (ElapsedSeconds < MinCalibrationSeconds)
+			{
+				FPlatformProcess::Sleep(MinCalibrationSeconds);
+				ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+			}
+			return ElapsedSeconds * 1e9 / (double)FMath::Max<uint64>(ReadTicks() - StartTicks, 1);
+#else
+			return FPlatformTime::GetSecondsPerCycle64() * 1e9;
+#endif
+		}
+
+		/** 在锁内调用. 当前所有计数的合计, 没有减去 Baseline. */
+		void Sum(FCounters (&OutTotals)[NumFunctions]) const
+		{
+			for (int32 Function = 0; Function < NumFunctions; ++Function)
+			{
+				OutTotals[Function] = Retired[Function];
+				for (const UnrealUtils::Common::Stats::FThreadShard* Shard : Shards)
+				{
+					Accumulate(OutTotals[Function], Shard->Functions[Function]);
+				}
+			}
+		}
+	};
+
+	/** 线程可能在静态对象析构之后才退出, 注册表有意不释放. */
+	FStatsRegistry& GetRegistry()
+	{
+		static FStatsRegistry* Registry = new FStatsRegistry();
+		return *Registry;
+	}
+
+	UnrealUtils::Common::Stats::FThreadShard& GetThreadShard()
+	{
+		static thread_local UnrealUtils::Common::Stats::FThreadShard Shard;
+		return Shard;
+	}
+}
+
+UnrealUtils::Common::Stats::FThreadShard::FThreadShard()
+{
+	FStatsRegistry& Registry = GetRegistry();
+	FScopeLock ScopeLock(&Registry.Lock);
+	Registry.Shards.Add(this);
+}
+
+UnrealUtils::Common::Stats::FThreadShard::~FThreadShard()
+{
+	FStatsRegistry& Registry = GetRegistry();
+	FScopeLock ScopeLock(&Registry.Lock);
+	for (int32 Function = 0; Function < NumFunctions; ++Function)
+	{
+		Accumulate(Registry.Retired[Function], Functions[Function]);
+	}
+	Registry.Shards.RemoveSingleSwap(this);
+}
+
+UnrealUtils::Common::Stats::FScopedCall::FScopedCall(EFunction Function, int64 InNumInput)
+	: Shard(nullptr)
+	, StartTicks(0)
+	, NumOutput(0)
+	, bSucceeded(false)
+{
+	if (!bStatsEnabled)
+	{
+		return;
+	}
+	FThreadShard& ThreadShard = GetThreadShard();
+	if (ThreadShard.ActiveFunction != INDEX_NONE)
+	{
+		return;
+	}
+	Shard = &ThreadShard;
+	Shard->ActiveFunction = (int32)Function;
+	Shard->ActiveFailure = INDEX_NONE;
+
+	TFunctionCounters<std::atomic<uint64>>& Counters = Shard->Functions[(int32)Function];
+	Add(Counters.NumCalls, 1);
+	Add(Counters.NumInput, (uint64)FMath::Max<int64>(InNumInput, 0));
+	StartTicks = ReadTicks();
+}
+
+UnrealUtils::Common::Stats::FScopedCall::~FScopedCall()
+{
+	if (Shard == nullptr)
+	{
+		return;
+	}
+	const uint64 Ticks = ReadTicks() - StartTicks;
+	const int32 Bucket = FMath::Min((int32)FMath::FloorLog2_64(Ticks), NumLatencyBuckets - 1);
+
+	TFunctionCounters<std::atomic<uint64>>& Counters = Shard->Functions[Shard->ActiveFunction];
+	Add(Counters.TotalTicks, Ticks);
+	Add(Counters.LatencyBuckets[Bucket], 1);
+	if (Shard->ActiveFailure == INDEX_NONE && !bSucceeded)
+	{
+		Shard->ActiveFailure = (int32)EFailure::InvalidArgument;
+	}
+	if (Shard->ActiveFailure != INDEX_NONE)
+	{
+		Add(Counters.Failures[Shard->ActiveFailure], 1);
+	}
+	else
+	{
+		Add(Counters.NumOutput, (uint64)NumOutput);
+	}
+	Shard->ActiveFunction = INDEX_NONE;
+}
+
+void UnrealUtils::Common::Stats::FScopedCall::Succeed(int64 InNumOutput)
+{
+	NumOutput = FMath::Max<int64>(InNumOutput, 0);
+	bSucceeded = true;
+}
+
+void UnrealUtils::Common::Stats::RecordFailure(EFailure Reason)
+{
+	FThreadShard& Shard = GetThreadShard();
+	if (Shard.ActiveFunction != INDEX_NONE && Shard.ActiveFailure == INDEX_NONE)
+	{
+		Shard.ActiveFailure = (int32)Reason;
+	}
+}
+
+FString UnrealUtils::Common::Stats::GetSnapshotJson()
+{
+	FCounters Totals[NumFunctions];
+	double NanosecondsPerTick = 0.0;
+	{
+		FStatsRegistry& Registry = GetRegistry();
+		NanosecondsPerTick = Registry.GetNanosecondsPerTick();
+		FScopeLock ScopeLock(&Registry.Lock);
+		Registry.Sum(Totals);
+		for (int32 Function = 0; Function < NumFunctions; ++Function)
+		{
+			Accumulate(Totals[Function], Registry.Baseline[Function], true);
+		}
+	}
+
+	FString Json = TEXT("{\n  \"functions\": {\n");
+	for (int32 Function = 0; Function < NumFunctions; ++Function)
+	{
+		const FCounters& Counters = Totals[Function];
+		uint64 NumFailures = 0;
+		FString Failures;
+		for (int32 Reason = 0; Reason < NumFailureReasons; ++Reason)
+		{
+			NumFailures += Counters.Failures[Reason];
+			Failures += FString::Printf(TEXT("%s\"%s\": %llu"), Reason > 0 ? TEXT(", ") : TEXT(""), FailureNames[Reason], Counters.Failures[Reason]);
+		}
+
+		const auto ToNanoseconds = [NanosecondsPerTick](uint64 Ticks) { return (uint64)((double)Ticks * NanosecondsPerTick + 0.5); };
+
+		/** 只列出非空的桶, le 是桶的上界(纳秒). */
+		FString Buckets;
+		for (int32 Bucket = 0; Bucket < NumLatencyBuckets; ++Bucket)
+		{
+			if (Counters.LatencyBuckets[Bucket] != 0)
+			{
+				Buckets += FString::Printf(TEXT("%s{\"le\": %llu, \"count\": %llu}"), Buckets.IsEmpty() ? TEXT("") : TEXT(", "),
+					ToNanoseconds((uint64)1 << (Bucket + 1)), Counters.LatencyBuckets[Bucket]);
+			}
+		}
+
+		Json += FString::Printf(TEXT("    \"%s\": {\"calls\": %llu, \"failures\": %llu, \"input\": %llu, \"output\": %llu, \"failures_by_reason\": {%s}, ")
+			TEXT("\"latency_ns\": {\"total\": %llu, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"buckets\": [%s]}}%s\n"),
+			FunctionNames[Function], Counters.NumCalls, NumFailures, Counters.NumInput, Counters.NumOutput, *Failures,
+			ToNanoseconds(Counters.TotalTicks), ToNanoseconds(GetPercentile(Counters, 50)), ToNanoseconds(GetPercentile(Counters, 90)), ToNanoseconds(GetPercentile(Counters, 99)), *Buckets,
+			Function + 1 < NumFunctions ? TEXT(",") : TEXT(""));
+	}
+	Json += TEXT("  }\n}\n");
+	return Json;
+}
+
+void UnrealUtils::Common::Stats::Reset()
+{
+	/** 分片只能由所属线程写入, 这里记下当前的合计作为起点, 快照时减去. */
+	FStatsRegistry& Registry = GetRegistry();
+	FScopeLock ScopeLock(&Registry.Lock);
+	Registry.Sum(Registry.Baseline);
+}
+
+static FAutoConsoleCommand StatsDumpCommand(
+	TEXT("Ecryption.Stats.Dump"),
+	TEXT("Logs the Ecryption call counters and latency histograms as JSON, or writes them to the given path."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FString Json = UnrealUtils::Common::Stats::GetSnapshotJson();
+		if (Args.Num() == 0)
+		{
+			UE_LOG(LogEcryptionStats, Display, TEXT("%s"), *Json);
+		}
+		else if (FFileHelper::SaveStringToFile(Json, *Args[0]))
+		{
+			UE_LOG(LogEcryptionStats, Display, TEXT("Ecryption stats written to %s"), *Args[0]);
+		}
+		else
+		{
+			UE_LOG(LogEcryptionStats, Error, TEXT("Unable to write Ecryption stats to %s"), *Args[0]);
+		}
+	}));
+
+static FAutoConsoleCommand StatsResetCommand(
+	TEXT("Ecryption.Stats.Reset"),
+	TEXT("Restarts the Ecryption call counters and latency histograms from zero."),
+	FConsoleCommandDelegate::CreateStatic(&UnrealUtils::Common::Stats::Reset));
@@ -0,0 +1,83 @@
+// EcryptionStats.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /**
+         * 加解密函数的运行时统计: 调用次数, 输入/输出大小, 按原因分类的失败次数以及按 2 的幂分桶的耗时直方图.
+         * 每个线程写自己的分片, 不加锁也没有原子的读改写, 记录一次只需几纳秒; 读取快照时才汇总所有分片.
+         * 控制台变量 Ecryption.Stats.Enabled 可以关闭统计. 控制台命令: Ecryption.Stats.Dump [OutputPath], Ecryption.Stats.Reset
+         */
+        namespace Stats
+        {
+            /** 被统计的函数. 各个重载计入同一项, 例如 EncryptGCM 也包括 EncryptGCMBase64. */
+            enum class EFunction : uint8
+            {
+                Encrypt,
+                Decrypt,
+                EncryptBase64,
+                DecryptBase64,
+                EncryptCTR,
+                DecryptCTR,
+                EncryptGCM,
+                DecryptGCM,
+                Num,
+            };
+
+            /** 失败的原因. */
+            enum class EFailure : uint8
+            {
+                /** 空输入, 无效密钥, 输入过大等调用方的错误, 以及其他没有归类的失败. */
+                InvalidArgument,
+                /** 长度或字符无效, 无法还原为密文. */
+                MalformedInput,
+                /** 解密后既不是信封格式也不是旧的垃圾符号格式, 或带有未知的信封标记. */
+                InvalidEnvelope,
+                /** 负载的 UTF-8 或压缩数据损坏. */
+                CorruptPayload,
+                /** GCM 认证标签不符. */
+                AuthenticationFailed,
+                Num,
+            };
+
+            struct FThreadShard;
+
+            /**
+             * 在函数入口构造, 析构时记录耗时. 成功时调用 Succeed 给出输出大小, 没有调用时计为失败.
+             * 同一线程上嵌套的调用(例如一个重载转发到另一个)只统计最外层.
+             * 大小按元素计: 字节数组按字节, 字符串按字符.
+             */
+            class FScopedCall
+            {
+            public:
+                FScopedCall(EFunction Function, int64 NumInput);
+                ~FScopedCall();
+
+                void Succeed(int64 NumOutput);
+
+            private:
+                FScopedCall(const FScopedCall&) = delete;
+                FScopedCall& operator=(const FScopedCall&) = delete;
+
+                FThreadShard* Shard;
+                uint64 StartTicks;
+                int64 NumOutput;
+                bool bSucceeded;
+            };
+
+            /** 把当前线程上正在统计的调用记为失败, 一次调用只记录最先给出的原因. 不在统计中的调用忽略. */
+            void RecordFailure(EFailure Reason);
+
+            /** 汇总所有线程(包括已退出的线程)自上次 Reset 以来的统计, 以 JSON 返回. */
+            FString GetSnapshotJson();
+
+            /** 之后的快照从零开始计. */
+            void Reset();
+        }
+    }
+}
@@ -0,0 +1,207 @@
+#include "EcryptionStream.h"
+#include "EcryptionEnvelope.h"
+#include "EcryptionStats.h"
+
+namespace
+{
+	static constexpr int32 BlockSize = FAES::AESBlockSize;
+}
+
+UnrealUtils::Common::FEncryptContext::FEncryptContext(const FPreparedAESKey& InKey, int32 InPayloadSize)
+	: Key(InKey)
+	, NumPending(Envelope::HeaderSize)
+	, PayloadSize(InPayloadSize)
+	, NumPayloadWritten(0)
+	, bFailed(false)
+	, bFinished(false)
+{
+	bFailed = !ensure(PayloadSize > 0) || !ensure(Key.IsValid());
+
+	/** 信封头占第一个块的前 12 字节, 和后面的负载一起加密. */
+	Envelope::WriteHeader(Pending, 0, FMath::Max(PayloadSize, 0));
+}
+
+UnrealUtils::Common::FEncryptContext::FEncryptContext(const FAES::FAESKey& InKey, int32 InPayloadSize)
+	: FEncryptContext(FPreparedAESKey(InKey), InPayloadSize)
+{
+}
+
+UnrealUtils::Common::FEncryptContext::~FEncryptContext()
+{
+	FMemory::Memzero(Pending, sizeof(Pending));
+}
+
+bool UnrealUtils::Common::FEncryptContext::Update(TArrayView<const uint8> Input, TArray<uint8>& OutCipher)
+{
+	if (bFailed || !ensure(!bFinished)) { return false; }
+	if (!ensureMsgf(Input.Num() <= PayloadSize - NumPayloadWritten, TEXT("More payload than declared was passed to FEncryptContext.")))
+	{
+		bFailed = true;
+		return false;
+	}
+	NumPayloadWritten += Input.Num();
+
+	const uint8* Data = Input.GetData();
+	int32 Num = Input.Num();
+
+	/** 先补满上次剩下的不完整块. */
+	if (NumPending > 0)
+	{
+		const int32 NumCopy = FMath::Min(BlockSize - NumPending, Num);
+		FMemory::Memcpy(Pending + NumPending, Data, NumCopy);
+		NumPending += NumCopy;
+		Data += NumCopy;
+		Num -= NumCopy;
+		if (NumPending < BlockSize)
+		{
+			return true;
+		}
+		EmitBlocks(Pending, BlockSize, OutCipher);
+		NumPending = 0;
+	}
+
+	/** 整块直接从输入加密到输出, 尾巴留到下次. */
+	const int32 NumFullBytes = Num & ~(BlockSize - 1);
+	if (NumFullBytes > 0)
+	{
+		EmitBlocks(Data, NumFullBytes, OutCipher);
+	}
+	NumPending = Num - NumFullBytes;
+	FMemory::Memcpy(Pending, Data + NumFullBytes, NumPending);
+	return true;
+}
+
+bool UnrealUtils::Common::FEncryptContext::Final(TArray<uint8>& OutCipher)
+{
+	if (bFailed || !ensure(!bFinished)) { return false; }
+	bFinished = true;
+	if (!ensureMsgf(NumPayloadWritten == PayloadSize, TEXT("FEncryptContext received %d bytes but %d were declared."), NumPayloadWritten, PayloadSize))
+	{
+		return false;
+	}
+
+	/** 补零到 16 的倍数. */
+	if (NumPending > 0)
+	{
+		FMemory::Memzero(Pending + NumPending, BlockSize - NumPending);
+		EmitBlocks(Pending, BlockSize, OutCipher);
+		NumPending = 0;
+	}
+	return true;
+}
+
+void UnrealUtils::Common::FEncryptContext::EmitBlocks(const uint8* Blocks, int32 NumBytes, TArray<uint8>& OutCipher)
+{
+	const int32 Offset = OutCipher.Num();
+	OutCipher.AddUninitialized(NumBytes);
+	FMemory::Memcpy(OutCipher.GetData() + Offset, Blocks, NumBytes);
+	AESKernel::EncryptData(OutCipher.GetData() + Offset, NumBytes, Key);
+}
+
+UnrealUtils::Common::FDecryptContext::FDecryptContext(const FPreparedAESKey& InKey)
+	: Key(InKey)
+	, NumPending(0)
+	, NumCipherRead(0)
+	, PayloadSize(0)
+	, bHeaderRead(false)
+	, bFailed(false)
+	, bFinished(false)
+{
+	bFailed = !ensure(Key.IsValid());
+}
+
+UnrealUtils::Common::FDecryptContext::FDecryptContext(const FAES::FAESKey& InKey)
+	: FDecryptContext(FPreparedAESKey(InKey))
+{
+}
+
+UnrealUtils::Common::FDecryptContext::~FDecryptContext()
+{
+	FMemory::Memzero(Pending, sizeof(Pending));
+}
+
+bool UnrealUtils::Common::FDecryptContext::Update(TArrayView<const uint8> Input, TArray<uint8>& OutBytes)
+{
+	if (bFailed || !ensure(!bFinished)) { return false; }
+
+	const uint8* Data = Input.GetData();
+	int32 Num = Input.Num();
+
+	if (NumPending > 0)
+	{
+		const int32 NumCopy = FMath::Min(BlockSize - NumPending, Num);
+		FMemory::Memcpy(Pending + NumPending, Data, NumCopy);
+		NumPending += NumCopy;
+		Data += NumCopy;
+		Num -= NumCopy;
+		if (NumPending < BlockSize)
+		{
+			return true;
+		}
+		NumPending = 0;
+		if (!EmitBlocks(Pending, BlockSize, OutBytes)) { return false; }
+	}
+
+	const int32 NumFullBytes = Num & ~(BlockSize - 1);
+	if (NumFullBytes > 0 && !EmitBlocks(Data, NumFullBytes, OutBytes)) { return false; }
+	NumPending = Num - NumFullBytes;
+	FMemory::Memcpy(Pending, Data + NumFullBytes, NumPending);
+	return true;
+}
+
+bool UnrealUtils::Common::FDecryptContext::Final(TArray<uint8>&)
+{
+	if (bFailed || !ensure(!bFinished)) { return false; }
+	bFinished = true;
+
+	/** 密文被截断. */
+	if (NumPending != 0 || !bHeaderRead || NumCipherRead != Envelope::GetSealedSize(PayloadSize))
+	{
+		Stats::RecordFailure(Stats::EFailure::MalformedInput);
+		return false;
+	}
+	return true;
+}
+
+bool UnrealUtils::Common::FDecryptContext::EmitBlocks(const uint8* Blocks, int32 NumBytes, TArray<uint8>& OutBytes)
+{
+	const int32 Offset = OutBytes.Num();
+	OutBytes.AddUninitialized(NumBytes);
+	uint8* Plain = OutBytes.GetData() + Offset;
+	FMemory::Memcpy(Plain, Blocks, NumBytes);
+	AESKernel::DecryptData(Plain, NumBytes, Key);
+
+	if (!bHeaderRead)
+	{
+		uint8 Flags = 0;
+		/** 压缩过的消息不能分段解出, 只能交给一次性的 Decrypt. */
+		if (!Envelope::ReadHeader(Plain, Flags, PayloadSize) || (Flags & (~Envelope::KnownFlags | Envelope::FlagCompressed)) != 0)
+		{
+			Stats::RecordFailure(Stats::EFailure::InvalidEnvelope);
+			bFailed = true;
+		}
+		bHeaderRead = true;
+	}
+	if (!bFailed && NumBytes > Envelope::GetSealedSize(PayloadSize) - NumCipherRead)
+	{
+		Stats::RecordFailure(Stats::EFailure::MalformedInput);
+		bFailed = true;
+	}
+	if (bFailed)
+	{
+		FMemory::Memzero(Plain, NumBytes);
+		OutBytes.SetNum(Offset, false);
+		return false;
+	}
+
+	/** 只保留落在 [HeaderSize, HeaderSize + PayloadSize) 中的部分. */
+	const int32 Begin = FMath::Clamp(Envelope::HeaderSize - NumCipherRead, 0, NumBytes);
+	const int32 End = FMath::Clamp(Envelope::HeaderSize + PayloadSize - NumCipherRead, Begin, NumBytes);
+	if (Begin > 0 && End > Begin)
+	{
+		FMemory::Memmove(Plain, Plain + Begin, End - Begin);
+	}
+	OutBytes.SetNum(Offset + End - Begin, false);
+	NumCipherRead += NumBytes;
+	return true;
+}
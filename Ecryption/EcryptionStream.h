@@ -0,0 +1,76 @@
+// EcryptionStream.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EcryptionAES.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /**
+         * 分段加密. 输出与一次性调用 Encrypt(TArrayView<const uint8>, ...) 的结果完全相同.
+         * 信封头在最前面, 所以构造时就需要知道负载的总大小; 除了不足一个块的尾巴外不缓存任何数据,
+         * 工作内存与负载总大小无关. 每次 Update/Final 把新产生的密文追加到 OutCipher 末尾,
+         * 调用方写出后可以 Reset 再继续复用.
+         */
+        class FEncryptContext
+        {
+        public:
+            FEncryptContext(const FPreparedAESKey& InKey, int32 InPayloadSize);
+            FEncryptContext(const FAES::FAESKey& InKey, int32 InPayloadSize);
+            ~FEncryptContext();
+
+            /** 追加一段负载. 超出构造时声明的大小, 失败过或已经 Final 后返回 false. */
+            bool Update(TArrayView<const uint8> Input, TArray<uint8>& OutCipher);
+
+            /** 补零并输出最后一个块. 实际写入的负载大小与声明的不一致时返回 false. */
+            bool Final(TArray<uint8>& OutCipher);
+
+        private:
+            /** 加密整块数据并追加到 OutCipher. */
+            void EmitBlocks(const uint8* Blocks, int32 NumBytes, TArray<uint8>& OutCipher);
+
+            FPreparedAESKey Key;
+            uint8 Pending[FAES::AESBlockSize];
+            int32 NumPending;
+            int32 PayloadSize;
+            int32 NumPayloadWritten;
+            bool bFailed;
+            bool bFinished;
+        };
+
+        /**
+         * 分段解密, 对应 FEncryptContext 和 Encrypt(TArrayView<const uint8>, ...) 的输出.
+         * 密文可以按任意大小切分, 每次 Update/Final 把新得到的负载追加到 OutBytes 末尾.
+         * 旧的垃圾符号格式必须看到全部明文才能找到结尾, 压缩过的负载也必须整体解压, 这两种都不支持分段解密.
+         */
+        class FDecryptContext
+        {
+        public:
+            explicit FDecryptContext(const FPreparedAESKey& InKey);
+            explicit FDecryptContext(const FAES::FAESKey& InKey);
+            ~FDecryptContext();
+
+            /** 追加一段密文. 信封头无效, 密文超出信封声明的大小或已经 Final 后返回 false. */
+            bool Update(TArrayView<const uint8> Input, TArray<uint8>& OutBytes);
+
+            /** 确认密文完整. 密文被截断时返回 false. */
+            bool Final(TArray<uint8>& OutBytes);
+
+        private:
+            /** 解密整块数据, 去掉信封头和补零后追加到 OutBytes. */
+            bool EmitBlocks(const uint8* Blocks, int32 NumBytes, TArray<uint8>& OutBytes);
+
+            FPreparedAESKey Key;
+            uint8 Pending[FAES::AESBlockSize];
+            int32 NumPending;
+            int32 NumCipherRead;
+            int32 PayloadSize;
+            bool bHeaderRead;
+            bool bFailed;
+            bool bFinished;
+        };
+    }
+}
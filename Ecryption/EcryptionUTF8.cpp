@@ -0,0 +1,299 @@
+#include "EcryptionUTF8.h"
+#include "EcryptionCPU.h"
+
+#if ECRYPTION_WITH_X86_INTRINSICS
+	#include <emmintrin.h>
+#endif
+
+namespace
+{
+	/** 向量化路径每次处理的字符数. */
+	static constexpr int32 NumVectorChars = 16;
+
+	static constexpr uint32 ReplacementCharacter = 0xFFFD;
+
+	FORCEINLINE bool IsHighSurrogate(uint32 CodeUnit) { return CodeUnit >= 0xD800 && CodeUnit <= 0xDBFF; }
+	FORCEINLINE bool IsLowSurrogate(uint32 CodeUnit) { return CodeUnit >= 0xDC00 && CodeUnit <= 0xDFFF; }
+	FORCEINLINE bool IsContinuation(uint8 Byte) { return (Byte & 0xC0) == 0x80; }
+
+	/** 读取 Chars[Index] 开始的一个码点, 返回用掉的字符数. UTF-16 的孤立代理项读作 U+FFFD. */
+	FORCEINLINE int32 ReadCodePoint(const TCHAR* Chars, int32 Index, int32 NumChars, uint32& OutCodePoint)
+	{
+		const uint32 CodeUnit = (uint32)Chars[Index];
+		if (sizeof(TCHAR) == 2)
+		{
+			if (IsHighSurrogate(CodeUnit) && Index + 1 < NumChars && IsLowSurrogate((uint32)Chars[Index + 1]))
+			{
+				OutCodePoint = 0x10000 + ((CodeUnit - 0xD800) << 10) + ((uint32)Chars[Index + 1] - 0xDC00);
+				return 2;
+			}
+			OutCodePoint = IsHighSurrogate(CodeUnit) || IsLowSurrogate(CodeUnit) ? ReplacementCharacter : CodeUnit;
+			return 1;
+		}
+		OutCodePoint = (CodeUnit >= 0xD800 && CodeUnit <= 0xDFFF) || CodeUnit > 0x10FFFF ? ReplacementCharacter : CodeUnit;
+		return 1;
+	}
+
+	FORCEINLINE int32 GetCodePointSize(uint32 CodePoint)
+	{
+		return CodePoint < 0x80 ? 1 : CodePoint < 0x800 ? 2 : CodePoint < 0x10000 ? 3 : 4;
+	}
+
+	FORCEINLINE int32 WriteCodePoint(uint32 CodePoint, uint8* OutBytes)
+	{
+		if (CodePoint < 0x80)
+		{
+			OutBytes[0] = (uint8)CodePoint;
+			return 1;
+		}
+		if (CodePoint < 0x800)
+		{
+			OutBytes[0] = (uint8)(0xC0 | (CodePoint >> 6));
+			OutBytes[1] = (uint8)(0x80 | (CodePoint & 0x3F));
+			return 2;
+		}
+		if (CodePoint < 0x10000)
+		{
+			OutBytes[0] = (uint8)(0xE0 | (CodePoint >> 12));
+			OutBytes[1] = (uint8)(0x80 | ((CodePoint >> 6) & 0x3F));
+			OutBytes[2] = (uint8)(0x80 | (CodePoint & 0x3F));
+			return 3;
+		}
+		OutBytes[0] = (uint8)(0xF0 | (CodePoint >> 18));
+		OutBytes[1] = (uint8)(0x80 | ((CodePoint >> 12) & 0x3F));
+		OutBytes[2] = (uint8)(0x80 | ((CodePoint >> 6) & 0x3F));
+		OutBytes[3] = (uint8)(0x80 | (CodePoint & 0x3F));
+		return 4;
+	}
+
+	/**
+	 * 解码 Bytes 开始的一个序列, 返回序列长度. 非法时返回 -1, 数据不够一个完整序列时返回 0.
+	 * 按 Unicode 标准表 3-7 校验第二个字节的范围, 排除过长编码, 代理项和超出 U+10FFFF 的码点.
+	 */
+	FORCEINLINE int32 ReadSequence(const uint8* Bytes, int32 NumBytes, uint32& OutCodePoint)
+	{
+		const uint8 Lead = Bytes[0];
+		int32 Size = 0;
+		uint8 SecondMin = 0x80;
+		uint8 SecondMax = 0xBF;
+		if (Lead >= 0xC2 && Lead <= 0xDF)
+		{
+			Size = 2;
+		}
+		else if (Lead >= 0xE0 && Lead <= 0xEF)
+		{
+			Size = 3;
+			SecondMin = Lead == 0xE0 ? 0xA0 : 0x80;
+			SecondMax = Lead == 0xED ? 0x9F : 0xBF;
+		}
+		else if (Lead >= 0xF0 && Lead <= 0xF4)
+		{
+			Size = 4;
+			SecondMin = Lead == 0xF0 ? 0x90 : 0x80;
+			SecondMax = Lead == 0xF4 ? 0x8F : 0xBF;
+		}
+		else
+		{
+			return -1;
+		}
+
+		/** 不完整时先检查已有的字节, 明显非法的序列不必等到下一次. */
+		const int32 NumAvailable = FMath::Min(Size, NumBytes);
+		if (NumAvailable > 1 && (Bytes[1] < SecondMin || Bytes[1] > SecondMax))
+		{
+			return -1;
+		}
+		for (int32 Index = 2; Index < NumAvailable; ++Index)
+		{
+			if (!IsContinuation(Bytes[Index]))
+			{
+				return -1;
+			}
+		}
+		if (NumAvailable < Size)
+		{
+			return 0;
+		}
+
+		uint32 CodePoint = Lead & (0x7F >> Size);
+		for (int32 Index = 1; Index < Size; ++Index)
+		{
+			CodePoint = (CodePoint << 6) | (Bytes[Index] & 0x3F);
+		}
+		OutCodePoint = CodePoint;
+		return Size;
+	}
+
+	/** 写出一个码点, 返回写入的字符数. */
+	FORCEINLINE int32 WriteChars(uint32 CodePoint, TCHAR* OutChars)
+	{
+		if (sizeof(TCHAR) == 2 && CodePoint >= 0x10000)
+		{
+			CodePoint -= 0x10000;
+			OutChars[0] = (TCHAR)(0xD800 + (CodePoint >> 10));
+			OutChars[1] = (TCHAR)(0xDC00 + (CodePoint & 0x3FF));
+			return 2;
+		}
+		OutChars[0] = (TCHAR)CodePoint;
+		return 1;
+	}
+
+#if ECRYPTION_WITH_X86_INTRINSICS
+	/** 从头开始的纯 ASCII 部分窄化为字节, 每次 16 个字符, 返回处理的字符数. 仅用于 2 字节的 TCHAR. */
+	ECRYPTION_TARGET("sse2") int32 EncodeASCIISSE2(const TCHAR* Chars, int32 NumChars, uint8* OutBytes)
+	{
+		const __m128i NonASCIIMask = _mm_set1_epi16((int16)0xFF80);
+		int32 Index = 0;
+		for (; Index + NumVectorChars <= NumChars; Index += NumVectorChars)
+		{
+			const __m128i Low = _mm_loadu_si128((const __m128i*)(Chars + Index));
+			const __m128i High = _mm_loadu_si128((const __m128i*)(Chars + Index + 8));
+			const __m128i NonASCII = _mm_and_si128(_mm_or_si128(Low, High), NonASCIIMask);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(NonASCII, _mm_setzero_si128())) != 0xFFFF)
+			{
+				break;
+			}
+			_mm_storeu_si128((__m128i*)(OutBytes + Index), _mm_packus_epi16(Low, High));
+		}
+		return Index;
+	}
+
+	/** 从头开始的纯 ASCII 部分的长度, 每次 16 个字符. 仅用于 2 字节的 TCHAR. */
+	ECRYPTION_TARGET("sse2") int32 CountASCIISSE2(const TCHAR* Chars, int32 NumChars)
+	{
+		const __m128i NonASCIIMask = _mm_set1_epi16((int16)0xFF80);
+		int32 Index = 0;
+		for (; Index + NumVectorChars <= NumChars; Index += NumVectorChars)
+		{
+			const __m128i Low = _mm_loadu_si128((const __m128i*)(Chars + Index));
+			const __m128i High = _mm_loadu_si128((const __m128i*)(Chars + Index + 8));
+			const __m128i NonASCII = _mm_and_si128(_mm_or_si128(Low, High), NonASCIIMask);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(NonASCII, _mm_setzero_si128())) != 0xFFFF)
+			{
+				break;
+			}
+		}
+		return Index;
+	}
+
+	/** 从头开始的纯 ASCII 部分扩展为字符, 每次 16 字节, 返回处理的字节数. 仅用于 2 字节的 TCHAR. */
+	ECRYPTION_TARGET("sse2") int32 DecodeASCIISSE2(const uint8* Bytes, int32 NumBytes, TCHAR* OutChars)
+	{
+		const __m128i Zero = _mm_setzero_si128();
+		int32 Index = 0;
+		for (; Index + NumVectorChars <= NumBytes; Index += NumVectorChars)
+		{
+			const __m128i Input = _mm_loadu_si128((const __m128i*)(Bytes + Index));
+			if (_mm_movemask_epi8(Input) != 0)
+			{
+				break;
+			}
+			_mm_storeu_si128((__m128i*)(OutChars + Index), _mm_unpacklo_epi8(Input, Zero));
+			_mm_storeu_si128((__m128i*)(OutChars + Index + 8), _mm_unpackhi_epi8(Input, Zero));
+		}
+		return Index;
+	}
+#endif
+}
+
+int32 UnrealUtils::Common::UTF8::GetMaxEncodedSize(int32 NumChars)
+{
+	/** UTF-16 每个代码单元最多 3 字节(代理对 2 个单元共 4 字节), UTF-32 每个码点最多 4 字节. */
+	return NumChars * (sizeof(TCHAR) == 2 ? 3 : 4);
+}
+
+int32 UnrealUtils::Common::UTF8::GetEncodedSize(const TCHAR* Chars, int32 NumChars)
+{
+	int32 Size = 0;
+	int32 Index = 0;
+	while (Index < NumChars)
+	{
+#if ECRYPTION_WITH_X86_INTRINSICS
+		if (sizeof(TCHAR) == 2)
+		{
+			const int32 NumASCII = CountASCIISSE2(Chars + Index, NumChars - Index);
+			Index += NumASCII;
+			Size += NumASCII;
+		}
+#endif
+		/** 向量化路径停下的这一组逐个处理, 之后再回到向量化路径. */
+		const int32 ScalarEnd = FMath::Min(NumChars, Index + NumVectorChars);
+		while (Index < ScalarEnd)
+		{
+			uint32 CodePoint = 0;
+			Index += ReadCodePoint(Chars, Index, NumChars, CodePoint);
+			Size += GetCodePointSize(CodePoint);
+		}
+	}
+	return Size;
+}
+
+int32 UnrealUtils::Common::UTF8::Encode(const TCHAR* Chars, int32 NumChars, uint8* OutBytes)
+{
+	int32 NumWritten = 0;
+	int32 Index = 0;
+	while (Index < NumChars)
+	{
+#if ECRYPTION_WITH_X86_INTRINSICS
+		if (sizeof(TCHAR) == 2)
+		{
+			const int32 NumASCII = EncodeASCIISSE2(Chars + Index, NumChars - Index, OutBytes + NumWritten);
+			Index += NumASCII;
+			NumWritten += NumASCII;
+		}
+#endif
+		const int32 ScalarEnd = FMath::Min(NumChars, Index + NumVectorChars);
+		while (Index < ScalarEnd)
+		{
+			uint32 CodePoint = 0;
+			Index += ReadCodePoint(Chars, Index, NumChars, CodePoint);
+			NumWritten += WriteCodePoint(CodePoint, OutBytes + NumWritten);
+		}
+	}
+	return NumWritten;
+}
+
+bool UnrealUtils::Common::UTF8::Decode(const uint8* Bytes, int32 NumBytes, TCHAR* OutChars, int32& OutNumChars, int32& OutNumConsumed, bool bFinal)
+{
+	int32 NumWritten = 0;
+	int32 Index = 0;
+	while (Index < NumBytes)
+	{
+#if ECRYPTION_WITH_X86_INTRINSICS
+		if (sizeof(TCHAR) == 2)
+		{
+			const int32 NumASCII = DecodeASCIISSE2(Bytes + Index, NumBytes - Index, OutChars + NumWritten);
+			Index += NumASCII;
+			NumWritten += NumASCII;
+		}
+#endif
+		const int32 ScalarEnd = FMath::Min(NumBytes, Index + NumVectorChars);
+		while (Index < ScalarEnd)
+		{
+			if (Bytes[Index] < 0x80)
+			{
+				OutChars[NumWritten++] = (TCHAR)Bytes[Index++];
+				continue;
+			}
+
+			uint32 CodePoint = 0;
+			const int32 SequenceSize = ReadSequence(Bytes + Index, NumBytes - Index, CodePoint);
+			if (SequenceSize < 0 || (SequenceSize == 0 && bFinal))
+			{
+				return false;
+			}
+			if (SequenceSize == 0)
+			{
+				/** 末尾不完整的序列留给下一次. */
+				OutNumChars = NumWritten;
+				OutNumConsumed = Index;
+				return true;
+			}
+			Index += SequenceSize;
+			NumWritten += WriteChars(CodePoint, OutChars + NumWritten);
+		}
+	}
+	OutNumChars = NumWritten;
+	OutNumConsumed = Index;
+	return true;
+}
@@ -0,0 +1,34 @@
+// EcryptionUTF8.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UnrealUtils
+{
+    namespace Common
+    {
+        /**
+         * 字符串与 UTF-8 之间的转换, 用于密文中的字符串负载.
+         * 纯 ASCII 的部分用 SSE2 每次处理 16 个字符(32 字节的 UTF-16), 只有遇到非 ASCII 字符时才逐个转换.
+         */
+        namespace UTF8
+        {
+            /** 编码 NumChars 个字符最多需要的字节数. */
+            int32 GetMaxEncodedSize(int32 NumChars);
+
+            /** 编码后的准确字节数, 不写出数据. */
+            int32 GetEncodedSize(const TCHAR* Chars, int32 NumChars);
+
+            /** 编码到 OutBytes, OutBytes 至少要有 GetMaxEncodedSize(NumChars) 字节. 孤立的代理项编码为 U+FFFD. 返回写入的字节数. */
+            int32 Encode(const TCHAR* Chars, int32 NumChars, uint8* OutBytes);
+
+            /**
+             * 校验并解码到 OutChars, OutChars 至少要有 NumBytes 个字符.
+             * bFinal 为 false 时末尾不完整的序列留给下一次调用, OutNumConsumed 返回实际用掉的字节数.
+             * 出现非法序列(过长编码, 代理项, 超出 U+10FFFF 等)时返回 false.
+             */
+            bool Decode(const uint8* Bytes, int32 NumBytes, TCHAR* OutChars, int32& OutNumChars, int32& OutNumConsumed, bool bFinal = true);
+        }
+    }
+}
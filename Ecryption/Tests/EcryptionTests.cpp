@@ -0,0 +1,1404 @@
+#include "Ecryption.h"
+#include "EcryptionAES.h"
+#include "EcryptionAsync.h"
+#include "EcryptionBase64.h"
+#include "EcryptionBatch.h"
+#include "EcryptionBlob.h"
+#include "EcryptionCache.h"
+#include "EcryptionScratch.h"
+#include "EcryptionStats.h"
+#include "EcryptionStream.h"
+#include "EcryptionUTF8.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Base64.h"
+#include "Misc/CoreDelegates.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	static constexpr uint32 EcryptionTestFlags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+	FAES::FAESKey MakeTestKey(uint8 Seed)
+	{
+		FAES::FAESKey Key;
+		for (int32 Index = 0; Index < FAES::FAESKey::KeySize; ++Index)
+		{
+			Key.Key[Index] = (uint8)(Index * 7 + Seed);
+		}
+		return Key;
+	}
+
+	/** 覆盖不足一块, 恰好一块, 多块, Latin-1, 中文以及代理对. */
+	TArray<FString> MakeTestStrings()
+	{
+		TArray<FString> Strings{};
+		Strings.Add(TEXT("a"));
+		Strings.Add(TEXT("Hello, world!"));
+		Strings.Add(TEXT("0123456789abcdef"));
+		Strings.Add(TEXT("Café crème brûlée"));
+		Strings.Add(TEXT("配置文件中的加密字段"));
+		Strings.Add(TEXT("Mixed ASCII 和中文 with emoji \U0001F600 inside"));
+		FString Long;
+		for (int32 Index = 0; Index < 5000; ++Index)
+		{
+			Long.AppendChar((TCHAR)(Index % 5 == 0 ? 0x4E00 + Index % 512 : TEXT('a') + Index % 26));
+		}
+		Strings.Add(Long);
+		return Strings;
+	}
+
+	TArray<uint8> MakeTestBytes(int32 Num, uint8 Seed)
+	{
+		TArray<uint8> Bytes{};
+		Bytes.AddUninitialized(Num);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			Bytes[Index] = (uint8)(Index * 31 + Seed);
+		}
+		return Bytes;
+	}
+
+	TArray<uint8> HexToArray(const TCHAR* Hex)
+	{
+		const FString HexString(Hex);
+		TArray<uint8> Bytes{};
+		Bytes.AddUninitialized(HexString.Len() / 2);
+		HexToBytes(HexString, Bytes.GetData());
+		return Bytes;
+	}
+
+	TArray<uint8> Concat(const TArray<uint8>& A, const TArray<uint8>& B, const TArray<uint8>& C = TArray<uint8>())
+	{
+		TArray<uint8> Result = A;
+		Result.Append(B.GetData(), B.Num());
+		Result.Append(C.GetData(), C.Num());
+		return Result;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionSpanTest, "UnrealUtils.Ecryption.Span", EcryptionTestFlags)
+bool FEcryptionSpanTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(3);
+
+	for (const FString& Plaintext : MakeTestStrings())
+	{
+		TestEqual(TEXT("Decrypt(Encrypt)"), Decrypt(Encrypt(Plaintext, Key), Key), Plaintext);
+		TestEqual(TEXT("DecryptBase64(EncryptBase64)"), DecryptBase64(EncryptBase64(Plaintext, Key), Key), Plaintext);
+
+		/** 字节形式的密文与 FString 形式之间是 BytesToString 的关系. */
+		const FString Cipher = Encrypt(Plaintext, Key);
+		TArray<uint8> CipherBytes{};
+		TestTrue(TEXT("Encrypt(FStringView)"), Encrypt(FStringView(Plaintext), Key, CipherBytes));
+		TestEqual(TEXT("Encrypt(FStringView) matches Encrypt"), BytesToString(CipherBytes.GetData(), CipherBytes.Num()), Cipher);
+
+		TArray<uint8> FromBytes{};
+		TArray<uint8> FromString{};
+		TestTrue(TEXT("Decrypt(TArrayView)"), Decrypt(TArrayView<const uint8>(CipherBytes), Key, FromBytes));
+		TestTrue(TEXT("Decrypt(FStringView)"), Decrypt(FStringView(Cipher), Key, FromString));
+		TestEqual(TEXT("Decrypt(TArrayView) matches Decrypt(FStringView)"), FromBytes, FromString);
+	}
+
+	for (int32 Size : { 1, 4, 15, 16, 17, 100, 4096, 65537 })
+	{
+		const TArray<uint8> Plaintext = MakeTestBytes(Size, (uint8)Size);
+		TArray<uint8> Cipher{};
+		TArray<uint8> Decrypted{};
+		TestTrue(TEXT("Encrypt(TArrayView)"), Encrypt(TArrayView<const uint8>(Plaintext), Key, Cipher));
+		TestTrue(TEXT("Decrypt(TArrayView)"), Decrypt(TArrayView<const uint8>(Cipher), Key, Decrypted));
+		TestEqual(FString::Printf(TEXT("Decrypt(Encrypt) of %d bytes"), Size), Decrypted, Plaintext);
+	}
+
+	/** 容量足够时直接写入调用方的缓冲区, 不重新分配. */
+	const TArray<uint8> Plaintext = MakeTestBytes(100, 1);
+	TArray<uint8> Cipher{};
+	TArray<uint8> Decrypted{};
+	Cipher.Reserve(1024);
+	Decrypted.Reserve(1024);
+	const uint8* CipherData = Cipher.GetData();
+	const uint8* DecryptedData = Decrypted.GetData();
+	TestTrue(TEXT("Encrypt into a reserved buffer"), Encrypt(TArrayView<const uint8>(Plaintext), Key, Cipher));
+	TestTrue(TEXT("Decrypt into a reserved buffer"), Decrypt(TArrayView<const uint8>(Cipher), Key, Decrypted));
+	TestTrue(TEXT("Encrypt reuses the caller's allocation"), Cipher.GetData() == CipherData);
+	TestTrue(TEXT("Decrypt reuses the caller's allocation"), Decrypted.GetData() == DecryptedData);
+	TestEqual(TEXT("Decrypt(Encrypt) in reserved buffers"), Decrypted, Plaintext);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionEnvelopeTest, "UnrealUtils.Ecryption.Envelope", EcryptionTestFlags)
+bool FEcryptionEnvelopeTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(4);
+
+	/** 12 字节的信封头加负载后补零到 16 的倍数. */
+	for (int32 Size : { 1, 4, 5, 20, 21, 100 })
+	{
+		const TArray<uint8> Plaintext = MakeTestBytes(Size, (uint8)Size);
+		TArray<uint8> Cipher{};
+		TArray<uint8> Decrypted{};
+		TestTrue(TEXT("Encrypt"), Encrypt(TArrayView<const uint8>(Plaintext), Key, Cipher));
+		TestEqual(FString::Printf(TEXT("Sealed size of %d bytes"), Size), Cipher.Num(), Align(12 + Size, FAES::AESBlockSize));
+		TestTrue(TEXT("Decrypt"), Decrypt(TArrayView<const uint8>(Cipher), Key, Decrypted));
+		TestEqual(FString::Printf(TEXT("Decrypt(Encrypt) of %d bytes"), Size), Decrypted, Plaintext);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionLegacyCiphertextTest, "UnrealUtils.Ecryption.LegacyCiphertext", EcryptionTestFlags)
+bool FEcryptionLegacyCiphertextTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+
+	/** 由旧的垃圾符号格式加密得到的密文, 密钥为 0x00..0x1f. */
+	FAES::FAESKey Key;
+	for (int32 Index = 0; Index < FAES::FAESKey::KeySize; ++Index)
+	{
+		Key.Key[Index] = (uint8)Index;
+	}
+	const FString LegacyBase64 = TEXT("QhXbSzehNoI9OQ85EOLAYegmOwuKLaqyw4SjSQopYTrsINg/oGbpE7mRVAIHeQJl5ckiL8kiamWLnvvAmWw65g==");
+	const FString Expected = TEXT("Hello, legacy world!");
+
+	TestEqual(TEXT("DecryptBase64 of a legacy ciphertext"), DecryptBase64(LegacyBase64, Key), Expected);
+
+	TArray<uint8> LegacyBytes{};
+	TestTrue(TEXT("Decode legacy Base64"), FBase64::Decode(LegacyBase64, LegacyBytes));
+	const FString LegacyString = BytesToString(LegacyBytes.GetData(), LegacyBytes.Num());
+	TestEqual(TEXT("Decrypt of a legacy ciphertext"), Decrypt(LegacyString, Key), Expected);
+
+	FEncryptedBlob Blob;
+	TestTrue(TEXT("FromBase64 of a legacy ciphertext"), FEncryptedBlob::FromBase64(FStringView(LegacyBase64), Blob));
+	TestEqual(TEXT("DecryptBlobToString of a legacy ciphertext"), DecryptBlobToString(Blob, Key), Expected);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionAESKnownAnswerTest, "UnrealUtils.Ecryption.KnownAnswer.AES", EcryptionTestFlags)
+bool FEcryptionAESKnownAnswerTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+
+	/** FIPS-197 附录 C.1 - C.3. */
+	struct FVector
+	{
+		int32 NumKeyBytes;
+		const TCHAR* Cipher;
+	};
+	const FVector Vectors[] =
+	{
+		{ 16, TEXT("69c4e0d86a7b0430d8cdb78070b4c55a") },
+		{ 24, TEXT("dda97ca4864cdfe06eaf70a0ec0d7191") },
+		{ 32, TEXT("8ea2b7ca516745bfeafc49904b496089") },
+	};
+	const TArray<uint8> Plaintext = HexToArray(TEXT("00112233445566778899aabbccddeeff"));
+	uint8 KeyBytes[32];
+	for (int32 Index = 0; Index < 32; ++Index)
+	{
+		KeyBytes[Index] = (uint8)Index;
+	}
+
+	for (const FVector& Vector : Vectors)
+	{
+		const FPreparedAESKey Key(KeyBytes, Vector.NumKeyBytes);
+		if (!Key.IsValid())
+		{
+			/** 没有 AES-NI 时只支持 AES-256. */
+			AddInfo(FString::Printf(TEXT("AES-%d is not supported without AES-NI, skipped."), Vector.NumKeyBytes * 8));
+			continue;
+		}
+
+		/** 多块同时处理时走展开后的流水线, 每块都要与向量一致. */
+		const TArray<uint8> Expected = HexToArray(Vector.Cipher);
+		for (int32 NumBlocks : { 1, 3, 8, 9 })
+		{
+			TArray<uint8> Blocks{};
+			TArray<uint8> ExpectedBlocks{};
+			for (int32 Block = 0; Block < NumBlocks; ++Block)
+			{
+				Blocks.Append(Plaintext.GetData(), Plaintext.Num());
+				ExpectedBlocks.Append(Expected.GetData(), Expected.Num());
+			}
+			AESKernel::EncryptData(Blocks.GetData(), Blocks.Num(), Key);
+			TestEqual(FString::Printf(TEXT("AES-%d encrypt x%d"), Vector.NumKeyBytes * 8, NumBlocks), Blocks, ExpectedBlocks);
+			AESKernel::DecryptData(Blocks.GetData(), Blocks.Num(), Key);
+			TestEqual(FString::Printf(TEXT("AES-%d decrypt x%d"), Vector.NumKeyBytes * 8, NumBlocks), Blocks[0], Plaintext[0]);
+			TestEqual(FString::Printf(TEXT("AES-%d decrypt x%d"), Vector.NumKeyBytes * 8, NumBlocks), TArray<uint8>(Blocks.GetData() + Blocks.Num() - 16, 16), Plaintext);
+		}
+	}
+
+	/** 接受 FAESKey 的重载是 AES-256, 与 FAES 一致. */
+	FAES::FAESKey RawKey;
+	FMemory::Memcpy(RawKey.Key, KeyBytes, sizeof(KeyBytes));
+	TArray<uint8> Block = Plaintext;
+	AESKernel::EncryptData(Block.GetData(), Block.Num(), RawKey);
+	TestEqual(TEXT("AES-256 encrypt with a raw key"), Block, HexToArray(Vectors[2].Cipher));
+	FAES::DecryptData(Block.GetData(), Block.Num(), RawKey);
+	TestEqual(TEXT("FAES decrypts the kernel output"), Block, Plaintext);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionPreparedKeyTest, "UnrealUtils.Ecryption.PreparedKey", EcryptionTestFlags)
+bool FEcryptionPreparedKeyTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(6);
+	const FPreparedAESKey PreparedKey(Key);
+
+	/** 预处理的密钥与原始密钥得到相同的密文, 并且可以互相解密. */
+	for (const FString& Plaintext : MakeTestStrings())
+	{
+		const FString Cipher = Encrypt(Plaintext, Key);
+		TestEqual(TEXT("Encrypt with a prepared key"), Encrypt(Plaintext, PreparedKey), Cipher);
+		TestEqual(TEXT("Decrypt with a prepared key"), Decrypt(Cipher, PreparedKey), Plaintext);
+
+		const FString CipherBase64 = EncryptBase64(Plaintext, Key);
+		TestEqual(TEXT("EncryptBase64 with a prepared key"), EncryptBase64(Plaintext, PreparedKey), CipherBase64);
+		TestEqual(TEXT("DecryptBase64 with a prepared key"), DecryptBase64(CipherBase64, PreparedKey), Plaintext);
+	}
+
+	const TArray<uint8> Plaintext = MakeTestBytes(1000, 2);
+	TArray<uint8> Cipher{};
+	TArray<uint8> PreparedCipher{};
+	TArray<uint8> Decrypted{};
+	TestTrue(TEXT("Encrypt bytes"), Encrypt(TArrayView<const uint8>(Plaintext), Key, Cipher));
+	TestTrue(TEXT("Encrypt bytes with a prepared key"), Encrypt(TArrayView<const uint8>(Plaintext), PreparedKey, PreparedCipher));
+	TestEqual(TEXT("Prepared key ciphertext matches"), PreparedCipher, Cipher);
+	TestTrue(TEXT("Decrypt bytes with a prepared key"), Decrypt(TArrayView<const uint8>(Cipher), PreparedKey, Decrypted));
+	TestEqual(TEXT("Decrypt(Encrypt) with a prepared key"), Decrypted, Plaintext);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionBatchTest, "UnrealUtils.Ecryption.Batch", EcryptionTestFlags)
+bool FEcryptionBatchTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FPreparedAESKey Key(MakeTestKey(21));
+
+	TArray<FString> Inputs = MakeTestStrings();
+	for (int32 Index = 0; Index < 37; ++Index)
+	{
+		Inputs.Add(FString::Printf(TEXT("message %d"), Index));
+	}
+
+	TEcryptionBatch<uint8> Ciphers;
+	TEcryptionBatch<TCHAR> Base64Ciphers;
+	TestTrue(TEXT("EncryptBatch"), EncryptBatch(Inputs, Key, Ciphers));
+	TestTrue(TEXT("EncryptBase64Batch"), EncryptBase64Batch(Inputs, Key, Base64Ciphers));
+	TestEqual(TEXT("EncryptBatch count"), Ciphers.Num(), Inputs.Num());
+	TestEqual(TEXT("EncryptBase64Batch count"), Base64Ciphers.Num(), Inputs.Num());
+
+	/** 每个条目与逐条调用的结果相同. */
+	TArray<FString> StringCiphers{};
+	TArray<FString> Base64Strings{};
+	for (int32 Index = 0; Index < Inputs.Num(); ++Index)
+	{
+		TArray<uint8> Expected{};
+		Encrypt(FStringView(Inputs[Index]), Key, Expected);
+		TestEqual(FString::Printf(TEXT("EncryptBatch item %d matches Encrypt"), Index), TArray<uint8>(Ciphers[Index].GetData(), Ciphers[Index].Num()), Expected);
+
+		const FString Base64(Base64Ciphers[Index].Num(), Base64Ciphers[Index].GetData());
+		TestEqual(FString::Printf(TEXT("EncryptBase64Batch item %d matches EncryptBase64"), Index), Base64, EncryptBase64(Inputs[Index], Key));
+		StringCiphers.Add(Encrypt(Inputs[Index], Key));
+		Base64Strings.Add(Base64);
+	}
+
+	TEcryptionBatch<TCHAR> FromBytes;
+	TEcryptionBatch<TCHAR> FromStrings;
+	TEcryptionBatch<TCHAR> FromBase64;
+	TestTrue(TEXT("DecryptBatch of bytes"), DecryptBatch(Ciphers, Key, FromBytes));
+	TestTrue(TEXT("DecryptBatch of strings"), DecryptBatch(StringCiphers, Key, FromStrings));
+	TestTrue(TEXT("DecryptBase64Batch"), DecryptBase64Batch(Base64Strings, Key, FromBase64));
+	for (int32 Index = 0; Index < Inputs.Num(); ++Index)
+	{
+		TestEqual(FString::Printf(TEXT("DecryptBatch of bytes item %d"), Index), FString(FromBytes[Index].Num(), FromBytes[Index].GetData()), Inputs[Index]);
+		TestEqual(FString::Printf(TEXT("DecryptBatch of strings item %d"), Index), FString(FromStrings[Index].Num(), FromStrings[Index].GetData()), Inputs[Index]);
+		TestEqual(FString::Printf(TEXT("DecryptBase64Batch item %d"), Index), FString(FromBase64[Index].Num(), FromBase64[Index].GetData()), Inputs[Index]);
+	}
+
+	/** 无效的条目长度为 0, 不影响其他条目, 也不触发 ensure. */
+	const FString Plaintext = TEXT("first");
+	TArray<FString> Batch{};
+	Batch.Add(EncryptBase64(Plaintext, Key));
+	Batch.Add(TEXT("ab!d"));
+	Batch.Add(FString());
+	Batch.Add(TEXT("AAAAAAAAAAAAAAAAAAAAAAA="));
+	Batch.Add(EncryptBase64(TEXT("last"), Key));
+	TEcryptionBatch<TCHAR> Results;
+	TestFalse(TEXT("DecryptBase64Batch with invalid items"), DecryptBase64Batch(Batch, Key, Results));
+	TestEqual(TEXT("DecryptBase64Batch keeps every item"), Results.Num(), Batch.Num());
+	TestEqual(TEXT("DecryptBase64Batch first item"), FString(Results[0].Num(), Results[0].GetData()), Plaintext);
+	TestEqual(TEXT("DecryptBase64Batch invalid characters"), Results[1].Num(), 0);
+	TestEqual(TEXT("DecryptBase64Batch empty item"), Results[2].Num(), 0);
+	TestEqual(TEXT("DecryptBase64Batch partial block"), Results[3].Num(), 0);
+	TestEqual(TEXT("DecryptBase64Batch last item"), FString(Results[4].Num(), Results[4].GetData()), FString(TEXT("last")));
+
+	Batch.Reset();
+	Batch.Add(Encrypt(Plaintext, Key));
+	Batch.Add(TEXT("abc"));
+	Batch.Add(FString());
+	TestFalse(TEXT("DecryptBatch with invalid items"), DecryptBatch(Batch, Key, Results));
+	TestEqual(TEXT("DecryptBatch first item"), FString(Results[0].Num(), Results[0].GetData()), Plaintext);
+	TestEqual(TEXT("DecryptBatch invalid item"), Results[1].Num(), 0);
+	TestEqual(TEXT("DecryptBatch empty item"), Results[2].Num(), 0);
+
+	TEcryptionBatch<uint8> BatchCiphers;
+	TestFalse(TEXT("EncryptBatch with an empty item"), EncryptBatch(Batch, Key, BatchCiphers));
+	TestEqual(TEXT("EncryptBatch empty item"), BatchCiphers[2].Num(), 0);
+	TestTrue(TEXT("EncryptBatch other items"), BatchCiphers[0].Num() > 0 && BatchCiphers[1].Num() > 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionBase64Test, "UnrealUtils.Ecryption.Base64", EcryptionTestFlags)
+bool FEcryptionBase64Test::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+
+	/** 覆盖标量尾部, 一组 SSSE3 以及多组 AVX2 的长度, 结果必须与 FBase64 一致. */
+	for (int32 Size : { 1, 2, 3, 11, 12, 13, 24, 47, 48, 49, 95, 96, 97, 1000, 65537 })
+	{
+		const TArray<uint8> Bytes = MakeTestBytes(Size, (uint8)Size);
+		const FString Encoded = Base64::Encode(Bytes.GetData(), Bytes.Num());
+		TestEqual(FString::Printf(TEXT("Encode of %d bytes matches FBase64"), Size), Encoded, FBase64::Encode(Bytes.GetData(), Bytes.Num()));
+		TestEqual(FString::Printf(TEXT("Encoded size of %d bytes"), Size), (uint32)Encoded.Len(), Base64::GetEncodedSize(Size));
+
+		TArray<uint8> Decoded{};
+		TestTrue(FString::Printf(TEXT("Decode of %d bytes"), Size), Base64::Decode(FStringView(Encoded), Decoded));
+		TestEqual(FString::Printf(TEXT("Decode(Encode) of %d bytes"), Size), Decoded, Bytes);
+	}
+
+	/** 非法字符出现在向量部分或尾部, 以及超出 255 的字符, 都要拒绝. */
+	const FString Valid = Base64::Encode(MakeTestBytes(300, 9).GetData(), 300);
+	for (int32 Position : { 0, 5, 31, 32, 200, Valid.Len() - 3 })
+	{
+		for (TCHAR Invalid : { TEXT('!'), TEXT('-'), (TCHAR)0x141 })
+		{
+			FString Corrupt = Valid;
+			Corrupt.GetCharArray()[Position] = Invalid;
+			TArray<uint8> Decoded{};
+			TestFalse(FString::Printf(TEXT("Decode with 0x%x at %d"), (int32)Invalid, Position), Base64::Decode(FStringView(Corrupt), Decoded));
+		}
+	}
+	TArray<uint8> Decoded{};
+	TestFalse(TEXT("Decode of a partial quad"), Base64::Decode(FStringView(TEXT("QUJDQ")), Decoded));
+	TestFalse(TEXT("Decode with misplaced padding"), Base64::Decode(FStringView(TEXT("QU=DQUJD")), Decoded));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionFusedBase64Test, "UnrealUtils.Ecryption.FusedBase64", EcryptionTestFlags)
+bool FEcryptionFusedBase64Test::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(8);
+
+	/** 覆盖不足一个分块, 恰好在分块边界附近以及跨越多个分块的长度. */
+	for (int32 Size : { 1, 100, 12 * 1024 - 13, 12 * 1024 - 12, 12 * 1024 - 11, 12 * 1024 + 4, 3 * 12 * 1024 + 7, 100000 })
+	{
+		FString Plaintext;
+		for (int32 Index = 0; Index < Size; ++Index)
+		{
+			Plaintext.AppendChar((TCHAR)(TEXT(' ') + Index % 90));
+		}
+
+		/** 分块编码的结果与先整体加密再编码相同. */
+		TArray<uint8> Cipher{};
+		TestTrue(TEXT("Encrypt"), Encrypt(FStringView(Plaintext), Key, Cipher));
+		const FString Encoded = EncryptBase64(Plaintext, Key);
+		TestEqual(FString::Printf(TEXT("EncryptBase64 of %d chars matches Base64(Encrypt)"), Size), Encoded, FBase64::Encode(Cipher.GetData(), Cipher.Num()));
+		TestEqual(FString::Printf(TEXT("DecryptBase64(EncryptBase64) of %d chars"), Size), DecryptBase64(Encoded, Key), Plaintext);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionStreamTest, "UnrealUtils.Ecryption.Stream", EcryptionTestFlags)
+bool FEcryptionStreamTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(23);
+	const FPreparedAESKey PreparedKey(Key);
+
+	for (int32 Size : { 1, 4, 5, 16, 100, 4096, 100000 })
+	{
+		const TArray<uint8> Plaintext = MakeTestBytes(Size, 29);
+		TArray<uint8> Expected{};
+		Encrypt(TArrayView<const uint8>(Plaintext), Key, Expected);
+
+		/** 按不规则的大小切分, 跨越信封头和块边界. */
+		for (int32 PieceSize : { 1, 7, 16, 33, 4099 })
+		{
+			TArray<uint8> Cipher{};
+			FEncryptContext Encryptor(Key, Size);
+			for (int32 Offset = 0; Offset < Size; Offset += PieceSize)
+			{
+				TestTrue(TEXT("FEncryptContext::Update"), Encryptor.Update(TArrayView<const uint8>(Plaintext.GetData() + Offset, FMath::Min(PieceSize, Size - Offset)), Cipher));
+			}
+			TestTrue(TEXT("FEncryptContext::Final"), Encryptor.Final(Cipher));
+			TestEqual(FString::Printf(TEXT("FEncryptContext matches Encrypt (%d in pieces of %d)"), Size, PieceSize), Cipher, Expected);
+
+			TArray<uint8> Decrypted{};
+			FDecryptContext Decryptor(PreparedKey);
+			for (int32 Offset = 0; Offset < Cipher.Num(); Offset += PieceSize)
+			{
+				TestTrue(TEXT("FDecryptContext::Update"), Decryptor.Update(TArrayView<const uint8>(Cipher.GetData() + Offset, FMath::Min(PieceSize, Cipher.Num() - Offset)), Decrypted));
+			}
+			TestTrue(TEXT("FDecryptContext::Final"), Decryptor.Final(Decrypted));
+			TestEqual(FString::Printf(TEXT("FDecryptContext matches Decrypt (%d in pieces of %d)"), Size, PieceSize), Decrypted, Plaintext);
+		}
+	}
+
+	/** 截断, 超长或密钥不对的密文只返回 false, 不触发 ensure. */
+	TArray<uint8> Cipher{};
+	Encrypt(TArrayView<const uint8>(MakeTestBytes(100, 47)), Key, Cipher);
+	{
+		TArray<uint8> Bytes{};
+		FDecryptContext Decryptor(PreparedKey);
+		TestTrue(TEXT("FDecryptContext::Update of a truncated cipher"), Decryptor.Update(TArrayView<const uint8>(Cipher.GetData(), Cipher.Num() - 16), Bytes));
+		TestFalse(TEXT("FDecryptContext::Final of a truncated cipher"), Decryptor.Final(Bytes));
+	}
+	{
+		TArray<uint8> Bytes{};
+		FDecryptContext Decryptor(PreparedKey);
+		TestTrue(TEXT("FDecryptContext::Update of a whole cipher"), Decryptor.Update(TArrayView<const uint8>(Cipher), Bytes));
+		TestFalse(TEXT("FDecryptContext::Update past the declared size"), Decryptor.Update(TArrayView<const uint8>(Cipher.GetData(), 16), Bytes));
+	}
+	{
+		TArray<uint8> Bytes{};
+		FDecryptContext Decryptor(MakeTestKey(42));
+		TestFalse(TEXT("FDecryptContext::Update with the wrong key"), Decryptor.Update(TArrayView<const uint8>(Cipher), Bytes));
+		TestEqual(TEXT("FDecryptContext outputs nothing with the wrong key"), Bytes.Num(), 0);
+		TestFalse(TEXT("FDecryptContext::Final after a failure"), Decryptor.Final(Bytes));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionCTRTest, "UnrealUtils.Ecryption.CTR", EcryptionTestFlags)
+bool FEcryptionCTRTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(7);
+	const FPreparedAESKey PreparedKey(Key);
+
+	/** 超过 CTRParallelThreshold 的负载走多线程路径. */
+	for (int32 Size : { 1, 16, 33, 1000, CTRParallelThreshold + 17 })
+	{
+		const TArray<uint8> Plaintext = MakeTestBytes(Size, 11);
+		TArray<uint8> Cipher{};
+		TArray<uint8> Decrypted{};
+
+		TestTrue(TEXT("EncryptCTR"), EncryptCTR(TArrayView<const uint8>(Plaintext), Key, Cipher));
+		TestEqual(TEXT("CTR cipher size"), Cipher.Num(), Size + (int32)FAES::AESBlockSize);
+		TestTrue(TEXT("DecryptCTR"), DecryptCTR(TArrayView<const uint8>(Cipher), PreparedKey, Decrypted));
+		TestEqual(TEXT("DecryptCTR(EncryptCTR)"), Decrypted, Plaintext);
+		TestTrue(TEXT("EncryptCTR with a prepared key"), EncryptCTR(TArrayView<const uint8>(Plaintext), PreparedKey, Cipher));
+		TestTrue(TEXT("DecryptCTR with a raw key"), DecryptCTR(TArrayView<const uint8>(Cipher), Key, Decrypted));
+		TestEqual(TEXT("DecryptCTR(EncryptCTR) with a prepared key"), Decrypted, Plaintext);
+	}
+
+	/** 初始计数器每次随机, 同一明文两次加密的结果不同. */
+	const TArray<uint8> Plaintext = MakeTestBytes(64, 1);
+	TArray<uint8> First{};
+	TArray<uint8> Second{};
+	EncryptCTR(TArrayView<const uint8>(Plaintext), Key, First);
+	EncryptCTR(TArrayView<const uint8>(Plaintext), Key, Second);
+	TestNotEqual(TEXT("CTR counters are random"), First, Second);
+
+	/** 装不下初始计数器和至少一个字节的密文只返回 false, 不触发 ensure. */
+	TArray<uint8> Decrypted{};
+	TestFalse(TEXT("DecryptCTR of a counter block only"), DecryptCTR(TArrayView<const uint8>(First.GetData(), 16), Key, Decrypted));
+	TestFalse(TEXT("DecryptCTR of a short cipher"), DecryptCTR(TArrayView<const uint8>(First.GetData(), 5), Key, Decrypted));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionCTRKnownAnswerTest, "UnrealUtils.Ecryption.KnownAnswer.CTR", EcryptionTestFlags)
+bool FEcryptionCTRKnownAnswerTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+
+	/** NIST SP 800-38A F.5.1 (CTR-AES128) 和 F.5.5 (CTR-AES256). 密文格式为初始计数器块 + 数据. */
+	const TArray<uint8> InitialCounter = HexToArray(TEXT("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"));
+	const TArray<uint8> Plaintext = HexToArray(TEXT(
+		"6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+		"30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710"));
+	struct FVector
+	{
+		const TCHAR* Key;
+		const TCHAR* Cipher;
+	};
+	const FVector Vectors[] =
+	{
+		{
+			TEXT("2b7e151628aed2a6abf7158809cf4f3c"),
+			TEXT("874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee"),
+		},
+		{
+			TEXT("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4"),
+			TEXT("601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c52b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6"),
+		},
+	};
+
+	for (const FVector& Vector : Vectors)
+	{
+		const TArray<uint8> KeyBytes = HexToArray(Vector.Key);
+		const FPreparedAESKey Key(KeyBytes.GetData(), KeyBytes.Num());
+		if (!Key.IsValid())
+		{
+			AddInfo(FString::Printf(TEXT("AES-%d is not supported without AES-NI, skipped."), KeyBytes.Num() * 8));
+			continue;
+		}
+		const TArray<uint8> Expected = HexToArray(Vector.Cipher);
+
+		TArray<uint8> Decrypted{};
+		TestTrue(TEXT("DecryptCTR of the NIST vector"), DecryptCTR(TArrayView<const uint8>(Concat(InitialCounter, Expected)), Key, Decrypted));
+		TestEqual(TEXT("DecryptCTR of the NIST vector"), Decrypted, Plaintext);
+
+		/** 分段调用时各段从自己的块序号开始. */
+		TArray<uint8> Encrypted{};
+		Encrypted.AddUninitialized(Plaintext.Num());
+		AESKernel::TransformCTR(Plaintext.GetData(), Encrypted.GetData(), 40, InitialCounter.GetData(), 0, Key);
+		AESKernel::TransformCTR(Plaintext.GetData() + 48, Encrypted.GetData() + 48, 16, InitialCounter.GetData(), 3, Key);
+		AESKernel::TransformCTR(Plaintext.GetData() + 32, Encrypted.GetData() + 32, 16, InitialCounter.GetData(), 2, Key);
+		TestEqual(TEXT("TransformCTR in pieces matches the NIST vector"), Encrypted, Expected);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionUTF8Test, "UnrealUtils.Ecryption.UTF8", EcryptionTestFlags)
+bool FEcryptionUTF8Test::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(12);
+
+	/** 1 到 4 字节的序列, 以及跨过 16 个字符一组的 ASCII. */
+	const FString String = TEXT("0123456789abcdef-é中\U0001F600-0123456789abcdef");
+	const TArray<uint8> Expected = HexToArray(TEXT(
+		"303132333435363738396162636465662d"
+		"c3a9e4b8adf09f9880"
+		"2d30313233343536373839616263646566"));
+	TArray<uint8> Encoded{};
+	Encoded.AddUninitialized(UTF8::GetMaxEncodedSize(String.Len()));
+	Encoded.SetNum(UTF8::Encode(*String, String.Len(), Encoded.GetData()), false);
+	TestEqual(TEXT("UTF8::Encode"), Encoded, Expected);
+	TestEqual(TEXT("UTF8::GetEncodedSize"), UTF8::GetEncodedSize(*String, String.Len()), Expected.Num());
+
+	/** 在任意位置分成两段解码, 第一段末尾不完整的序列留给第二段. */
+	TArray<TCHAR> Chars{};
+	Chars.AddUninitialized(Encoded.Num());
+	int32 NumChars = 0;
+	for (int32 Split = 0; Split <= Encoded.Num(); ++Split)
+	{
+		int32 NumFirstChars = 0;
+		int32 NumSecondChars = 0;
+		int32 NumConsumed = 0;
+		int32 NumSecondConsumed = 0;
+		TestTrue(TEXT("UTF8::Decode of the first piece"), UTF8::Decode(Encoded.GetData(), Split, Chars.GetData(), NumFirstChars, NumConsumed, false));
+		TestTrue(TEXT("UTF8::Decode of the second piece"), UTF8::Decode(Encoded.GetData() + NumConsumed, Encoded.Num() - NumConsumed, Chars.GetData() + NumFirstChars, NumSecondChars, NumSecondConsumed));
+		TestEqual(FString::Printf(TEXT("UTF8::Decode split at %d"), Split), FString(NumFirstChars + NumSecondChars, Chars.GetData()), String);
+	}
+
+	/** 过长编码, 代理项, 超出 U+10FFFF 以及截断的序列都要拒绝. */
+	for (const TCHAR* Invalid : { TEXT("c080"), TEXT("e08080"), TEXT("eda080"), TEXT("f4908080"), TEXT("e4b8"), TEXT("80"), TEXT("ff") })
+	{
+		const TArray<uint8> Bytes = HexToArray(Invalid);
+		int32 NumConsumed = 0;
+		TestFalse(FString::Printf(TEXT("UTF8::Decode rejects %s"), Invalid), UTF8::Decode(Bytes.GetData(), Bytes.Num(), Chars.GetData(), NumChars, NumConsumed));
+	}
+
+	/** 字符串负载以 UTF-8 加密, 解密到字节得到 UTF-8. */
+	for (const FString& Plaintext : MakeTestStrings())
+	{
+		TArray<uint8> Cipher{};
+		TArray<uint8> Payload{};
+		TestTrue(TEXT("Encrypt(FStringView)"), Encrypt(FStringView(Plaintext), Key, Cipher));
+		TestTrue(TEXT("Decrypt to bytes"), Decrypt(TArrayView<const uint8>(Cipher), Key, Payload));
+		TArray<uint8> ExpectedPayload{};
+		ExpectedPayload.AddUninitialized(UTF8::GetMaxEncodedSize(Plaintext.Len()));
+		ExpectedPayload.SetNum(UTF8::Encode(*Plaintext, Plaintext.Len(), ExpectedPayload.GetData()), false);
+		TestEqual(TEXT("Decrypt to bytes returns the UTF-8 payload"), Payload, ExpectedPayload);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionBlobTest, "UnrealUtils.Ecryption.Blob", EcryptionTestFlags)
+bool FEcryptionBlobTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(9);
+	const FPreparedAESKey PreparedKey(Key);
+
+	for (const FString& Plaintext : MakeTestStrings())
+	{
+		const FEncryptedBlob Blob = EncryptBlob(FStringView(Plaintext), Key);
+		TestEqual(TEXT("DecryptBlobToString(EncryptBlob)"), DecryptBlobToString(Blob, PreparedKey), Plaintext);
+		TestEqual(TEXT("ToLegacyString matches Encrypt"), Blob.ToLegacyString(), Encrypt(Plaintext, Key));
+		TestEqual(TEXT("ToBase64 matches EncryptBase64"), Blob.ToBase64(), EncryptBase64(Plaintext, Key));
+
+		FEncryptedBlob FromLegacy;
+		FEncryptedBlob FromBase64;
+		TestTrue(TEXT("FromLegacyString"), FEncryptedBlob::FromLegacyString(FStringView(Blob.ToLegacyString()), FromLegacy));
+		TestTrue(TEXT("FromBase64"), FEncryptedBlob::FromBase64(FStringView(Blob.ToBase64()), FromBase64));
+		TestEqual(TEXT("FromLegacyString(ToLegacyString)"), FromLegacy.GetBytes(), Blob.GetBytes());
+		TestEqual(TEXT("FromBase64(ToBase64)"), FromBase64.GetBytes(), Blob.GetBytes());
+		TestEqual(TEXT("DecryptBlobToString with a raw key"), DecryptBlobToString(EncryptBlob(FStringView(Plaintext), PreparedKey), Key), Plaintext);
+	}
+
+	const TArray<uint8> Plaintext = MakeTestBytes(1000, 13);
+	for (EEncryptedBlobFormat Format : { EEncryptedBlobFormat::Envelope, EEncryptedBlobFormat::CTR })
+	{
+		TArray<uint8> Decrypted{};
+		TestTrue(TEXT("DecryptBlob(EncryptBlob)"), DecryptBlob(EncryptBlob(TArrayView<const uint8>(Plaintext), Key, Format), PreparedKey, Decrypted));
+		TestEqual(TEXT("DecryptBlob(EncryptBlob) bytes"), Decrypted, Plaintext);
+		TestTrue(TEXT("DecryptBlob(EncryptBlob) with a raw key"), DecryptBlob(EncryptBlob(TArrayView<const uint8>(Plaintext), PreparedKey, Format), Key, Decrypted));
+		TestEqual(TEXT("DecryptBlob(EncryptBlob) bytes with a raw key"), Decrypted, Plaintext);
+	}
+
+	/** 大小或字符无效的字符串不能转换为密文. */
+	FEncryptedBlob Blob;
+	TestFalse(TEXT("FromBase64 of invalid characters"), FEncryptedBlob::FromBase64(FStringView(TEXT("ab!dabcd")), Blob));
+	TestFalse(TEXT("FromBase64 of a partial block"), FEncryptedBlob::FromBase64(FStringView(TEXT("AAAAAAAAAAAAAAAAAAAAAAA=")), Blob));
+	TestFalse(TEXT("FromLegacyString of a partial block"), FEncryptedBlob::FromLegacyString(FStringView(TEXT("abc")), Blob));
+	TestTrue(TEXT("A failed conversion leaves an empty blob"), Blob.IsEmpty());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionScratchTest, "UnrealUtils.Ecryption.Scratch", EcryptionTestFlags)
+bool FEcryptionScratchTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	IConsoleVariable* MaxRetainedKB = IConsoleManager::Get().FindConsoleVariable(TEXT("Ecryption.Scratch.MaxRetainedKB"));
+	if (!TestTrue(TEXT("Ecryption.Scratch.MaxRetainedKB exists"), MaxRetainedKB != nullptr))
+	{
+		return false;
+	}
+	const FPreparedAESKey Key(MakeTestKey(14));
+
+	/** 覆盖 ASCII, 非 ASCII 和旧格式的回退路径. 每轮都经过四个字符串接口. */
+	TArray<FString> Plaintexts = MakeTestStrings();
+	TArray<FString> Ciphers{};
+	TArray<FString> Base64Ciphers{};
+	for (const FString& Plaintext : Plaintexts)
+	{
+		Ciphers.Add(Encrypt(Plaintext, Key));
+		Base64Ciphers.Add(EncryptBase64(Plaintext, Key));
+	}
+	const auto RunCalls = [&]()
+	{
+		for (int32 Index = 0; Index < Plaintexts.Num(); ++Index)
+		{
+			TestEqual(TEXT("Encrypt"), Encrypt(Plaintexts[Index], Key), Ciphers[Index]);
+			TestEqual(TEXT("Decrypt"), Decrypt(Ciphers[Index], Key), Plaintexts[Index]);
+			TestEqual(TEXT("EncryptBase64"), EncryptBase64(Plaintexts[Index], Key), Base64Ciphers[Index]);
+			TestEqual(TEXT("DecryptBase64"), DecryptBase64(Base64Ciphers[Index], Key), Plaintexts[Index]);
+		}
+	};
+
+	/** 预热之后, 稳态调用不再向堆申请暂存内存. */
+	RunCalls();
+	const int64 SteadyStart = Scratch::GetNumHeapAllocations();
+	for (int32 Round = 0; Round < 10; ++Round)
+	{
+		RunCalls();
+	}
+	TestEqual(TEXT("No scratch heap allocations in steady state"), Scratch::GetNumHeapAllocations() - SteadyStart, (int64)0);
+
+	/** 内存整理后缓存被释放, 下一轮重新申请, 之后再次稳定. */
+	FCoreDelegates::GetMemoryTrimDelegate().Broadcast();
+	const int64 TrimStart = Scratch::GetNumHeapAllocations();
+	RunCalls();
+	TestTrue(TEXT("Memory trim releases the cached blocks"), Scratch::GetNumHeapAllocations() > TrimStart);
+	const int64 AfterTrim = Scratch::GetNumHeapAllocations();
+	RunCalls();
+	TestEqual(TEXT("No scratch heap allocations after the cache is refilled"), Scratch::GetNumHeapAllocations() - AfterTrim, (int64)0);
+
+	/** 不允许缓存时每次都走堆. */
+	const int32 PreviousMaxRetainedKB = MaxRetainedKB->GetInt();
+	MaxRetainedKB->Set(0);
+	const int64 UncachedStart = Scratch::GetNumHeapAllocations();
+	RunCalls();
+	TestTrue(TEXT("Blocks beyond the retention budget go back to the heap"), Scratch::GetNumHeapAllocations() > UncachedStart);
+	MaxRetainedKB->Set(PreviousMaxRetainedKB);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionAsyncTest, "UnrealUtils.Ecryption.Async", EcryptionTestFlags)
+bool FEcryptionAsyncTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(15);
+	const FPreparedAESKey PreparedKey(Key);
+
+	/** 最后一条超过 Ecryption.Async.InlineThreshold, 在线程池上执行. */
+	TArray<FString> Strings = MakeTestStrings();
+	FString Large;
+	for (int32 Index = 0; Index < 20000; ++Index)
+	{
+		Large += TEXT("async ");
+	}
+	Strings.Add(Large);
+
+	for (const FString& Plaintext : Strings)
+	{
+		const FString Cipher = EncryptAsync(Plaintext, Key).Get();
+		TestEqual(TEXT("EncryptAsync matches Encrypt"), Cipher, Encrypt(Plaintext, Key));
+		TestEqual(TEXT("DecryptAsync(EncryptAsync)"), DecryptAsync(Cipher, Key).Get(), Plaintext);
+		TestEqual(TEXT("DecryptAsync(EncryptAsync) with a prepared key"), DecryptAsync(EncryptAsync(Plaintext, PreparedKey).Get(), PreparedKey).Get(), Plaintext);
+	}
+
+	/** 队列已满时在调用线程上执行, 返回时结果已经就绪. */
+	IConsoleVariable* MaxQueuedJobs = IConsoleManager::Get().FindConsoleVariable(TEXT("Ecryption.Async.MaxQueuedJobs"));
+	if (!TestTrue(TEXT("Ecryption.Async.MaxQueuedJobs exists"), MaxQueuedJobs != nullptr))
+	{
+		return false;
+	}
+	const int32 PreviousMaxQueuedJobs = MaxQueuedJobs->GetInt();
+	MaxQueuedJobs->Set(1);
+
+	FString Huge;
+	for (int32 Index = 0; Index < 1 << 16; ++Index)
+	{
+		Huge += TEXT("a long job that keeps the only queue slot busy ");
+	}
+	TFuture<FString> Queued = EncryptAsync(Huge, PreparedKey);
+	TFuture<FString> Inline = EncryptAsync(Large, PreparedKey);
+	const bool bQueuedWasRunning = !Queued.IsReady();
+	if (bQueuedWasRunning)
+	{
+		TestTrue(TEXT("A job beyond Ecryption.Async.MaxQueuedJobs runs on the caller"), Inline.IsReady());
+	}
+	else
+	{
+		AddInfo(TEXT("The queued job finished before the second call, inline execution was not observed."));
+	}
+	TestEqual(TEXT("Inline EncryptAsync matches Encrypt"), Inline.Get(), Encrypt(Large, PreparedKey));
+	TestEqual(TEXT("Queued EncryptAsync decrypts"), Decrypt(Queued.Get(), PreparedKey), Huge);
+	TestEqual(TEXT("Finished jobs release their queue slots"), GetNumQueuedAsyncJobs(), 0);
+
+	MaxQueuedJobs->Set(PreviousMaxQueuedJobs);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionGCMTest, "UnrealUtils.Ecryption.GCM", EcryptionTestFlags)
+bool FEcryptionGCMTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(7);
+	const FPreparedAESKey PreparedKey(Key);
+
+	/** 超过 CTRParallelThreshold 的负载走多线程路径. */
+	for (int32 Size : { 1, 16, 33, 1000, CTRParallelThreshold + 17 })
+	{
+		const TArray<uint8> Plaintext = MakeTestBytes(Size, 11);
+		TArray<uint8> Cipher{};
+		TArray<uint8> Decrypted{};
+
+		TestTrue(TEXT("EncryptGCM"), EncryptGCM(TArrayView<const uint8>(Plaintext), Key, Cipher));
+		TestEqual(TEXT("GCM cipher size"), Cipher.Num(), Size + 12 + 16);
+		TestTrue(TEXT("DecryptGCM"), DecryptGCM(TArrayView<const uint8>(Cipher), PreparedKey, Decrypted));
+		TestEqual(TEXT("DecryptGCM(EncryptGCM)"), Decrypted, Plaintext);
+		TestTrue(TEXT("EncryptGCM with a prepared key"), EncryptGCM(TArrayView<const uint8>(Plaintext), PreparedKey, Cipher));
+		TestTrue(TEXT("DecryptGCM with a raw key"), DecryptGCM(TArrayView<const uint8>(Cipher), Key, Decrypted));
+		TestEqual(TEXT("DecryptGCM(EncryptGCM) with a prepared key"), Decrypted, Plaintext);
+	}
+
+	/** nonce 每次随机, 同一明文两次加密的结果不同. */
+	const TArray<uint8> Plaintext = MakeTestBytes(64, 1);
+	TArray<uint8> First{};
+	TArray<uint8> Second{};
+	EncryptGCM(TArrayView<const uint8>(Plaintext), Key, First);
+	EncryptGCM(TArrayView<const uint8>(Plaintext), Key, Second);
+	TestNotEqual(TEXT("GCM nonces are random"), First, Second);
+
+	for (const FString& String : MakeTestStrings())
+	{
+		TestEqual(TEXT("DecryptGCMBase64(EncryptGCMBase64)"), DecryptGCMBase64(EncryptGCMBase64(String, Key), Key), String);
+		TestEqual(TEXT("DecryptGCMBase64(EncryptGCMBase64) with a prepared key"), DecryptGCMBase64(EncryptGCMBase64(String, PreparedKey), PreparedKey), String);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionGCMKnownAnswerTest, "UnrealUtils.Ecryption.KnownAnswer.GCM", EcryptionTestFlags)
+bool FEcryptionGCMKnownAnswerTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+
+	/** GCM 规范(NIST SP 800-38D 引用的 McGrew-Viega 测试向量)中不带附加数据的用例 3 和 15 (全零密钥的用例被 FAESKey::IsValid 拒绝). 密文格式为 nonce + 数据 + 标签. */
+	struct FVector
+	{
+		const TCHAR* Key;
+		const TCHAR* Nonce;
+		const TCHAR* Plaintext;
+		const TCHAR* Cipher;
+		const TCHAR* Tag;
+	};
+	const FVector Vectors[] =
+	{
+		{
+			TEXT("feffe9928665731c6d6a8f9467308308"),
+			TEXT("cafebabefacedbaddecaf888"),
+			TEXT("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255"),
+			TEXT("42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985"),
+			TEXT("4d5c2af327cd64a62cf35abd2ba6fab4"),
+		},
+		{
+			TEXT("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308"),
+			TEXT("cafebabefacedbaddecaf888"),
+			TEXT("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255"),
+			TEXT("522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662898015ad"),
+			TEXT("b094dac5d93471bdec1a502270e3cc6c"),
+		},
+	};
+
+	for (const FVector& Vector : Vectors)
+	{
+		const TArray<uint8> KeyBytes = HexToArray(Vector.Key);
+		const FPreparedAESKey Key(KeyBytes.GetData(), KeyBytes.Num());
+		if (!Key.IsValid())
+		{
+			AddInfo(FString::Printf(TEXT("AES-%d is not supported without AES-NI, skipped."), KeyBytes.Num() * 8));
+			continue;
+		}
+		const TArray<uint8> Sealed = Concat(HexToArray(Vector.Nonce), HexToArray(Vector.Cipher), HexToArray(Vector.Tag));
+
+		TArray<uint8> Decrypted{};
+		TestTrue(FString::Printf(TEXT("DecryptGCM of the AES-%d vector"), KeyBytes.Num() * 8), DecryptGCM(TArrayView<const uint8>(Sealed), Key, Decrypted));
+		TestEqual(FString::Printf(TEXT("DecryptGCM of the AES-%d vector"), KeyBytes.Num() * 8), Decrypted, HexToArray(Vector.Plaintext));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionGCMTamperTest, "UnrealUtils.Ecryption.GCMTamper", EcryptionTestFlags)
+bool FEcryptionGCMTamperTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(17);
+	const TArray<uint8> Plaintext = MakeTestBytes(100, 19);
+	TArray<uint8> Sealed{};
+	TestTrue(TEXT("EncryptGCM"), EncryptGCM(TArrayView<const uint8>(Plaintext), Key, Sealed));
+
+	/** nonce, 数据和标签中的任意一位被改动都必须拒绝, 不输出任何明文, 也不触发 ensure. */
+	for (int32 Position : { 0, 11, 12, 60, 111, 112, 127 })
+	{
+		TArray<uint8> Tampered = Sealed;
+		Tampered[Position] ^= 0x01;
+		TArray<uint8> Decrypted = Plaintext;
+		TestFalse(FString::Printf(TEXT("DecryptGCM with byte %d flipped"), Position), DecryptGCM(TArrayView<const uint8>(Tampered), Key, Decrypted));
+		TestEqual(FString::Printf(TEXT("No plaintext with byte %d flipped"), Position), Decrypted.Num(), 0);
+	}
+
+	TArray<uint8> Decrypted{};
+	TestFalse(TEXT("DecryptGCM of a truncated message"), DecryptGCM(TArrayView<const uint8>(Sealed.GetData(), Sealed.Num() - 1), Key, Decrypted));
+	TestFalse(TEXT("DecryptGCM of a message without payload"), DecryptGCM(TArrayView<const uint8>(Sealed.GetData(), 28), Key, Decrypted));
+	TestFalse(TEXT("DecryptGCM of a short message"), DecryptGCM(TArrayView<const uint8>(Sealed.GetData(), 5), Key, Decrypted));
+	TestFalse(TEXT("DecryptGCM with the wrong key"), DecryptGCM(TArrayView<const uint8>(Sealed), MakeTestKey(18), Decrypted));
+	TestTrue(TEXT("DecryptGCM of the original message"), DecryptGCM(TArrayView<const uint8>(Sealed), Key, Decrypted));
+
+	const FString Sealed64 = EncryptGCMBase64(TEXT("authenticated message"), Key);
+	FString Tampered64 = Sealed64;
+	TCHAR& Char = Tampered64.GetCharArray()[Sealed64.Len() / 2];
+	Char = Char == TEXT('A') ? TEXT('B') : TEXT('A');
+	TestEqual(TEXT("DecryptGCMBase64 of a tampered message"), DecryptGCMBase64(Tampered64, Key), FString());
+	TestEqual(TEXT("DecryptGCMBase64 with the wrong key"), DecryptGCMBase64(Sealed64, MakeTestKey(18)), FString());
+	TestEqual(TEXT("DecryptGCMBase64 of an empty string"), DecryptGCMBase64(FString(), Key), FString());
+	TestEqual(TEXT("DecryptGCMBase64 of invalid Base64"), DecryptGCMBase64(TEXT("not*base64!"), Key), FString());
+	TestEqual(TEXT("DecryptGCMBase64 of a short message"), DecryptGCMBase64(TEXT("AAAAAAAA"), Key), FString());
+	TestEqual(TEXT("DecryptGCMBase64 of the original message"), DecryptGCMBase64(Sealed64, Key), FString(TEXT("authenticated message")));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionCompressionTest, "UnrealUtils.Ecryption.Compression", EcryptionTestFlags)
+bool FEcryptionCompressionTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(31);
+	const FPreparedAESKey PreparedKey(Key);
+
+	/** JSON 风格的文本, 足够大且重复较多, 两种压缩都会生效. */
+	FString Plaintext;
+	for (int32 Index = 0; Index < 200; ++Index)
+	{
+		Plaintext += FString::Printf(TEXT("{\"id\":%d,\"name\":\"玩家%d\",\"level\":10,\"guild\":\"none\"},"), Index, Index % 7);
+	}
+	const FString Uncompressed = Encrypt(Plaintext, Key);
+
+	TArray<uint8> Bytes{};
+	for (int32 Index = 0; Index < 8192; ++Index)
+	{
+		Bytes.Add((uint8)(Index % 16));
+	}
+
+	for (EEcryptionCompression Compression : { EEcryptionCompression::LZ4, EEcryptionCompression::Zlib })
+	{
+		const FString Cipher = Encrypt(Plaintext, Key, Compression);
+		TestTrue(TEXT("Compressed cipher is smaller"), Cipher.Len() < Uncompressed.Len());
+		TestEqual(TEXT("Decrypt of a compressed cipher"), Decrypt(Cipher, Key), Plaintext);
+		TestEqual(TEXT("Encrypt with compression and a prepared key"), Encrypt(Plaintext, PreparedKey, Compression), Cipher);
+		TestEqual(TEXT("DecryptBase64 of a compressed cipher"), DecryptBase64(EncryptBase64(Plaintext, Key, Compression), PreparedKey), Plaintext);
+		TestEqual(TEXT("DecryptBase64 of a compressed cipher with a prepared key"), DecryptBase64(EncryptBase64(Plaintext, PreparedKey, Compression), Key), Plaintext);
+
+		TArray<uint8> CipherBytes{};
+		TArray<uint8> Decrypted{};
+		TestTrue(TEXT("Encrypt(FStringView) with compression"), Encrypt(FStringView(Plaintext), Key, CipherBytes, Compression));
+		TestEqual(TEXT("Encrypt(FStringView) with compression matches"), BytesToString(CipherBytes.GetData(), CipherBytes.Num()), Cipher);
+		TestTrue(TEXT("Encrypt(FStringView) with compression and a prepared key"), Encrypt(FStringView(Plaintext), PreparedKey, CipherBytes, Compression));
+		const FEncryptedBlob Blob(TArray<uint8>(CipherBytes), EEncryptedBlobFormat::Envelope);
+		TestEqual(TEXT("DecryptBlobToString of a compressed cipher"), DecryptBlobToString(Blob, Key), Plaintext);
+
+		/** 压缩过的消息不能分段解出, FDecryptContext 只返回 false. */
+		FDecryptContext Decryptor(Key);
+		TestFalse(TEXT("FDecryptContext rejects a compressed cipher"), Decryptor.Update(TArrayView<const uint8>(CipherBytes), Decrypted) && Decryptor.Final(Decrypted));
+
+		/** 字节负载同样可以压缩, 解密后只剩原始负载. */
+		TestTrue(TEXT("Encrypt(TArrayView) with compression"), Encrypt(TArrayView<const uint8>(Bytes), Key, CipherBytes, Compression));
+		TestTrue(TEXT("Compressed bytes are smaller"), CipherBytes.Num() < Bytes.Num());
+		TestTrue(TEXT("Decrypt of compressed bytes"), Decrypt(TArrayView<const uint8>(CipherBytes), PreparedKey, Decrypted));
+		TestEqual(TEXT("Decrypt of compressed bytes"), Decrypted, Bytes);
+		TestTrue(TEXT("Encrypt(TArrayView) with compression and a prepared key"), Encrypt(TArrayView<const uint8>(Bytes), PreparedKey, CipherBytes, Compression));
+		TestTrue(TEXT("Decrypt of compressed bytes with a raw key"), Decrypt(TArrayView<const uint8>(CipherBytes), Key, Decrypted));
+		TestEqual(TEXT("Decrypt of compressed bytes with a raw key"), Decrypted, Bytes);
+
+		/** 解压后超出按密文大小预留的空间, 走 Overflow 合并, 顺序不变. */
+		TArray<FString> Batch{};
+		Batch.Add(Encrypt(TEXT("first"), Key));
+		Batch.Add(Cipher);
+		Batch.Add(Encrypt(TEXT("last"), Key));
+		TEcryptionBatch<TCHAR> FromBatch;
+		TestTrue(TEXT("DecryptBatch of a compressed cipher"), DecryptBatch(Batch, PreparedKey, FromBatch));
+		TestEqual(TEXT("DecryptBatch of a compressed cipher"), FString(FromBatch[1].Num(), FromBatch[1].GetData()), Plaintext);
+		TestEqual(TEXT("DecryptBatch keeps the order around a compressed cipher"), FString(FromBatch[2].Num(), FromBatch[2].GetData()), FString(TEXT("last")));
+
+		TArray<FString> Batch64{};
+		Batch64.Add(EncryptBase64(TEXT("first"), Key));
+		Batch64.Add(EncryptBase64(Plaintext, Key, Compression));
+		TestTrue(TEXT("DecryptBase64Batch of a compressed cipher"), DecryptBase64Batch(Batch64, PreparedKey, FromBatch));
+		TestEqual(TEXT("DecryptBase64Batch of a compressed cipher"), FString(FromBatch[1].Num(), FromBatch[1].GetData()), Plaintext);
+		TestEqual(TEXT("DecryptBase64Batch keeps the order around a compressed cipher"), FString(FromBatch[0].Num(), FromBatch[0].GetData()), FString(TEXT("first")));
+	}
+
+	/** 太短或压缩不下来的内容按原样加密. */
+	const FString Short = TEXT("short");
+	TestEqual(TEXT("Short input is sealed as is"), Encrypt(Short, Key, EEcryptionCompression::Zlib), Encrypt(Short, Key));
+	/** CTR 密文近似随机, 用作压缩不下来的内容. */
+	TArray<uint8> Noise{};
+	EncryptCTR(TArrayView<const uint8>(MakeTestBytes(4096, 3)), Key, Noise);
+	TArray<uint8> Compressed{};
+	TArray<uint8> Plain{};
+	Encrypt(TArrayView<const uint8>(Noise), Key, Compressed, EEcryptionCompression::Zlib);
+	Encrypt(TArrayView<const uint8>(Noise), Key, Plain);
+	TestEqual(TEXT("Incompressible input is sealed as is"), Compressed, Plain);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionMalformedInputTest, "UnrealUtils.Ecryption.MalformedInput", EcryptionTestFlags)
+bool FEcryptionMalformedInputTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+
+	/** 来自外部的无效输入只返回失败, 不能触发 ensure(ensure 会使本测试失败). */
+	const FAES::FAESKey Key = MakeTestKey(41);
+	const FPreparedAESKey PreparedKey(Key);
+
+	FString OutOfRange;
+	for (int32 Index = 0; Index < 16; ++Index)
+	{
+		OutOfRange.AppendChar((TCHAR)0x4E00);
+	}
+	for (const TCHAR* Cipher : { TEXT(""), TEXT("abc"), TEXT("0123456789abcdefg"), *OutOfRange })
+	{
+		const FString CipherString(Cipher);
+		TestEqual(TEXT("Decrypt of a malformed cipher"), Decrypt(CipherString, Key), FString());
+		TArray<uint8> Bytes{};
+		TestFalse(TEXT("Decrypt(FStringView) of a malformed cipher"), Decrypt(FStringView(CipherString), PreparedKey, Bytes));
+		FEncryptedBlob Blob;
+		TestFalse(TEXT("FromLegacyString of a malformed cipher"), FEncryptedBlob::FromLegacyString(FStringView(CipherString), Blob));
+	}
+
+	/** 字符无效, 补齐错误, 长度不是 4 的倍数以及解码后不是整块. */
+	for (const TCHAR* Cipher : { TEXT(""), TEXT("abc"), TEXT("ab!d"), TEXT("a=bc"), TEXT("===="), TEXT("abcd"), TEXT("AAAAAAAAAAAAAAAAAAAAAAA="), TEXT("AAAAAAAAAAAAAAAAAAAAAAAA") })
+	{
+		const FString CipherString(Cipher);
+		TestEqual(TEXT("DecryptBase64 of a malformed cipher"), DecryptBase64(CipherString, Key), FString());
+		TestEqual(TEXT("DecryptGCMBase64 of a malformed cipher"), DecryptGCMBase64(CipherString, Key), FString());
+		FEncryptedBlob Blob;
+		TestFalse(TEXT("FromBase64 of a malformed cipher"), FEncryptedBlob::FromBase64(FStringView(CipherString), Blob));
+	}
+
+	for (int32 Size : { 0, 1, 15, 17, 28 })
+	{
+		const TArray<uint8> Cipher = MakeTestBytes(Size, 43);
+		TArray<uint8> Bytes{};
+		TestFalse(TEXT("DecryptCTR of a short cipher"), Size <= 16 && DecryptCTR(TArrayView<const uint8>(Cipher), Key, Bytes));
+		TestFalse(TEXT("DecryptGCM of a short or forged cipher"), DecryptGCM(TArrayView<const uint8>(Cipher), Key, Bytes));
+		TestFalse(TEXT("Decrypt(TArrayView) of a malformed cipher"), Decrypt(TArrayView<const uint8>(Cipher), Key, Bytes));
+		const FEncryptedBlob Blob{ TArray<uint8>(Cipher), EEncryptedBlobFormat::Envelope };
+		TestEqual(TEXT("DecryptBlobToString of a malformed blob"), DecryptBlobToString(Blob, Key), FString());
+	}
+
+	/**
+	 * 整块但被篡改的密文: 改动第一块以外的一个 Base64 字符, 只破坏对应的块, 信封头仍然有效,
+	 * 解出的 UTF-8 负载损坏或内容不同. 覆盖融合解密的多个分块.
+	 */
+	FString Plaintext;
+	for (int32 Index = 0; Index < 3000; ++Index)
+	{
+		Plaintext.AppendChar((TCHAR)(Index % 3 == 0 ? 0x4E00 + Index % 512 : TEXT('a') + Index % 26));
+	}
+	const FString Sealed64 = EncryptBase64(Plaintext, Key);
+	const int32 FirstChar = (int32)Base64::GetEncodedSize(FAES::AESBlockSize);
+	const int32 Step = FMath::Max(1, (Sealed64.Len() - 4 - FirstChar) / 40);
+	for (int32 Position = FirstChar; Position < Sealed64.Len() - 4; Position += Step)
+	{
+		FString Tampered64 = Sealed64;
+		TCHAR& Char = Tampered64.GetCharArray()[Position];
+		Char = Char == TEXT('A') ? TEXT('B') : TEXT('A');
+		TestNotEqual(FString::Printf(TEXT("DecryptBase64 with char %d changed"), Position), DecryptBase64(Tampered64, PreparedKey), Plaintext);
+	}
+
+	/** 信封头损坏(未知标记或旧格式的回退)以及损坏的压缩负载. */
+	TArray<uint8> Bytes{};
+	TArray<uint8> Sealed{};
+	Encrypt(FStringView(Plaintext), Key, Sealed);
+	for (int32 Position : { 0, 4, 5, 8, 15, 16, 100 })
+	{
+		TArray<uint8> Tampered = Sealed;
+		Tampered[Position] ^= 0x40;
+		Decrypt(TArrayView<const uint8>(Tampered), Key, Bytes);
+		const FEncryptedBlob Blob{ MoveTemp(Tampered), EEncryptedBlobFormat::Envelope };
+		TestNotEqual(FString::Printf(TEXT("DecryptBlobToString with byte %d changed"), Position), DecryptBlobToString(Blob, Key), Plaintext);
+	}
+	Encrypt(FStringView(Plaintext), Key, Sealed, EEcryptionCompression::Zlib);
+	for (int32 Position : { 16, 32, Sealed.Num() / 2, Sealed.Num() - 1 })
+	{
+		TArray<uint8> Tampered = Sealed;
+		Tampered[Position] ^= 0x40;
+		TestFalse(FString::Printf(TEXT("Decrypt of a compressed cipher with byte %d changed"), Position), Decrypt(TArrayView<const uint8>(Tampered), Key, Bytes));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionStatsTest, "UnrealUtils.Ecryption.Stats", EcryptionTestFlags)
+bool FEcryptionStatsTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FPreparedAESKey Key(MakeTestKey(47));
+
+	/** 清零后只做已知的调用, 快照中的计数和失败原因必须完全对上. 字符串按字符计, 字节按字节计. */
+	Stats::Reset();
+	const FString Cipher = Encrypt(TEXT("Hello"), Key);
+	Encrypt(TEXT("World"), Key);
+	TestEqual(TEXT("Decrypt"), Decrypt(Cipher, Key), FString(TEXT("Hello")));
+	TestEqual(TEXT("Decrypt of a malformed cipher"), Decrypt(FString(TEXT("abc")), Key), FString());
+
+	TArray<uint8> Bytes{};
+	TestFalse(TEXT("DecryptCTR of a short cipher"), DecryptCTR(TArrayView<const uint8>(MakeTestBytes(5, 1)), Key, Bytes));
+	TArray<uint8> Sealed{};
+	EncryptGCM(TArrayView<const uint8>(MakeTestBytes(20, 2)), Key, Sealed);
+	Sealed.Last() ^= 0x01;
+	TestFalse(TEXT("DecryptGCM of a tampered cipher"), DecryptGCM(TArrayView<const uint8>(Sealed), Key, Bytes));
+
+	const FString Json = Stats::GetSnapshotJson();
+	const auto TestContains = [&](const TCHAR* What, const TCHAR* Expected)
+	{
+		if (!TestTrue(What, Json.Find(Expected) != INDEX_NONE))
+		{
+			AddInfo(Json);
+		}
+	};
+	TestContains(TEXT("Encrypt counters"), TEXT("\"Encrypt\": {\"calls\": 2, \"failures\": 0, \"input\": 10, \"output\": 64, "));
+	TestContains(TEXT("Decrypt counters"), TEXT("\"Decrypt\": {\"calls\": 2, \"failures\": 1, \"input\": 35, \"output\": 5, \"failures_by_reason\": ")
+		TEXT("{\"invalid_argument\": 0, \"malformed_input\": 1, \"invalid_envelope\": 0, \"corrupt_payload\": 0, \"authentication_failed\": 0}"));
+	TestContains(TEXT("DecryptCTR counters"), TEXT("\"DecryptCTR\": {\"calls\": 1, \"failures\": 1, \"input\": 5, \"output\": 0, \"failures_by_reason\": ")
+		TEXT("{\"invalid_argument\": 0, \"malformed_input\": 1, "));
+	TestContains(TEXT("EncryptGCM counters"), TEXT("\"EncryptGCM\": {\"calls\": 1, \"failures\": 0, \"input\": 20, \"output\": 48, "));
+	TestContains(TEXT("DecryptGCM counters"), TEXT("\"DecryptGCM\": {\"calls\": 1, \"failures\": 1, \"input\": 48, \"output\": 0, \"failures_by_reason\": ")
+		TEXT("{\"invalid_argument\": 0, \"malformed_input\": 0, \"invalid_envelope\": 0, \"corrupt_payload\": 0, \"authentication_failed\": 1}"));
+	TestContains(TEXT("Functions that were not called"), TEXT("\"DecryptBase64\": {\"calls\": 0, \"failures\": 0, \"input\": 0, \"output\": 0, "));
+
+	/** Reset 之后重新从零开始. */
+	Stats::Reset();
+	TestTrue(TEXT("Reset clears the counters"), Stats::GetSnapshotJson().Find(TEXT("\"Encrypt\": {\"calls\": 0, ")) != INDEX_NONE);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionDecryptCacheTest, "UnrealUtils.Ecryption.DecryptCache", EcryptionTestFlags)
+bool FEcryptionDecryptCacheTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	IConsoleVariable* MaxBytes = IConsoleManager::Get().FindConsoleVariable(TEXT("Ecryption.DecryptCache.MaxBytes"));
+	if (!TestTrue(TEXT("Ecryption.DecryptCache.MaxBytes exists"), MaxBytes != nullptr))
+	{
+		return false;
+	}
+	const int32 PreviousMaxBytes = MaxBytes->GetInt();
+	MaxBytes->Set(1024 * 1024);
+
+	const FPreparedAESKey Key(MakeTestKey(37));
+	const FString Plaintext = TEXT("cached value");
+	const FString Cipher = EncryptBase64(Plaintext, Key);
+	const int64 StartHits = GetDecryptCacheStats().NumHits;
+	TestEqual(TEXT("First DecryptBase64"), DecryptBase64(Cipher, Key), Plaintext);
+	TestEqual(TEXT("Second DecryptBase64"), DecryptBase64(Cipher, Key), Plaintext);
+	TestEqual(TEXT("Second DecryptBase64 hits the cache"), GetDecryptCacheStats().NumHits, StartHits + 1);
+
+	const FString StringCipher = Encrypt(Plaintext, Key);
+	TestEqual(TEXT("First Decrypt"), Decrypt(StringCipher, Key), Plaintext);
+	TestEqual(TEXT("Second Decrypt"), Decrypt(StringCipher, Key), Plaintext);
+	TestEqual(TEXT("Second Decrypt hits the cache"), GetDecryptCacheStats().NumHits, StartHits + 2);
+
+	/** 不同的密钥不能命中. */
+	TestNotEqual(TEXT("DecryptBase64 with another key"), DecryptBase64(Cipher, FPreparedAESKey(MakeTestKey(38))), Plaintext);
+	TestEqual(TEXT("Another key does not hit the cache"), GetDecryptCacheStats().NumHits, StartHits + 2);
+
+	/** 设为 0 时清空并关闭. */
+	TestTrue(TEXT("Cache holds entries"), GetDecryptCacheStats().NumEntries > 0);
+	MaxBytes->Set(0);
+	TestEqual(TEXT("MaxBytes 0 empties the cache"), GetDecryptCacheStats().NumEntries, (int64)0);
+	TestEqual(TEXT("Decrypt with the cache disabled"), DecryptBase64(Cipher, Key), Plaintext);
+	TestEqual(TEXT("Disabled cache does not hit"), GetDecryptCacheStats().NumHits, StartHits + 2);
+
+	MaxBytes->Set(PreviousMaxBytes);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionInPlaceTest, "UnrealUtils.Ecryption.InPlace", EcryptionTestFlags)
+bool FEcryptionInPlaceTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(43);
+	const FPreparedAESKey PreparedKey(Key);
+
+	for (int32 Size : { 1, 4, 15, 16, 17, 100, 4096, 65537 })
+	{
+		const TArray<uint8> Plaintext = MakeTestBytes(Size, (uint8)Size);
+		TArray<uint8> Cipher{};
+		Encrypt(TArrayView<const uint8>(Plaintext), Key, Cipher);
+
+		TArray<uint8> InPlace = Plaintext;
+		TestTrue(TEXT("EncryptInPlace"), EncryptInPlace(InPlace, Key));
+		TestEqual(FString::Printf(TEXT("EncryptInPlace of %d bytes matches Encrypt"), Size), InPlace, Cipher);
+		TestTrue(TEXT("DecryptInPlace"), DecryptInPlace(InPlace, Key));
+		TestEqual(FString::Printf(TEXT("DecryptInPlace(EncryptInPlace) of %d bytes"), Size), InPlace, Plaintext);
+		TestTrue(TEXT("EncryptInPlace with a prepared key"), EncryptInPlace(InPlace, PreparedKey));
+		TestTrue(TEXT("DecryptInPlace with a prepared key"), DecryptInPlace(InPlace, PreparedKey));
+		TestEqual(TEXT("DecryptInPlace(EncryptInPlace) with a prepared key"), InPlace, Plaintext);
+	}
+
+	/** 空余容量足够时不重新分配. */
+	TArray<uint8> Reserved{};
+	Reserved.Reserve(1024);
+	Reserved.Append(MakeTestBytes(100, 7));
+	const uint8* ReservedData = Reserved.GetData();
+	TestTrue(TEXT("EncryptInPlace into spare capacity"), EncryptInPlace(Reserved, Key));
+	TestTrue(TEXT("DecryptInPlace of spare capacity"), DecryptInPlace(Reserved, Key));
+	TestTrue(TEXT("EncryptInPlace reuses the allocation"), Reserved.GetData() == ReservedData);
+	TestEqual(TEXT("DecryptInPlace(EncryptInPlace) in spare capacity"), Reserved, MakeTestBytes(100, 7));
+
+	/** 压缩过的密文也能原地解密. */
+	FString Json;
+	for (int32 Index = 0; Index < 200; ++Index)
+	{
+		Json += FString::Printf(TEXT("{\"id\": %d, \"name\": \"item\"},"), Index % 10);
+	}
+	TArray<uint8> Compressed{};
+	TestTrue(TEXT("Encrypt with compression"), Encrypt(FStringView(Json), Key, Compressed, EEcryptionCompression::Zlib));
+	TArray<uint8> Expected{};
+	Decrypt(TArrayView<const uint8>(Compressed), Key, Expected);
+	TestTrue(TEXT("DecryptInPlace of a compressed cipher"), DecryptInPlace(Compressed, Key));
+	TestEqual(TEXT("DecryptInPlace of a compressed cipher"), Compressed, Expected);
+
+	/** 长度无效时不修改数组, 其他失败时清空数组. 都不能触发 ensure. */
+	for (int32 Size : { 0, 5, 17, 33 })
+	{
+		TArray<uint8> Malformed = MakeTestBytes(Size, 3);
+		TestFalse(FString::Printf(TEXT("DecryptInPlace of %d bytes"), Size), DecryptInPlace(Malformed, Key));
+		TestEqual(FString::Printf(TEXT("DecryptInPlace of %d bytes leaves the array untouched"), Size), Malformed, MakeTestBytes(Size, 3));
+	}
+	TArray<uint8> WrongKey = MakeTestBytes(40, 9);
+	EncryptInPlace(WrongKey, Key);
+	TestFalse(TEXT("DecryptInPlace with another key"), DecryptInPlace(WrongKey, MakeTestKey(44)));
+	TestEqual(TEXT("DecryptInPlace with another key empties the array"), WrongKey.Num(), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionMoveInputTest, "UnrealUtils.Ecryption.MoveInput", EcryptionTestFlags)
+bool FEcryptionMoveInputTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(47);
+	const FPreparedAESKey PreparedKey(Key);
+
+	/** 与 const FString& 的版本结果相同. */
+	for (const FString& Plaintext : MakeTestStrings())
+	{
+		const FString Cipher = Encrypt(Plaintext, Key);
+		const FString CipherBase64 = EncryptBase64(Plaintext, Key);
+		TestEqual(TEXT("Encrypt(FString&&)"), Encrypt(FString(Plaintext), Key), Cipher);
+		TestEqual(TEXT("Encrypt(FString&&) with a prepared key"), Encrypt(FString(Plaintext), PreparedKey), Cipher);
+		TestEqual(TEXT("EncryptBase64(FString&&)"), EncryptBase64(FString(Plaintext), Key), CipherBase64);
+		TestEqual(TEXT("EncryptBase64(FString&&) with a prepared key"), EncryptBase64(FString(Plaintext), PreparedKey), CipherBase64);
+	}
+
+	/** 空余容量足够时直接在输入的内存上写出密文, 输入之后为空. */
+	const FString Plaintext = TEXT("temporary value");
+	FString Input = Plaintext;
+	Input.Reserve(256);
+	const TCHAR* InputData = Input.GetCharArray().GetData();
+	const FString Cipher = Encrypt(MoveTemp(Input), PreparedKey);
+	TestTrue(TEXT("Encrypt(FString&&) reuses the input's allocation"), Cipher.GetCharArray().GetData() == InputData);
+	TestTrue(TEXT("Encrypt(FString&&) leaves the input empty"), Input.IsEmpty());
+	TestEqual(TEXT("Decrypt(Encrypt(FString&&))"), Decrypt(Cipher, PreparedKey), Plaintext);
+
+	FString InputBase64 = Plaintext;
+	InputBase64.Reserve(256);
+	const TCHAR* InputBase64Data = InputBase64.GetCharArray().GetData();
+	const FString CipherBase64 = EncryptBase64(MoveTemp(InputBase64), PreparedKey);
+	TestTrue(TEXT("EncryptBase64(FString&&) reuses the input's allocation"), CipherBase64.GetCharArray().GetData() == InputBase64Data);
+	TestTrue(TEXT("EncryptBase64(FString&&) leaves the input empty"), InputBase64.IsEmpty());
+	TestEqual(TEXT("DecryptBase64(EncryptBase64(FString&&))"), DecryptBase64(CipherBase64, PreparedKey), Plaintext);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionLegacySplitSymbolTest, "UnrealUtils.Ecryption.LegacySplitSymbol", EcryptionTestFlags)
+bool FEcryptionLegacySplitSymbolTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FAES::FAESKey Key = MakeTestKey(53);
+
+	/** 按旧格式加密: 明文后接垃圾符号, 补齐到 16 的倍数后按 StringToBytes 映射再加密. */
+	const FString SplitSymbol = TEXT("52168@E4B9!13Fe-33!B0D9CF6!$@!~");
+	const auto SealLegacy = [&Key, &SplitSymbol](const FString& Plaintext)
+	{
+		FString Padded = Plaintext + SplitSymbol;
+		while (Padded.Len() % FAES::AESBlockSize != 0)
+		{
+			Padded.AppendChar(TEXT('#'));
+		}
+		TArray<uint8> Bytes{};
+		Bytes.AddUninitialized(Padded.Len());
+		StringToBytes(Padded, Bytes.GetData(), Bytes.Num());
+		FAES::EncryptData(Bytes.GetData(), Bytes.Num(), Key);
+		return BytesToString(Bytes.GetData(), Bytes.Num());
+	};
+
+	/** 垃圾符号落在 16/32 字节向量的各个位置上, 包括跨越向量边界. */
+	for (int32 Size = 1; Size <= 100; ++Size)
+	{
+		FString Plaintext;
+		for (int32 Index = 0; Index < Size; ++Index)
+		{
+			Plaintext.AppendChar((TCHAR)(TEXT('a') + Index % 26));
+		}
+		TestEqual(FString::Printf(TEXT("Legacy payload of %d chars"), Size), Decrypt(SealLegacy(Plaintext), Key), Plaintext);
+	}
+
+	/** 只有首尾字符或前缀与垃圾符号相同的片段不能被当成分隔. */
+	const FString Decoys[] =
+	{
+		SplitSymbol.Left(1) + TEXT("xxxxxxxxxxxxxxxxxxxxxxxxxxxxx") + SplitSymbol.Mid(SplitSymbol.Len() - 1, 1),
+		SplitSymbol.Left(SplitSymbol.Len() - 1) + TEXT("x"),
+		SplitSymbol.Left(16),
+		TEXT("5") + SplitSymbol.Left(SplitSymbol.Len() - 1),
+	};
+	for (const FString& Decoy : Decoys)
+	{
+		for (int32 Prefix = 0; Prefix < 40; Prefix += 3)
+		{
+			FString Plaintext;
+			for (int32 Index = 0; Index < Prefix; ++Index)
+			{
+				Plaintext.AppendChar(TEXT('p'));
+			}
+			Plaintext += Decoy + Decoy + TEXT("tail");
+			TestEqual(FString::Printf(TEXT("Legacy payload with a decoy at %d"), Prefix), Decrypt(SealLegacy(Plaintext), Key), Plaintext);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEcryptionMultiBufferTest, "UnrealUtils.Ecryption.MultiBuffer", EcryptionTestFlags)
+bool FEcryptionMultiBufferTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealUtils::Common;
+	const FPreparedAESKey Key(MakeTestKey(59));
+
+	/** 各路长度不同, 路数从 1 到 MaxMultiBufferLanes, 每条与单独加解密的结果相同. */
+	for (int32 NumBuffers = 1; NumBuffers <= AESKernel::MaxMultiBufferLanes; ++NumBuffers)
+	{
+		TArray<TArray<uint8>> Buffers{};
+		uint8* Contents[AESKernel::MaxMultiBufferLanes];
+		uint64 NumBytes[AESKernel::MaxMultiBufferLanes];
+		for (int32 Lane = 0; Lane < NumBuffers; ++Lane)
+		{
+			Buffers.Add(MakeTestBytes(FAES::AESBlockSize * (1 + (Lane * 3 + NumBuffers) % 8), (uint8)(Lane + NumBuffers)));
+		}
+		for (int32 Lane = 0; Lane < NumBuffers; ++Lane)
+		{
+			Contents[Lane] = Buffers[Lane].GetData();
+			NumBytes[Lane] = Buffers[Lane].Num();
+		}
+		const TArray<TArray<uint8>> Plaintexts = Buffers;
+
+		AESKernel::EncryptDataMulti(Contents, NumBytes, NumBuffers, Key);
+		for (int32 Lane = 0; Lane < NumBuffers; ++Lane)
+		{
+			TArray<uint8> Expected = Plaintexts[Lane];
+			AESKernel::EncryptData(Expected.GetData(), Expected.Num(), Key);
+			TestEqual(FString::Printf(TEXT("EncryptDataMulti of %d buffers, lane %d"), NumBuffers, Lane), Buffers[Lane], Expected);
+		}
+		AESKernel::DecryptDataMulti(Contents, NumBytes, NumBuffers, Key);
+		for (int32 Lane = 0; Lane < NumBuffers; ++Lane)
+		{
+			TestEqual(FString::Printf(TEXT("DecryptDataMulti of %d buffers, lane %d"), NumBuffers, Lane), Buffers[Lane], Plaintexts[Lane]);
+		}
+	}
+
+	/** 批量解密中一组短消息里有损坏的条目时, 只有该条目失败. */
+	TArray<FString> Inputs{};
+	for (int32 Index = 0; Index < 20; ++Index)
+	{
+		Inputs.Add(FString::Printf(TEXT("short %d"), Index));
+	}
+	TArray<FString> Ciphers{};
+	for (const FString& Input : Inputs)
+	{
+		Ciphers.Add(Encrypt(Input, Key));
+	}
+	Ciphers[5] = Encrypt(Inputs[5], FPreparedAESKey(MakeTestKey(60)));
+	Ciphers[11] = TEXT("abc");
+	TEcryptionBatch<TCHAR> Decrypted;
+	TestFalse(TEXT("DecryptBatch with bad items"), DecryptBatch(Ciphers, Key, Decrypted));
+	for (int32 Index = 0; Index < Inputs.Num(); ++Index)
+	{
+		const FString Result(Decrypted[Index].Num(), Decrypted[Index].GetData());
+		TestEqual(FString::Printf(TEXT("DecryptBatch item %d"), Index), Result, Index == 5 || Index == 11 ? FString() : Inputs[Index]);
+	}
+
+	/** 窗口中混合短消息和立即加密的长消息, 结果与逐条调用相同; Flush 之前和析构时都会写出等待的消息. */
+	TArray<FString> WindowInputs{};
+	for (int32 Index = 0; Index < 19; ++Index)
+	{
+		WindowInputs.Add(Index % 7 == 3 ? MakeTestStrings().Last() : FString::Printf(TEXT("window %d"), Index));
+	}
+	TArray<FString> WindowCiphers{};
+	TArray<FString> WindowBase64{};
+	WindowCiphers.SetNum(WindowInputs.Num());
+	WindowBase64.SetNum(WindowInputs.Num());
+	{
+		FEncryptWindow Window(Key);
+		Window.Encrypt(FStringView(WindowInputs[0]), WindowCiphers[0]);
+		Window.Flush();
+		TestEqual(TEXT("FEncryptWindow::Flush writes the pending message"), WindowCiphers[0], Encrypt(WindowInputs[0], Key));
+		for (int32 Index = 1; Index < WindowInputs.Num(); ++Index)
+		{
+			Window.Encrypt(FStringView(WindowInputs[Index]), WindowCiphers[Index]);
+			Window.EncryptBase64(FStringView(WindowInputs[Index]), WindowBase64[Index]);
+		}
+	}
+	for (int32 Index = 1; Index < WindowInputs.Num(); ++Index)
+	{
+		TestEqual(FString::Printf(TEXT("FEncryptWindow::Encrypt item %d"), Index), WindowCiphers[Index], Encrypt(WindowInputs[Index], Key));
+		TestEqual(FString::Printf(TEXT("FEncryptWindow::EncryptBase64 item %d"), Index), WindowBase64[Index], EncryptBase64(WindowInputs[Index], Key));
+	}
+	return true;
+}
+
+#endif
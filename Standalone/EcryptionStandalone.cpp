@@ -0,0 +1,95 @@
+// EcryptionStandalone.cpp
+// 在引擎外构建和运行 Ecryption 模块: 冒烟测试, 自动化测试(Ecryption/Tests)和快速基准, 便于在 perf/valgrind 下分析.
+// 用法: EcryptionStandalone [test | bench [OutputPath] | bench-full [OutputPath]]
+
+#include "Ecryption.h"
+#include "EcryptionAES.h"
+#include "EcryptionBenchmark.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CoreDelegates.h"
+
+namespace
+{
+	FAES::FAESKey MakeStandaloneKey()
+	{
+		FAES::FAESKey Key;
+		for (int32 Index = 0; Index < FAES::FAESKey::KeySize; ++Index)
+		{
+			Key.Key[Index] = (uint8)(Index * 7 + 3);
+		}
+		return Key;
+	}
+
+	int32 NumFailures = 0;
+
+	void Expect(bool bCondition, const char* What, int32 Size)
+	{
+		if (!bCondition)
+		{
+			fprintf(stderr, "FAILED: %s (size %d)\n", What, Size);
+			++NumFailures;
+		}
+	}
+
+	/** 各个长度上的往返, 以及 AES-NI 内核与 FAES 的逐字节比较. */
+	int32 RunSmokeTest()
+	{
+		using namespace UnrealUtils::Common;
+		const FAES::FAESKey Key = MakeStandaloneKey();
+		const FPreparedAESKey PreparedKey(Key);
+
+		for (int32 Size : { 1, 2, 15, 16, 17, 100, 1000, 4096, 65537, 1 << 20 })
+		{
+			FString Plaintext;
+			Plaintext.Reserve(Size);
+			for (int32 Index = 0; Index < Size; ++Index)
+			{
+				Plaintext.AppendChar((TCHAR)(Index % 3 == 0 ? 0x4E00 + Index % 512 : 'a' + Index % 26));
+			}
+
+			Expect(Decrypt(Encrypt(Plaintext, Key), Key) == Plaintext, "Encrypt/Decrypt round trip", Size);
+			Expect(DecryptBase64(EncryptBase64(Plaintext, PreparedKey), PreparedKey) == Plaintext, "EncryptBase64/DecryptBase64 round trip", Size);
+
+			TArray<uint8> Blocks;
+			Blocks.SetNumUninitialized(Align(Size, FAES::AESBlockSize));
+			for (int32 Index = 0; Index < Blocks.Num(); ++Index)
+			{
+				Blocks[Index] = (uint8)(Index * 31 + Size);
+			}
+			TArray<uint8> Reference = Blocks;
+			AESKernel::EncryptData(Blocks.GetData(), Blocks.Num(), PreparedKey);
+			FAES::EncryptData(Reference.GetData(), Reference.Num(), Key);
+			Expect(Blocks == Reference, "AES kernel matches FAES", Size);
+		}
+
+		Expect(GStandaloneNumEnsureFailures == 0, "no ensure fired", 0);
+		printf("%s (AES-NI: %s)\n", NumFailures == 0 ? "Smoke test passed" : "Smoke test FAILED", AESKernel::HasHardwareSupport() ? "yes" : "no");
+		return NumFailures == 0 ? 0 : 1;
+	}
+}
+
+int main(int ArgC, char** ArgV)
+{
+	const std::string Mode = ArgC > 1 ? ArgV[1] : "test";
+	int32 ExitCode = 0;
+	if (Mode == "test")
+	{
+		ExitCode = RunSmokeTest();
+		const int32 NumFailedTests = FAutomationTestFramework::Get().RunTestsStandalone(TEXT("UnrealUtils.Ecryption"));
+		printf("%s\n", NumFailedTests == 0 ? "Automation tests passed" : "Automation tests FAILED");
+		ExitCode = ExitCode == 0 && NumFailedTests == 0 ? 0 : 1;
+	}
+	else if (Mode == "bench" || Mode == "bench-full")
+	{
+		const FString OutputPath = ArgC > 2 ? FString::FromUTF8(ArgV[2]) : FString(TEXT("bench_output.txt"));
+		UnrealUtils::Common::BenchmarkAESKernels(Mode == "bench");
+		UnrealUtils::Common::BenchmarkEcryption(OutputPath, Mode == "bench");
+	}
+	else
+	{
+		fprintf(stderr, "Usage: %s [test | bench [OutputPath] | bench-full [OutputPath]]\n", ArgV[0]);
+		ExitCode = 2;
+	}
+	FCoreDelegates::OnPreExit.Broadcast();
+	return ExitCode;
+}
@@ -0,0 +1,53 @@
+// Future.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <future>
+
+template <typename ResultType>
+class TFuture
+{
+public:
+	TFuture() {}
+	explicit TFuture(std::shared_future<ResultType>&& InState) : State(MoveTemp(InState)) {}
+
+	bool IsValid() const { return State.valid(); }
+	bool IsReady() const { return State.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+	void Wait() const { State.wait(); }
+	const ResultType& Get() const { return State.get(); }
+
+	ResultType Consume()
+	{
+		ResultType Result = State.get();
+		State = std::shared_future<ResultType>();
+		return Result;
+	}
+
+private:
+	std::shared_future<ResultType> State;
+};
+
+template <typename ResultType>
+class TPromise
+{
+public:
+	TPromise() {}
+	TPromise(TPromise&&) = default;
+	TPromise& operator=(TPromise&&) = default;
+
+	TFuture<ResultType> GetFuture() { return TFuture<ResultType>(Promise.get_future().share()); }
+	void SetValue(const ResultType& Result) { Promise.set_value(Result); }
+	void SetValue(ResultType&& Result) { Promise.set_value(MoveTemp(Result)); }
+
+private:
+	std::promise<ResultType> Promise;
+};
+
+template <typename ResultType, typename ArgType>
+TPromise<ResultType> MakeFulfilledPromise(ArgType&& Arg)
+{
+	TPromise<ResultType> Promise;
+	Promise.SetValue(ResultType(Forward<ArgType>(Arg)));
+	return Promise;
+}
@@ -0,0 +1,42 @@
+// ParallelFor.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <thread>
+
+enum class EParallelForFlags
+{
+	None = 0,
+	ForceSingleThread = 1,
+	Unbalanced = 2,
+	BackgroundPriority = 4,
+};
+
+/** 每次调用临时启动线程, 调用线程也参与; 不像引擎那样复用任务图的工作线程. */
+template <typename BodyType>
+void ParallelFor(int32 Num, BodyType&& Body, EParallelForFlags Flags = EParallelForFlags::None)
+{
+	const int32 NumThreads = FMath::Min<int32>(Num, (int32)FMath::Max(1u, std::thread::hardware_concurrency()));
+	if (NumThreads <= 1 || Flags == EParallelForFlags::ForceSingleThread)
+	{
+		for (int32 Index = 0; Index < Num; ++Index) { Body(Index); }
+		return;
+	}
+
+	std::atomic<int32> NextIndex{ 0 };
+	const auto Worker = [&]()
+	{
+		for (int32 Index = NextIndex++; Index < Num; Index = NextIndex++) { Body(Index); }
+	};
+	std::vector<std::thread> Threads;
+	for (int32 Thread = 1; Thread < NumThreads; ++Thread) { Threads.emplace_back(Worker); }
+	Worker();
+	for (std::thread& Thread : Threads) { Thread.join(); }
+}
+
+template <typename BodyType>
+void ParallelFor(int32 Num, BodyType&& Body, bool bForceSingleThread)
+{
+	ParallelFor(Num, Forward<BodyType>(Body), bForceSingleThread ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
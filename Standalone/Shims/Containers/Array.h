@@ -0,0 +1,233 @@
+// Array.h
+
+#pragma once
+
+/** 只支持可以逐个移动构造的元素, 内存来自 FMemory(即 GMalloc). */
+template <typename InElementType>
+class TArray
+{
+public:
+	typedef int32 SizeType;
+	typedef InElementType ElementType;
+
+	TArray() {}
+	TArray(std::initializer_list<ElementType> InitList) { for (const ElementType& Element : InitList) { Add(Element); } }
+	TArray(const ElementType* Ptr, int32 Count) { Append(Ptr, Count); }
+	TArray(const TArray& Other) { Append(Other.AllocatorData, Other.ArrayNum); }
+	TArray(TArray&& Other) : AllocatorData(Other.AllocatorData), ArrayNum(Other.ArrayNum), ArrayMax(Other.ArrayMax)
+	{
+		Other.AllocatorData = nullptr;
+		Other.ArrayNum = Other.ArrayMax = 0;
+	}
+	~TArray() { Release(); }
+
+	TArray& operator=(const TArray& Other)
+	{
+		if (this != &Other)
+		{
+			Reset(Other.ArrayNum);
+			Append(Other.AllocatorData, Other.ArrayNum);
+		}
+		return *this;
+	}
+
+	TArray& operator=(TArray&& Other)
+	{
+		if (this != &Other)
+		{
+			Release();
+			AllocatorData = Other.AllocatorData;
+			ArrayNum = Other.ArrayNum;
+			ArrayMax = Other.ArrayMax;
+			Other.AllocatorData = nullptr;
+			Other.ArrayNum = Other.ArrayMax = 0;
+		}
+		return *this;
+	}
+
+	int32 Num() const { return ArrayNum; }
+	int32 Max() const { return ArrayMax; }
+	int32 GetSlack() const { return ArrayMax - ArrayNum; }
+	SIZE_T GetAllocatedSize() const { return (SIZE_T)ArrayMax * sizeof(ElementType); }
+	ElementType* GetData() { return AllocatorData; }
+	const ElementType* GetData() const { return AllocatorData; }
+	bool IsEmpty() const { return ArrayNum == 0; }
+	bool IsValidIndex(int32 Index) const { return Index >= 0 && Index < ArrayNum; }
+	ElementType& operator[](int32 Index) { check(IsValidIndex(Index)); return AllocatorData[Index]; }
+	const ElementType& operator[](int32 Index) const { check(IsValidIndex(Index)); return AllocatorData[Index]; }
+	ElementType& Last() { check(ArrayNum > 0); return AllocatorData[ArrayNum - 1]; }
+	const ElementType& Last() const { check(ArrayNum > 0); return AllocatorData[ArrayNum - 1]; }
+
+	void Reserve(int32 Number) { if (Number > ArrayMax) { ResizeTo(Number); } }
+	void Shrink() {}
+
+	void Empty(int32 Slack = 0)
+	{
+		DestructItems(0, ArrayNum);
+		ArrayNum = 0;
+		if (ArrayMax != Slack)
+		{
+			Release();
+			if (Slack > 0) { ResizeTo(Slack); }
+		}
+	}
+
+	void Reset(int32 NewSize = 0)
+	{
+		DestructItems(0, ArrayNum);
+		ArrayNum = 0;
+		Reserve(NewSize);
+	}
+
+	int32 AddUninitialized(int32 Count = 1)
+	{
+		const int32 OldNum = ArrayNum;
+		if (ArrayNum + Count > ArrayMax)
+		{
+			ResizeTo(FMath::Max(ArrayNum + Count, ArrayMax + ArrayMax / 2 + 4));
+		}
+		ArrayNum += Count;
+		return OldNum;
+	}
+
+	int32 AddZeroed(int32 Count = 1)
+	{
+		const int32 Index = AddUninitialized(Count);
+		memset((void*)(AllocatorData + Index), 0, sizeof(ElementType) * Count);
+		return Index;
+	}
+
+	void SetNumUninitialized(int32 NewNum, bool = true)
+	{
+		if (NewNum > ArrayNum) { AddUninitialized(NewNum - ArrayNum); }
+		else { ArrayNum = NewNum; }
+	}
+
+	void SetNumZeroed(int32 NewNum, bool = true)
+	{
+		if (NewNum > ArrayNum) { AddZeroed(NewNum - ArrayNum); }
+		else { ArrayNum = NewNum; }
+	}
+
+	void SetNum(int32 NewNum, bool = true)
+	{
+		if (NewNum > ArrayNum)
+		{
+			const int32 Index = AddUninitialized(NewNum - ArrayNum);
+			for (int32 Item = Index; Item < NewNum; ++Item) { new (AllocatorData + Item) ElementType(); }
+		}
+		else
+		{
+			DestructItems(NewNum, ArrayNum - NewNum);
+			ArrayNum = NewNum;
+		}
+	}
+
+	int32 Add(const ElementType& Item) { const int32 Index = AddUninitialized(1); new (AllocatorData + Index) ElementType(Item); return Index; }
+	int32 Add(ElementType&& Item) { const int32 Index = AddUninitialized(1); new (AllocatorData + Index) ElementType(MoveTemp(Item)); return Index; }
+
+	template <typename... ArgsType>
+	int32 Emplace(ArgsType&&... Args)
+	{
+		const int32 Index = AddUninitialized(1);
+		new (AllocatorData + Index) ElementType(Forward<ArgsType>(Args)...);
+		return Index;
+	}
+
+	template <typename... ArgsType>
+	ElementType& Emplace_GetRef(ArgsType&&... Args) { return AllocatorData[Emplace(Forward<ArgsType>(Args)...)]; }
+
+	void Append(const ElementType* Ptr, int32 Count)
+	{
+		const int32 Index = AddUninitialized(Count);
+		for (int32 Item = 0; Item < Count; ++Item) { new (AllocatorData + Index + Item) ElementType(Ptr[Item]); }
+	}
+
+	void Append(const TArray& Source) { Append(Source.AllocatorData, Source.ArrayNum); }
+
+	void RemoveAt(int32 Index, int32 Count = 1)
+	{
+		for (int32 Item = Index; Item < ArrayNum - Count; ++Item) { AllocatorData[Item] = MoveTemp(AllocatorData[Item + Count]); }
+		DestructItems(ArrayNum - Count, Count);
+		ArrayNum -= Count;
+	}
+
+	void RemoveAtSwap(int32 Index)
+	{
+		if (Index != ArrayNum - 1) { AllocatorData[Index] = MoveTemp(AllocatorData[ArrayNum - 1]); }
+		DestructItems(ArrayNum - 1, 1);
+		--ArrayNum;
+	}
+
+	int32 RemoveSingleSwap(const ElementType& Item)
+	{
+		const int32 Index = Find(Item);
+		if (Index == INDEX_NONE) { return 0; }
+		RemoveAtSwap(Index);
+		return 1;
+	}
+
+	ElementType Pop()
+	{
+		ElementType Result = MoveTemp(AllocatorData[ArrayNum - 1]);
+		DestructItems(ArrayNum - 1, 1);
+		--ArrayNum;
+		return Result;
+	}
+
+	int32 Find(const ElementType& Item) const
+	{
+		for (int32 Index = 0; Index < ArrayNum; ++Index) { if (AllocatorData[Index] == Item) { return Index; } }
+		return INDEX_NONE;
+	}
+
+	bool Contains(const ElementType& Item) const { return Find(Item) != INDEX_NONE; }
+
+	template <typename PredicateType>
+	void Sort(PredicateType Predicate) { std::sort(AllocatorData, AllocatorData + ArrayNum, Predicate); }
+
+	bool operator==(const TArray& Other) const
+	{
+		if (ArrayNum != Other.ArrayNum) { return false; }
+		for (int32 Index = 0; Index < ArrayNum; ++Index) { if (!(AllocatorData[Index] == Other.AllocatorData[Index])) { return false; } }
+		return true;
+	}
+	bool operator!=(const TArray& Other) const { return !(*this == Other); }
+
+	ElementType* begin() { return AllocatorData; }
+	ElementType* end() { return AllocatorData + ArrayNum; }
+	const ElementType* begin() const { return AllocatorData; }
+	const ElementType* end() const { return AllocatorData + ArrayNum; }
+
+private:
+	void ResizeTo(int32 NewMax)
+	{
+		constexpr uint32 Alignment = alignof(ElementType) > 16 ? alignof(ElementType) : 16;
+		ElementType* NewData = (ElementType*)FMemory::Malloc(sizeof(ElementType) * NewMax, Alignment);
+		for (int32 Index = 0; Index < ArrayNum; ++Index)
+		{
+			new (NewData + Index) ElementType(MoveTemp(AllocatorData[Index]));
+			AllocatorData[Index].~ElementType();
+		}
+		FMemory::Free(AllocatorData);
+		AllocatorData = NewData;
+		ArrayMax = NewMax;
+	}
+
+	void DestructItems(int32 Index, int32 Count)
+	{
+		for (int32 Item = Index; Item < Index + Count; ++Item) { AllocatorData[Item].~ElementType(); }
+	}
+
+	void Release()
+	{
+		DestructItems(0, ArrayNum);
+		FMemory::Free(AllocatorData);
+		AllocatorData = nullptr;
+		ArrayNum = ArrayMax = 0;
+	}
+
+	ElementType* AllocatorData = nullptr;
+	int32 ArrayNum = 0;
+	int32 ArrayMax = 0;
+};
@@ -0,0 +1,41 @@
+// ArrayView.h
+
+#pragma once
+
+template <typename InElementType>
+class TArrayView
+{
+public:
+	typedef InElementType ElementType;
+	typedef std::remove_const_t<InElementType> NonConstElementType;
+
+	TArrayView() {}
+	TArrayView(ElementType* InData, int32 InCount) : DataPtr(InData), ArrayNum(InCount) {}
+	TArrayView(const TArray<NonConstElementType>& Other) : DataPtr(Other.GetData()), ArrayNum(Other.Num()) {}
+	TArrayView(TArray<NonConstElementType>& Other) : DataPtr(Other.GetData()), ArrayNum(Other.Num()) {}
+
+	template <typename OtherElementType, typename = std::enable_if_t<std::is_convertible_v<OtherElementType*, ElementType*>>>
+	TArrayView(const TArrayView<OtherElementType>& Other) : DataPtr(Other.GetData()), ArrayNum(Other.Num()) {}
+
+	ElementType* GetData() const { return DataPtr; }
+	int32 Num() const { return ArrayNum; }
+	bool IsEmpty() const { return ArrayNum == 0; }
+	ElementType& operator[](int32 Index) const { check(Index >= 0 && Index < ArrayNum); return DataPtr[Index]; }
+
+	TArrayView Slice(int32 Index, int32 InNum) const { check(Index >= 0 && InNum >= 0 && Index + InNum <= ArrayNum); return TArrayView(DataPtr + Index, InNum); }
+	TArrayView Left(int32 Count) const { return TArrayView(DataPtr, FMath::Clamp(Count, 0, ArrayNum)); }
+	TArrayView RightChop(int32 Count) const { Count = FMath::Clamp(Count, 0, ArrayNum); return TArrayView(DataPtr + Count, ArrayNum - Count); }
+
+	ElementType* begin() const { return DataPtr; }
+	ElementType* end() const { return DataPtr + ArrayNum; }
+
+private:
+	ElementType* DataPtr = nullptr;
+	int32 ArrayNum = 0;
+};
+
+template <typename ElementType> using TConstArrayView = TArrayView<const ElementType>;
+
+template <typename ElementType> TArrayView<ElementType> MakeArrayView(ElementType* Pointer, int32 Size) { return TArrayView<ElementType>(Pointer, Size); }
+template <typename ElementType> TArrayView<ElementType> MakeArrayView(TArray<ElementType>& Other) { return TArrayView<ElementType>(Other); }
+template <typename ElementType> TArrayView<const ElementType> MakeArrayView(const TArray<ElementType>& Other) { return TArrayView<const ElementType>(Other); }
@@ -0,0 +1,20 @@
+// Map.h
+
+#pragma once
+
+#include <unordered_map>
+
+/** 只有 EcryptionCache 用到的查找, 添加和删除. */
+template <typename KeyType, typename ValueType>
+class TMap
+{
+public:
+	ValueType* Find(const KeyType& Key) { auto It = Pairs.find(Key); return It != Pairs.end() ? &It->second : nullptr; }
+	const ValueType* Find(const KeyType& Key) const { auto It = Pairs.find(Key); return It != Pairs.end() ? &It->second : nullptr; }
+	ValueType& Add(const KeyType& Key, const ValueType& Value) { return Pairs[Key] = Value; }
+	int32 Remove(const KeyType& Key) { return (int32)Pairs.erase(Key); }
+	int32 Num() const { return (int32)Pairs.size(); }
+
+private:
+	std::unordered_map<KeyType, ValueType> Pairs;
+};
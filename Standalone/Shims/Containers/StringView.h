@@ -0,0 +1,30 @@
+// StringView.h
+
+#pragma once
+
+template <typename InCharType>
+class TStringView
+{
+public:
+	typedef InCharType ElementType;
+
+	TStringView() {}
+	TStringView(const ElementType* InData, int32 InSize) : DataPtr(InData), Size(InSize) {}
+	TStringView(const ElementType* InData) : DataPtr(InData) { while (InData != nullptr && InData[Size] != 0) { ++Size; } }
+	TStringView(const FString& String) : DataPtr(*String), Size(String.Len()) {}
+
+	const ElementType* GetData() const { return DataPtr; }
+	int32 Len() const { return Size; }
+	bool IsEmpty() const { return Size == 0; }
+	ElementType operator[](int32 Index) const { check(Index >= 0 && Index < Size); return DataPtr[Index]; }
+	TStringView Mid(int32 Position, int32 CharCount) const { return TStringView(DataPtr + Position, CharCount); }
+
+	const ElementType* begin() const { return DataPtr; }
+	const ElementType* end() const { return DataPtr + Size; }
+
+private:
+	const ElementType* DataPtr = nullptr;
+	int32 Size = 0;
+};
+
+typedef TStringView<TCHAR> FStringView;
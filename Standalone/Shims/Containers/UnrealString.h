@@ -0,0 +1,214 @@
+// UnrealString.h
+
+#pragma once
+
+enum class ESearchCase { CaseSensitive, IgnoreCase };
+enum class ESearchDir { FromStart, FromEnd };
+
+/** 与引擎相同: 字符存在 TArray<TCHAR> 中, 非空时以 '\0' 结尾, 空字符串不占内存. */
+class FString
+{
+public:
+	typedef TCHAR ElementType;
+
+	FString() {}
+	FString(const FString&) = default;
+	FString(FString&&) = default;
+	FString& operator=(const FString&) = default;
+	FString& operator=(FString&&) = default;
+
+	FString(const TCHAR* Str)
+	{
+		int32 Length = 0;
+		while (Str != nullptr && Str[Length] != 0) { ++Length; }
+		AppendChars(Str, Length);
+	}
+
+	FString(int32 InCount, const TCHAR* InSrc) { AppendChars(InSrc, InCount); }
+
+	/** 只用于 ASCII 字面量. */
+	FString(const ANSICHAR* Str)
+	{
+		for (; Str != nullptr && *Str != 0; ++Str) { AppendChar((TCHAR)(uint8)*Str); }
+	}
+
+	int32 Len() const { return Data.Num() > 0 ? Data.Num() - 1 : 0; }
+	bool IsEmpty() const { return Len() == 0; }
+	const TCHAR* operator*() const { return Data.Num() > 0 ? Data.GetData() : TEXT(""); }
+	TArray<TCHAR>& GetCharArray() { return Data; }
+	const TArray<TCHAR>& GetCharArray() const { return Data; }
+	SIZE_T GetAllocatedSize() const { return Data.GetAllocatedSize(); }
+
+	void Empty(int32 Slack = 0) { Data.Empty(Slack > 0 ? Slack + 1 : 0); }
+	void Reset(int32 NewReservedSize = 0) { Data.Reset(NewReservedSize > 0 ? NewReservedSize + 1 : 0); }
+	void Reserve(int32 CharacterCount) { Data.Reserve(CharacterCount + 1); }
+
+	void AppendChars(const TCHAR* Str, int32 Count)
+	{
+		if (Count <= 0) { return; }
+		if (Data.Num() > 0) { Data.Pop(); }
+		Data.Append(Str, Count);
+		Data.Add(0);
+	}
+
+	FString& AppendChar(TCHAR InChar) { AppendChars(&InChar, 1); return *this; }
+	FString& Append(const FString& Text) { AppendChars(*Text, Text.Len()); return *this; }
+	FString& Append(const TCHAR* Text, int32 Count) { AppendChars(Text, Count); return *this; }
+	FString& operator+=(TCHAR InChar) { return AppendChar(InChar); }
+	FString& operator+=(const FString& Str) { return Append(Str); }
+	FString& operator+=(const TCHAR* Str) { return Append(FString(Str)); }
+	friend FString operator+(const FString& Lhs, const FString& Rhs) { FString Result = Lhs; Result += Rhs; return Result; }
+
+	TCHAR& operator[](int32 Index) { return Data[Index]; }
+	const TCHAR& operator[](int32 Index) const { return Data[Index]; }
+
+	bool operator==(const FString& Rhs) const { return Len() == Rhs.Len() && memcmp(**this, *Rhs, Len() * sizeof(TCHAR)) == 0; }
+	bool operator!=(const FString& Rhs) const { return !(*this == Rhs); }
+
+	bool Equals(const FString& Other, ESearchCase SearchCase = ESearchCase::CaseSensitive) const
+	{
+		if (Len() != Other.Len()) { return false; }
+		for (int32 Index = 0; Index < Len(); ++Index)
+		{
+			TCHAR A = Data[Index];
+			TCHAR B = Other.Data[Index];
+			if (SearchCase == ESearchCase::IgnoreCase)
+			{
+				A = (A >= 'a' && A <= 'z') ? A - 32 : A;
+				B = (B >= 'a' && B <= 'z') ? B - 32 : B;
+			}
+			if (A != B) { return false; }
+		}
+		return true;
+	}
+
+	int32 Find(const FString& SubStr) const
+	{
+		const std::u16string_view Haystack(**this, Len());
+		const size_t Position = Haystack.find(std::u16string_view(*SubStr, SubStr.Len()));
+		return Position != std::u16string_view::npos ? (int32)Position : INDEX_NONE;
+	}
+
+	FString Left(int32 Count) const { return FString(FMath::Clamp(Count, 0, Len()), **this); }
+	FString Mid(int32 Start, int32 Count) const { Start = FMath::Clamp(Start, 0, Len()); return FString(FMath::Clamp(Count, 0, Len() - Start), **this + Start); }
+
+	/** 转成 UTF-8, 供 printf 和文件输出使用. */
+	std::string ToUTF8() const
+	{
+		std::string Result;
+		for (int32 Index = 0; Index < Len(); ++Index)
+		{
+			uint32 CodePoint = Data[Index];
+			if (CodePoint >= 0xD800 && CodePoint < 0xDC00 && Index + 1 < Len() && Data[Index + 1] >= 0xDC00 && Data[Index + 1] < 0xE000)
+			{
+				CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Data[++Index] - 0xDC00);
+			}
+			if (CodePoint < 0x80) { Result += (char)CodePoint; }
+			else if (CodePoint < 0x800) { Result += (char)(0xC0 | (CodePoint >> 6)); Result += (char)(0x80 | (CodePoint & 0x3F)); }
+			else if (CodePoint < 0x10000) { Result += (char)(0xE0 | (CodePoint >> 12)); Result += (char)(0x80 | ((CodePoint >> 6) & 0x3F)); Result += (char)(0x80 | (CodePoint & 0x3F)); }
+			else { Result += (char)(0xF0 | (CodePoint >> 18)); Result += (char)(0x80 | ((CodePoint >> 12) & 0x3F)); Result += (char)(0x80 | ((CodePoint >> 6) & 0x3F)); Result += (char)(0x80 | (CodePoint & 0x3F)); }
+		}
+		return Result;
+	}
+
+	/** 格式串和 %s 参数都是 TCHAR, 转成 UTF-8 后交给 snprintf. */
+	template <typename... ArgsType>
+	static FString Printf(const TCHAR* Fmt, ArgsType... Args)
+	{
+		const std::string Format = FString(Fmt).ToUTF8();
+		std::vector<std::string> Storage;
+		Storage.reserve(sizeof...(ArgsType));
+		const int Length = snprintf(nullptr, 0, Format.c_str(), ToPrintfArg(Args, Storage)...);
+		std::vector<char> Buffer(Length > 0 ? Length + 1 : 1);
+		Storage.clear();
+		snprintf(Buffer.data(), Buffer.size(), Format.c_str(), ToPrintfArg(Args, Storage)...);
+		return FromUTF8(Buffer.data());
+	}
+
+	static FString FromUTF8(const char* Str)
+	{
+		FString Result;
+		for (const uint8* Char = (const uint8*)Str; *Char != 0;)
+		{
+			uint32 CodePoint = *Char++;
+			const int32 NumTrailing = CodePoint >= 0xF0 ? 3 : CodePoint >= 0xE0 ? 2 : CodePoint >= 0xC0 ? 1 : 0;
+			CodePoint &= NumTrailing == 0 ? 0x7F : (0x3F >> NumTrailing);
+			for (int32 Trailing = 0; Trailing < NumTrailing && *Char != 0; ++Trailing) { CodePoint = (CodePoint << 6) | (*Char++ & 0x3F); }
+			if (CodePoint >= 0x10000)
+			{
+				Result.AppendChar((TCHAR)(0xD800 + ((CodePoint - 0x10000) >> 10)));
+				Result.AppendChar((TCHAR)(0xDC00 + ((CodePoint - 0x10000) & 0x3FF)));
+			}
+			else
+			{
+				Result.AppendChar((TCHAR)CodePoint);
+			}
+		}
+		return Result;
+	}
+
+private:
+	template <typename T>
+	static T ToPrintfArg(T Value, std::vector<std::string>&) { return Value; }
+	static const char* ToPrintfArg(const TCHAR* Value, std::vector<std::string>& Storage) { Storage.push_back(FString(Value).ToUTF8()); return Storage.back().c_str(); }
+	static const char* ToPrintfArg(TCHAR* Value, std::vector<std::string>& Storage) { return ToPrintfArg((const TCHAR*)Value, Storage); }
+
+	TArray<TCHAR> Data;
+};
+
+/** 与引擎的实现相同: 每个字符减 1 后截断为一个字节, 遇到 '\0' 或写满 MaxBufferSize 时停止. */
+inline int32 StringToBytes(const FString& String, uint8* OutBytes, int32 MaxBufferSize)
+{
+	int32 NumBytes = 0;
+	const TCHAR* CharPos = *String;
+	while (*CharPos != 0 && NumBytes < MaxBufferSize)
+	{
+		OutBytes[NumBytes] = (int8)(*CharPos - 1);
+		++CharPos;
+		++NumBytes;
+	}
+	return NumBytes;
+}
+
+/** 与引擎的实现相同: 每个字节加 1 后作为一个字符. */
+inline FString BytesToString(const uint8* In, int32 Count)
+{
+	FString Result;
+	Result.Empty(Count);
+	while (Count > 0)
+	{
+		int16 Value = *In;
+		Value += 1;
+		Result += (TCHAR)Value;
+		++In;
+		--Count;
+	}
+	return Result;
+}
+
+inline uint8 TCharToNibble(const TCHAR Hex)
+{
+	if (Hex >= '0' && Hex <= '9') { return (uint8)(Hex - '0'); }
+	if (Hex >= 'A' && Hex <= 'F') { return (uint8)(Hex - 'A' + 10); }
+	if (Hex >= 'a' && Hex <= 'f') { return (uint8)(Hex - 'a' + 10); }
+	return 0;
+}
+
+/** 与引擎的实现相同: 两个十六进制字符一个字节, 奇数长度时第一个字符单独成为一个字节. 返回写入的字节数. */
+inline int32 HexToBytes(const FString& HexString, uint8* OutBytes)
+{
+	int32 NumBytes = 0;
+	const bool bPadNibble = (HexString.Len() % 2) == 1;
+	const TCHAR* CharPos = *HexString;
+	if (bPadNibble)
+	{
+		OutBytes[NumBytes++] = TCharToNibble(*CharPos++);
+	}
+	while (*CharPos)
+	{
+		OutBytes[NumBytes] = (uint8)(TCharToNibble(*CharPos++) << 4);
+		OutBytes[NumBytes] += TCharToNibble(*CharPos++);
+		++NumBytes;
+	}
+	return NumBytes;
+}
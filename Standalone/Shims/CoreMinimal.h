@@ -0,0 +1,62 @@
+// CoreMinimal.h
+// 独立构建(见根目录 CMakeLists.txt)用的最小引擎替身, 只实现 Ecryption 模块用到的接口和行为, 不随模块发布.
+
+#pragma once
+
+#include "HAL/Platform.h"
+
+template <typename T> constexpr T Align(T Val, uint64 Alignment) { return (T)(((uint64)Val + Alignment - 1) & ~(Alignment - 1)); }
+template <typename T> constexpr T AlignDown(T Val, uint64 Alignment) { return (T)(((uint64)Val) & ~(Alignment - 1)); }
+template <typename T> constexpr bool IsAligned(T Val, uint64 Alignment) { return !((uint64)Val & (Alignment - 1)); }
+template <typename T> std::remove_reference_t<T>&& MoveTemp(T&& Value) { return static_cast<std::remove_reference_t<T>&&>(Value); }
+template <typename T> T&& Forward(std::remove_reference_t<T>& Value) { return static_cast<T&&>(Value); }
+template <typename T> void Swap(T& A, T& B) { std::swap(A, B); }
+
+#include "HAL/MemoryBase.h"
+
+struct FMemory
+{
+	static void* Memcpy(void* Dest, const void* Src, SIZE_T Count) { return memcpy(Dest, Src, Count); }
+	static void* Memmove(void* Dest, const void* Src, SIZE_T Count) { return memmove(Dest, Src, Count); }
+	static void* Memset(void* Dest, uint8 Char, SIZE_T Count) { return memset(Dest, Char, Count); }
+	static void* Memzero(void* Dest, SIZE_T Count) { return memset(Dest, 0, Count); }
+	static int32 Memcmp(const void* A, const void* B, SIZE_T Count) { return memcmp(A, B, Count); }
+	static void* Malloc(SIZE_T Count, uint32 Alignment = 16) { return GMalloc->Malloc(Count, Alignment); }
+	static void* Realloc(void* Original, SIZE_T Count, uint32 Alignment = 16) { return GMalloc->Realloc(Original, Count, Alignment); }
+	static void Free(void* Original) { GMalloc->Free(Original); }
+};
+
+struct FMath
+{
+	template <typename T> static constexpr T Min(T A, T B) { return A < B ? A : B; }
+	template <typename T> static constexpr T Max(T A, T B) { return A > B ? A : B; }
+	template <typename T> static constexpr T Clamp(T X, T Low, T High) { return X < Low ? Low : (X > High ? High : X); }
+	template <typename T> static constexpr T DivideAndRoundUp(T A, T B) { return (A + B - 1) / B; }
+	static uint32 CeilLogTwo(uint32 Value) { return Value <= 1 ? 0 : 32 - __builtin_clz(Value - 1); }
+	static uint32 FloorLog2(uint32 Value) { return Value ? 31 - __builtin_clz(Value) : 0; }
+	static uint64 FloorLog2_64(uint64 Value) { return Value ? 63 - __builtin_clzll(Value) : 0; }
+	static uint32 CountTrailingZeros(uint32 Value) { return Value ? __builtin_ctz(Value) : 32; }
+	static uint32 CountLeadingZeros64(uint64 Value) { return Value ? __builtin_clzll(Value) : 64; }
+	static uint32 RoundUpToPowerOfTwo(uint32 Value) { return Value <= 1 ? 1 : 1u << CeilLogTwo(Value); }
+};
+
+template <typename KeyType, typename ValueType>
+struct TPair
+{
+	KeyType Key;
+	ValueType Value;
+
+	TPair() {}
+	TPair(KeyType InKey, ValueType InValue) : Key(MoveTemp(InKey)), Value(MoveTemp(InValue)) {}
+};
+
+#include "Containers/Array.h"
+#include "Containers/ArrayView.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "Containers/StringView.h"
+#include "Templates/Function.h"
+#include "Templates/SharedPointer.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/CriticalSection.h"
+#include "Logging/LogMacros.h"
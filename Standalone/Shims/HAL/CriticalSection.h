@@ -0,0 +1,28 @@
+// CriticalSection.h
+
+#pragma once
+
+#include <mutex>
+#include <shared_mutex>
+
+class FCriticalSection
+{
+public:
+	void Lock() { Mutex.lock(); }
+	void Unlock() { Mutex.unlock(); }
+
+private:
+	std::recursive_mutex Mutex;
+};
+
+class FRWLock
+{
+public:
+	void ReadLock() { Mutex.lock_shared(); }
+	void ReadUnlock() { Mutex.unlock_shared(); }
+	void WriteLock() { Mutex.lock(); }
+	void WriteUnlock() { Mutex.unlock(); }
+
+private:
+	std::shared_mutex Mutex;
+};
@@ -0,0 +1,95 @@
+// IConsoleManager.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <functional>
+#include <map>
+
+class IConsoleVariable;
+
+struct FConsoleCommandDelegate
+{
+	std::function<void()> Function;
+
+	static FConsoleCommandDelegate CreateStatic(void (*InFunction)()) { return { InFunction }; }
+	template <typename FunctorType> static FConsoleCommandDelegate CreateLambda(FunctorType&& Functor) { return { Forward<FunctorType>(Functor) }; }
+};
+
+struct FConsoleCommandWithArgsDelegate
+{
+	std::function<void(const TArray<FString>&)> Function;
+
+	static FConsoleCommandWithArgsDelegate CreateStatic(void (*InFunction)(const TArray<FString>&)) { return { InFunction }; }
+	template <typename FunctorType> static FConsoleCommandWithArgsDelegate CreateLambda(FunctorType&& Functor) { return { Forward<FunctorType>(Functor) }; }
+};
+
+struct FConsoleVariableDelegate
+{
+	std::function<void(IConsoleVariable*)> Function;
+
+	static FConsoleVariableDelegate CreateStatic(void (*InFunction)(IConsoleVariable*)) { return { InFunction }; }
+	template <typename FunctorType> static FConsoleVariableDelegate CreateLambda(FunctorType&& Functor) { return { Forward<FunctorType>(Functor) }; }
+};
+
+/** 只支持整数和布尔值的变量, 设置后调用变更回调. */
+class IConsoleVariable
+{
+public:
+	void Set(int32 InValue)
+	{
+		Setter(InValue);
+		if (OnChanged)
+		{
+			OnChanged(this);
+		}
+	}
+
+	int32 GetInt() const { return Getter(); }
+	bool GetBool() const { return Getter() != 0; }
+
+	std::function<void(int32)> Setter;
+	std::function<int32()> Getter;
+	std::function<void(IConsoleVariable*)> OnChanged;
+};
+
+class IConsoleManager
+{
+public:
+	static IConsoleManager& Get()
+	{
+		static IConsoleManager Singleton;
+		return Singleton;
+	}
+
+	IConsoleVariable* FindConsoleVariable(const TCHAR* Name)
+	{
+		auto It = Variables.find(Name);
+		return It != Variables.end() ? &It->second : nullptr;
+	}
+
+	IConsoleVariable& RegisterVariable(const TCHAR* Name) { return Variables[Name]; }
+
+private:
+	std::map<std::u16string, IConsoleVariable> Variables;
+};
+
+struct FAutoConsoleVariableRef
+{
+	template <typename ValueType>
+	FAutoConsoleVariableRef(const TCHAR* Name, ValueType& RefValue, const TCHAR*, const FConsoleVariableDelegate& Callback = {})
+	{
+		static_assert(std::is_same_v<ValueType, int32> || std::is_same_v<ValueType, bool>, "Only int32 and bool console variables are supported.");
+		IConsoleVariable& Variable = IConsoleManager::Get().RegisterVariable(Name);
+		Variable.Setter = [&RefValue](int32 InValue) { RefValue = (ValueType)InValue; };
+		Variable.Getter = [&RefValue]() { return (int32)RefValue; };
+		Variable.OnChanged = Callback.Function;
+	}
+};
+
+/** 命令只注册不执行, 独立构建中直接调用对应的函数. */
+struct FAutoConsoleCommand
+{
+	FAutoConsoleCommand(const TCHAR*, const TCHAR*, const FConsoleCommandDelegate&) {}
+	FAutoConsoleCommand(const TCHAR*, const TCHAR*, const FConsoleCommandWithArgsDelegate&) {}
+};
@@ -0,0 +1,46 @@
+// MemoryBase.h
+
+#pragma once
+
+#include "HAL/Platform.h"
+
+/** GMalloc 的接口. 基准测试会临时替换 GMalloc 来统计分配次数. */
+class FMalloc
+{
+public:
+	virtual ~FMalloc() {}
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment = 0) = 0;
+	virtual void* TryMalloc(SIZE_T Count, uint32 Alignment = 0) { return Malloc(Count, Alignment); }
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment = 0) = 0;
+	virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment = 0) { return Realloc(Original, Count, Alignment); }
+	virtual void Free(void* Original) = 0;
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32) { return Count; }
+	virtual bool GetAllocationSize(void*, SIZE_T&) { return false; }
+	virtual void Trim(bool) {}
+	virtual bool IsInternallyThreadSafe() const { return true; }
+	virtual const TCHAR* GetDescriptiveName() { return TEXT("Standalone"); }
+};
+
+class FMallocStandalone final : public FMalloc
+{
+public:
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		void* Result = nullptr;
+		return posix_memalign(&Result, Alignment < 16 ? 16 : Alignment, Count > 0 ? Count : 1) == 0 ? Result : nullptr;
+	}
+
+	/** realloc 只保证 16 字节对齐, 与 Malloc 的默认对齐相同. */
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32) override
+	{
+		return realloc(Original, Count);
+	}
+
+	virtual void Free(void* Original) override
+	{
+		free(Original);
+	}
+};
+
+inline FMallocStandalone GStandaloneMalloc;
+inline FMalloc* GMalloc = &GStandaloneMalloc;
@@ -0,0 +1,80 @@
+// Platform.h
+// 基本类型, 平台宏以及 check/ensure.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <initializer_list>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef int8_t int8;
+typedef int16_t int16;
+typedef int32_t int32;
+typedef int64_t int64;
+typedef char16_t TCHAR;
+typedef char ANSICHAR;
+typedef char16_t WIDECHAR;
+typedef char UTF8CHAR;
+typedef uint64_t SIZE_T;
+typedef int64_t SSIZE_T;
+typedef uintptr_t UPTRINT;
+
+#define TEXT(x) u##x
+
+#ifndef PLATFORM_CPU_X86_FAMILY
+	#if defined(__x86_64__) || defined(__i386__)
+		#define PLATFORM_CPU_X86_FAMILY 1
+	#else
+		#define PLATFORM_CPU_X86_FAMILY 0
+	#endif
+#endif
+#define PLATFORM_CPU_ARM_FAMILY (!PLATFORM_CPU_X86_FAMILY)
+#define PLATFORM_WINDOWS 0
+#define PLATFORM_MICROSOFT 0
+#define PLATFORM_LINUX 1
+#define PLATFORM_ANDROID 0
+#define PLATFORM_MAC 0
+#define PLATFORM_IOS 0
+#define PLATFORM_APPLE 0
+#define PLATFORM_LITTLE_ENDIAN 1
+#define PLATFORM_CACHE_LINE_SIZE 64
+#define WITH_DEV_AUTOMATION_TESTS 1
+
+#define FORCEINLINE inline __attribute__((always_inline))
+#define FORCENOINLINE __attribute__((noinline))
+#define LIKELY(x) __builtin_expect(!!(x), 1)
+#define UNLIKELY(x) __builtin_expect(!!(x), 0)
+#define INDEX_NONE (-1)
+#define MAX_int32 0x7fffffff
+#define MAX_uint32 0xffffffffu
+#define UE_ARRAY_COUNT(a) (sizeof(a) / sizeof((a)[0]))
+#define BYTESWAP_ORDER32(x) __builtin_bswap32(x)
+#define BYTESWAP_ORDER64(x) __builtin_bswap64(x)
+
+/** check 失败直接终止; ensure 失败只计数并打印, 测试据此确认不可信的输入不会触发 ensure. */
+inline std::atomic<int32> GStandaloneNumEnsureFailures{ 0 };
+
+#define check(x) do { if (!(x)) { fprintf(stderr, "check failed: %s (%s:%d)\n", #x, __FILE__, __LINE__); abort(); } } while (0)
+#define checkf(x, ...) check(x)
+#define checkSlow(x) check(x)
+#define ensure(x) ([&]() -> bool \
+	{ \
+		const bool bPassed_ = !!(x); \
+		if (!bPassed_) { ++GStandaloneNumEnsureFailures; fprintf(stderr, "ensure failed: %s (%s:%d)\n", #x, __FILE__, __LINE__); } \
+		return bPassed_; \
+	}())
+#define ensureMsgf(x, ...) ensure(x)
@@ -0,0 +1,12 @@
+// PlatformProcess.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <chrono>
+#include <thread>
+
+struct FPlatformProcess
+{
+	static void Sleep(float Seconds) { std::this_thread::sleep_for(std::chrono::duration<double>(Seconds)); }
+};
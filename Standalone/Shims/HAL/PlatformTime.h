@@ -0,0 +1,15 @@
+// PlatformTime.h
+
+#pragma once
+
+#include <chrono>
+
+/** 周期数直接用纳秒表示. */
+struct FPlatformTime
+{
+	static double Seconds() { return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+	static uint64 Cycles64() { return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+	static uint32 Cycles() { return (uint32)Cycles64(); }
+	static double GetSecondsPerCycle64() { return 1e-9; }
+	static double GetSecondsPerCycle() { return 1e-9; }
+};
@@ -0,0 +1,16 @@
+// CityHash.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <functional>
+
+/** 不是真正的 CityHash, 只保证同样的输入得到同样的 64 位哈希. */
+inline uint64 CityHash64WithSeed(const char* Buffer, uint32 Length, uint64 Seed)
+{
+	uint64 Hash = std::hash<std::string_view>()(std::string_view(Buffer, Length)) ^ Seed;
+	Hash ^= Hash >> 29;
+	Hash *= 0xbf58476d1ce4e5b9ull;
+	Hash ^= Hash >> 32;
+	return Hash;
+}
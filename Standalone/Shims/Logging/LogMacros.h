@@ -0,0 +1,22 @@
+// LogMacros.h
+
+#pragma once
+
+namespace ELogVerbosity
+{
+	enum Type : uint8 { NoLogging, Fatal, Error, Warning, Display, Log, Verbose, VeryVerbose, All = VeryVerbose };
+}
+
+/** Log 及以上的级别输出到 stdout, 警告和错误输出到 stderr. */
+#define UE_LOG(CategoryName, Verbosity, Format, ...) \
+	do \
+	{ \
+		if (ELogVerbosity::Verbosity <= ELogVerbosity::Log) \
+		{ \
+			fprintf(ELogVerbosity::Verbosity <= ELogVerbosity::Warning ? stderr : stdout, "%s: %s\n", #CategoryName, FString::Printf(Format, ##__VA_ARGS__).ToUTF8().c_str()); \
+		} \
+	} while (0)
+
+#define DECLARE_LOG_CATEGORY_EXTERN(CategoryName, DefaultVerbosity, CompileTimeVerbosity)
+#define DEFINE_LOG_CATEGORY(CategoryName)
+#define DEFINE_LOG_CATEGORY_STATIC(CategoryName, DefaultVerbosity, CompileTimeVerbosity)
@@ -0,0 +1,205 @@
+// AES.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 与引擎相同的接口: AES-256, ECB, 原地处理, NumBytes 必须是 16 的倍数.
+ * 逐字节查表的参考实现, 速度与引擎的软件实现同一量级, 只用来对照 AES-NI 内核和在没有 AES-NI 时兜底.
+ */
+struct FAES
+{
+	static constexpr uint32 AESBlockSize = 16;
+
+	struct FAESKey
+	{
+		static constexpr int32 KeySize = 32;
+
+		uint8 Key[KeySize];
+
+		FAESKey() { Reset(); }
+
+		bool IsValid() const
+		{
+			for (int32 Index = 0; Index < KeySize; ++Index)
+			{
+				if (Key[Index] != 0) { return true; }
+			}
+			return false;
+		}
+
+		void Reset() { FMemory::Memzero(Key, KeySize); }
+	};
+
+	static void EncryptData(uint8* Contents, uint64 NumBytes, const FAESKey& Key)
+	{
+		check(NumBytes % AESBlockSize == 0);
+		uint8 RoundKeys[NumRoundKeyBytes];
+		ExpandKey(Key.Key, RoundKeys);
+		for (uint64 Offset = 0; Offset < NumBytes; Offset += AESBlockSize)
+		{
+			uint8* State = Contents + Offset;
+			AddRoundKey(State, RoundKeys);
+			for (int32 Round = 1; Round <= NumRounds; ++Round)
+			{
+				for (int32 Index = 0; Index < 16; ++Index) { State[Index] = SBox()[State[Index]]; }
+				ShiftRows(State, false);
+				if (Round != NumRounds) { MixColumns(State, false); }
+				AddRoundKey(State, RoundKeys + Round * 16);
+			}
+		}
+		FMemory::Memzero(RoundKeys, sizeof(RoundKeys));
+	}
+
+	static void DecryptData(uint8* Contents, uint64 NumBytes, const FAESKey& Key)
+	{
+		check(NumBytes % AESBlockSize == 0);
+		uint8 RoundKeys[NumRoundKeyBytes];
+		ExpandKey(Key.Key, RoundKeys);
+		for (uint64 Offset = 0; Offset < NumBytes; Offset += AESBlockSize)
+		{
+			uint8* State = Contents + Offset;
+			AddRoundKey(State, RoundKeys + NumRounds * 16);
+			for (int32 Round = NumRounds - 1; Round >= 0; --Round)
+			{
+				ShiftRows(State, true);
+				for (int32 Index = 0; Index < 16; ++Index) { State[Index] = InvSBox()[State[Index]]; }
+				AddRoundKey(State, RoundKeys + Round * 16);
+				if (Round != 0) { MixColumns(State, true); }
+			}
+		}
+		FMemory::Memzero(RoundKeys, sizeof(RoundKeys));
+	}
+
+private:
+	static constexpr int32 NumRounds = 14;
+	static constexpr int32 NumRoundKeyBytes = (NumRounds + 1) * 16;
+
+	static const uint8* SBox()
+	{
+		static const uint8 Table[256] = {
+			0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+			0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+			0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+			0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+			0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+			0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+			0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+			0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+			0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+			0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+			0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+			0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+			0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+			0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+			0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+			0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16 };
+		return Table;
+	}
+
+	static const uint8* InvSBox()
+	{
+		struct FInverse
+		{
+			uint8 Table[256];
+			FInverse() { for (int32 Index = 0; Index < 256; ++Index) { Table[SBox()[Index]] = (uint8)Index; } }
+		};
+		static const FInverse Inverse;
+		return Inverse.Table;
+	}
+
+	static uint8 XTime(uint8 Value) { return (uint8)((Value << 1) ^ ((Value & 0x80) ? 0x1b : 0)); }
+
+	static uint8 Multiply(uint8 A, uint8 B)
+	{
+		uint8 Result = 0;
+		for (; B != 0; B >>= 1, A = XTime(A))
+		{
+			if (B & 1) { Result ^= A; }
+		}
+		return Result;
+	}
+
+	/** MixColumns 用到的系数 1, 2, 3, 9, 11, 13, 14 的乘法表, Products[Coefficient][Value]. */
+	static const uint8 (*GetProducts())[256]
+	{
+		struct FProducts
+		{
+			uint8 Table[15][256];
+			FProducts()
+			{
+				for (int32 Coefficient : { 1, 2, 3, 9, 11, 13, 14 })
+				{
+					for (int32 Value = 0; Value < 256; ++Value) { Table[Coefficient][Value] = Multiply((uint8)Value, (uint8)Coefficient); }
+				}
+			}
+		};
+		static const FProducts Products;
+		return Products.Table;
+	}
+
+	static void ExpandKey(const uint8* KeyBytes, uint8* RoundKeys)
+	{
+		FMemory::Memcpy(RoundKeys, KeyBytes, FAESKey::KeySize);
+		uint8 RoundConstant = 1;
+		for (int32 Offset = FAESKey::KeySize; Offset < NumRoundKeyBytes; Offset += 4)
+		{
+			uint8 Word[4];
+			FMemory::Memcpy(Word, RoundKeys + Offset - 4, 4);
+			if (Offset % FAESKey::KeySize == 0)
+			{
+				const uint8 First = Word[0];
+				Word[0] = SBox()[Word[1]] ^ RoundConstant;
+				Word[1] = SBox()[Word[2]];
+				Word[2] = SBox()[Word[3]];
+				Word[3] = SBox()[First];
+				RoundConstant = XTime(RoundConstant);
+			}
+			else if (Offset % FAESKey::KeySize == 16)
+			{
+				for (uint8& Byte : Word) { Byte = SBox()[Byte]; }
+			}
+			for (int32 Index = 0; Index < 4; ++Index)
+			{
+				RoundKeys[Offset + Index] = RoundKeys[Offset - FAESKey::KeySize + Index] ^ Word[Index];
+			}
+		}
+	}
+
+	static void AddRoundKey(uint8* State, const uint8* RoundKey)
+	{
+		for (int32 Index = 0; Index < 16; ++Index) { State[Index] ^= RoundKey[Index]; }
+	}
+
+	/** 状态按列存放: State[Column * 4 + Row]. */
+	static void ShiftRows(uint8* State, bool bInverse)
+	{
+		uint8 Shifted[16];
+		for (int32 Column = 0; Column < 4; ++Column)
+		{
+			for (int32 Row = 0; Row < 4; ++Row)
+			{
+				const int32 Source = bInverse ? (Column - Row + 4) % 4 : (Column + Row) % 4;
+				Shifted[Column * 4 + Row] = State[Source * 4 + Row];
+			}
+		}
+		FMemory::Memcpy(State, Shifted, sizeof(Shifted));
+	}
+
+	static void MixColumns(uint8* State, bool bInverse)
+	{
+		const uint8 (*Products)[256] = GetProducts();
+		const uint8* Coefficients[4] = { Products[bInverse ? 14 : 2], Products[bInverse ? 11 : 3], Products[bInverse ? 13 : 1], Products[bInverse ? 9 : 1] };
+		for (int32 Column = 0; Column < 4; ++Column)
+		{
+			uint8* Bytes = State + Column * 4;
+			const uint8 Original[4] = { Bytes[0], Bytes[1], Bytes[2], Bytes[3] };
+			for (int32 Row = 0; Row < 4; ++Row)
+			{
+				Bytes[Row] = Coefficients[0][Original[Row]] ^ Coefficients[1][Original[(Row + 1) % 4]]
+					^ Coefficients[2][Original[(Row + 2) % 4]] ^ Coefficients[3][Original[(Row + 3) % 4]];
+			}
+		}
+	}
+};
@@ -0,0 +1,162 @@
+// AutomationTest.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace EAutomationTestFlags
+{
+	enum Type : uint32
+	{
+		EditorContext = 0x00000001,
+		ClientContext = 0x00000002,
+		ServerContext = 0x00000004,
+		CommandletContext = 0x00000008,
+		ApplicationContextMask = EditorContext | ClientContext | ServerContext | CommandletContext,
+
+		SmokeFilter = 0x01000000,
+		EngineFilter = 0x02000000,
+		ProductFilter = 0x04000000,
+		PerfFilter = 0x08000000,
+		StressFilter = 0x10000000,
+		NegativeFilter = 0x20000000,
+	};
+}
+
+class FAutomationTestBase;
+
+/** 只实现注册和依次运行. 引擎中由 Session Frontend 或 Automation RunTests 命令运行. */
+class FAutomationTestFramework
+{
+public:
+	static FAutomationTestFramework& Get()
+	{
+		static FAutomationTestFramework Framework;
+		return Framework;
+	}
+
+	void RegisterAutomationTest(FAutomationTestBase* Test) { Tests.push_back(Test); }
+
+	/** 独立构建专用: 依次运行名称以 Filter 开头的测试, 返回失败的个数. */
+	int32 RunTestsStandalone(const FString& Filter);
+
+private:
+	std::vector<FAutomationTestBase*> Tests;
+};
+
+class FAutomationTestBase
+{
+public:
+	FAutomationTestBase(const FString& InName, const bool)
+		: TestName(InName)
+	{
+		FAutomationTestFramework::Get().RegisterAutomationTest(this);
+	}
+	virtual ~FAutomationTestBase() {}
+
+	virtual uint32 GetTestFlags() const = 0;
+	virtual FString GetBeautifiedTestName() const = 0;
+	virtual bool RunTest(const FString& Parameters) = 0;
+
+	void AddError(const FString& InError)
+	{
+		fprintf(stderr, "  Error: %s\n", InError.ToUTF8().c_str());
+		++NumErrors;
+	}
+
+	void AddInfo(const FString& InInfo)
+	{
+		printf("  Info: %s\n", InInfo.ToUTF8().c_str());
+	}
+
+	bool TestTrue(const FString& What, bool bValue)
+	{
+		if (!bValue)
+		{
+			AddError(FString::Printf(TEXT("Expected '%s' to be true."), *What));
+		}
+		return bValue;
+	}
+
+	bool TestFalse(const FString& What, bool bValue)
+	{
+		if (bValue)
+		{
+			AddError(FString::Printf(TEXT("Expected '%s' to be false."), *What));
+		}
+		return !bValue;
+	}
+
+	template <typename ActualType, typename ExpectedType>
+	bool TestEqual(const FString& What, const ActualType& Actual, const ExpectedType& Expected)
+	{
+		const bool bEqual = Actual == Expected;
+		if (!bEqual)
+		{
+			AddError(FString::Printf(TEXT("Expected '%s' to be equal."), *What));
+		}
+		return bEqual;
+	}
+
+	template <typename ActualType, typename ExpectedType>
+	bool TestNotEqual(const FString& What, const ActualType& Actual, const ExpectedType& Expected)
+	{
+		const bool bNotEqual = !(Actual == Expected);
+		if (!bNotEqual)
+		{
+			AddError(FString::Printf(TEXT("Expected '%s' to differ."), *What));
+		}
+		return bNotEqual;
+	}
+
+	/**
+	 * 运行一次测试. 引擎中 ensure 会以 Error 级别写入日志, 使正在运行的测试失败;
+	 * 这里用 GStandaloneNumEnsureFailures 得到同样的效果.
+	 */
+	bool RunStandalone()
+	{
+		NumErrors = 0;
+		const int32 StartEnsureFailures = GStandaloneNumEnsureFailures.load();
+		const bool bSucceeded = RunTest(FString());
+		if (GStandaloneNumEnsureFailures.load() != StartEnsureFailures)
+		{
+			AddError(TEXT("An ensure fired during the test."));
+		}
+		return bSucceeded && NumErrors == 0;
+	}
+
+protected:
+	FString TestName;
+	int32 NumErrors = 0;
+};
+
+inline int32 FAutomationTestFramework::RunTestsStandalone(const FString& Filter)
+{
+	int32 NumFailed = 0;
+	for (FAutomationTestBase* Test : Tests)
+	{
+		const FString Name = Test->GetBeautifiedTestName();
+		if (Name.Len() < Filter.Len() || FMemory::Memcmp(*Name, *Filter, Filter.Len() * sizeof(TCHAR)) != 0)
+		{
+			continue;
+		}
+		const bool bSucceeded = Test->RunStandalone();
+		printf("%s %s\n", bSucceeded ? "[ OK ]" : "[FAIL]", Name.ToUTF8().c_str());
+		NumFailed += bSucceeded ? 0 : 1;
+	}
+	return NumFailed;
+}
+
+#define IMPLEMENT_SIMPLE_AUTOMATION_TEST(TClass, PrettyName, TFlags) \
+	class TClass : public FAutomationTestBase \
+	{ \
+	public: \
+		TClass(const FString& InName) : FAutomationTestBase(InName, false) {} \
+		virtual uint32 GetTestFlags() const override { return TFlags; } \
+		virtual FString GetBeautifiedTestName() const override { return PrettyName; } \
+		virtual bool RunTest(const FString& Parameters) override; \
+	}; \
+	namespace \
+	{ \
+		TClass TClass##AutomationTestInstance(TEXT(#TClass)); \
+	}
@@ -0,0 +1,72 @@
+// Base64.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EBase64Mode : uint8 { Standard, UrlSafe };
+
+/** 只实现标准模式, 用来对照模块自己的 Base64 编解码. */
+struct FBase64
+{
+	static uint32 GetEncodedDataSize(uint32 NumBytes) { return ((NumBytes + 2) / 3) * 4; }
+
+	static uint32 GetDecodedDataSize(const FString& Source)
+	{
+		const uint32 Length = Source.Len();
+		if (Length == 0) { return 0; }
+		uint32 NumBytes = Length / 4 * 3;
+		NumBytes -= Source[Length - 1] == '=' ? 1 : 0;
+		NumBytes -= Length > 1 && Source[Length - 2] == '=' ? 1 : 0;
+		return NumBytes;
+	}
+
+	static FString Encode(const uint8* Source, uint32 Length, EBase64Mode = EBase64Mode::Standard)
+	{
+		static const char Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		FString Result;
+		for (uint32 Index = 0; Index < Length; Index += 3)
+		{
+			const uint32 NumSource = FMath::Min<uint32>(3, Length - Index);
+			uint32 Triple = (uint32)Source[Index] << 16;
+			Triple |= NumSource > 1 ? (uint32)Source[Index + 1] << 8 : 0;
+			Triple |= NumSource > 2 ? (uint32)Source[Index + 2] : 0;
+			Result.AppendChar(Alphabet[Triple >> 18]);
+			Result.AppendChar(Alphabet[(Triple >> 12) & 63]);
+			Result.AppendChar(NumSource > 1 ? Alphabet[(Triple >> 6) & 63] : '=');
+			Result.AppendChar(NumSource > 2 ? Alphabet[Triple & 63] : '=');
+		}
+		return Result;
+	}
+
+	static FString Encode(const TArray<uint8>& Source, EBase64Mode Mode = EBase64Mode::Standard) { return Encode(Source.GetData(), Source.Num(), Mode); }
+
+	static bool Decode(const FString& Source, TArray<uint8>& OutDest, EBase64Mode = EBase64Mode::Standard)
+	{
+		const int32 Length = Source.Len();
+		OutDest.Reset();
+		if (Length % 4 != 0) { return false; }
+		for (int32 Index = 0; Index < Length; Index += 4)
+		{
+			uint32 Quad = 0;
+			int32 NumPadding = 0;
+			for (int32 Offset = 0; Offset < 4; ++Offset)
+			{
+				const TCHAR Char = Source[Index + Offset];
+				int32 Value = -1;
+				if (Char >= 'A' && Char <= 'Z') { Value = Char - 'A'; }
+				else if (Char >= 'a' && Char <= 'z') { Value = Char - 'a' + 26; }
+				else if (Char >= '0' && Char <= '9') { Value = Char - '0' + 52; }
+				else if (Char == '+') { Value = 62; }
+				else if (Char == '/') { Value = 63; }
+				else if (Char == '=' && Index + 4 == Length && Offset >= 2) { Value = 0; ++NumPadding; }
+				if (Value < 0 || (NumPadding > 0 && Char != '=')) { return false; }
+				Quad = (Quad << 6) | (uint32)Value;
+			}
+			OutDest.Add((uint8)(Quad >> 16));
+			if (NumPadding < 2) { OutDest.Add((uint8)(Quad >> 8)); }
+			if (NumPadding < 1) { OutDest.Add((uint8)Quad); }
+		}
+		return true;
+	}
+};
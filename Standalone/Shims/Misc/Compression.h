@@ -0,0 +1,47 @@
+// Compression.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <zlib.h>
+
+struct FName
+{
+	constexpr FName(int32 InIndex = 0) : Index(InIndex) {}
+	bool operator==(const FName& Other) const { return Index == Other.Index; }
+	bool operator!=(const FName& Other) const { return Index != Other.Index; }
+
+	int32 Index;
+};
+
+inline constexpr FName NAME_None{ 0 };
+inline constexpr FName NAME_Zlib{ 1 };
+inline constexpr FName NAME_LZ4{ 2 };
+
+/** 两种格式都用 zlib 实现, NAME_LZ4 只换成最快的压缩级别; 压缩结果不能与引擎互通, 只在独立构建内部自洽. */
+struct FCompression
+{
+	static int32 CompressMemoryBound(FName, int32 UncompressedSize)
+	{
+		return (int32)compressBound((uLong)UncompressedSize);
+	}
+
+	static bool CompressMemory(FName FormatName, void* CompressedBuffer, int32& CompressedSize, const void* UncompressedBuffer, int32 UncompressedSize)
+	{
+		uLongf DestSize = (uLongf)CompressedSize;
+		const int Level = FormatName == NAME_LZ4 ? Z_BEST_SPEED : Z_DEFAULT_COMPRESSION;
+		if (compress2((Bytef*)CompressedBuffer, &DestSize, (const Bytef*)UncompressedBuffer, (uLong)UncompressedSize, Level) != Z_OK)
+		{
+			return false;
+		}
+		CompressedSize = (int32)DestSize;
+		return true;
+	}
+
+	static bool UncompressMemory(FName, void* UncompressedBuffer, int32 UncompressedSize, const void* CompressedBuffer, int32 CompressedSize)
+	{
+		uLongf DestSize = (uLongf)UncompressedSize;
+		return uncompress((Bytef*)UncompressedBuffer, &DestSize, (const Bytef*)CompressedBuffer, (uLong)CompressedSize) == Z_OK
+			&& DestSize == (uLongf)UncompressedSize;
+	}
+};
@@ -0,0 +1,35 @@
+// CoreDelegates.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <functional>
+
+class FSimpleMulticastDelegate
+{
+public:
+	template <typename FunctorType>
+	void AddLambda(FunctorType&& Functor) { Functions.push_back(Forward<FunctorType>(Functor)); }
+
+	void AddStatic(void (*Function)()) { Functions.push_back(Function); }
+
+	void Broadcast() const
+	{
+		for (const std::function<void()>& Function : Functions) { Function(); }
+	}
+
+private:
+	std::vector<std::function<void()>> Functions;
+};
+
+/** 独立构建中没有引擎循环, 需要时由可执行文件自己广播. */
+struct FCoreDelegates
+{
+	static inline FSimpleMulticastDelegate OnPreExit;
+
+	static FSimpleMulticastDelegate& GetMemoryTrimDelegate()
+	{
+		static FSimpleMulticastDelegate Delegate;
+		return Delegate;
+	}
+};
@@ -0,0 +1,18 @@
+// FileHelper.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFileHelper
+{
+	/** 以 UTF-8(不带 BOM) 写入. */
+	static bool SaveStringToFile(const FString& String, const TCHAR* Filename)
+	{
+		FILE* File = fopen(FString(Filename).ToUTF8().c_str(), "wb");
+		if (File == nullptr) { return false; }
+		const std::string Bytes = String.ToUTF8();
+		const bool bWritten = fwrite(Bytes.data(), 1, Bytes.size(), File) == Bytes.size();
+		return fclose(File) == 0 && bWritten;
+	}
+};
@@ -0,0 +1,17 @@
+// Paths.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** 独立构建把当前工作目录当作项目目录. */
+struct FPaths
+{
+	static FString ProjectDir() { return FString(TEXT("./")); }
+
+	static FString Combine(const FString& PathA, const FString& PathB)
+	{
+		if (PathA.IsEmpty() || PathA[PathA.Len() - 1] == '/') { return PathA + PathB; }
+		return PathA + FString(TEXT("/")) + PathB;
+	}
+};
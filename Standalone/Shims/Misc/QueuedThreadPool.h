@@ -0,0 +1,82 @@
+// QueuedThreadPool.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+enum EThreadPriority { TPri_Normal, TPri_AboveNormal, TPri_BelowNormal, TPri_Lowest };
+
+class IQueuedWork
+{
+public:
+	virtual ~IQueuedWork() {}
+	virtual void DoThreadedWork() = 0;
+	virtual void Abandon() = 0;
+};
+
+/** 与引擎相同: Destroy 时对还在队列中的任务调用 Abandon. */
+class FQueuedThreadPool
+{
+public:
+	static FQueuedThreadPool* Allocate() { return new FQueuedThreadPool(); }
+
+	virtual ~FQueuedThreadPool() { Destroy(); }
+
+	bool Create(uint32 InNumQueuedThreads, uint32 = 0, EThreadPriority = TPri_Normal, const TCHAR* = TEXT("UnknownThreadPool"))
+	{
+		for (uint32 Index = 0; Index < InNumQueuedThreads; ++Index)
+		{
+			Threads.emplace_back([this]() { Run(); });
+		}
+		return true;
+	}
+
+	void Destroy()
+	{
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			bTimeToDie = true;
+		}
+		Condition.notify_all();
+		for (std::thread& Thread : Threads) { Thread.join(); }
+		Threads.clear();
+		for (IQueuedWork* Work : QueuedWork) { Work->Abandon(); }
+		QueuedWork.clear();
+	}
+
+	void AddQueuedWork(IQueuedWork* InQueuedWork)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			QueuedWork.push_back(InQueuedWork);
+		}
+		Condition.notify_one();
+	}
+
+private:
+	void Run()
+	{
+		for (;;)
+		{
+			IQueuedWork* Work = nullptr;
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				Condition.wait(Lock, [this]() { return bTimeToDie || !QueuedWork.empty(); });
+				if (bTimeToDie) { return; }
+				Work = QueuedWork.front();
+				QueuedWork.pop_front();
+			}
+			Work->DoThreadedWork();
+		}
+	}
+
+	std::vector<std::thread> Threads;
+	std::deque<IQueuedWork*> QueuedWork;
+	std::mutex Mutex;
+	std::condition_variable Condition;
+	bool bTimeToDie = false;
+};
@@ -0,0 +1,37 @@
+// ScopeLock.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FScopeLock
+{
+public:
+	explicit FScopeLock(FCriticalSection* InSynchObject) : SynchObject(InSynchObject) { SynchObject->Lock(); }
+	~FScopeLock() { SynchObject->Unlock(); }
+
+private:
+	FScopeLock(const FScopeLock&) = delete;
+	FScopeLock& operator=(const FScopeLock&) = delete;
+
+	FCriticalSection* SynchObject;
+};
+
+enum ESLockType { SLT_ReadOnly, SLT_Write };
+
+class FRWScopeLock
+{
+public:
+	FRWScopeLock(FRWLock& InLockObject, ESLockType InLockType) : LockObject(InLockObject), LockType(InLockType)
+	{
+		if (LockType == SLT_ReadOnly) { LockObject.ReadLock(); } else { LockObject.WriteLock(); }
+	}
+	~FRWScopeLock()
+	{
+		if (LockType == SLT_ReadOnly) { LockObject.ReadUnlock(); } else { LockObject.WriteUnlock(); }
+	}
+
+private:
+	FRWLock& LockObject;
+	ESLockType LockType;
+};
@@ -0,0 +1,47 @@
+// Function.h
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+template <typename FuncType> using TFunction = std::function<FuncType>;
+template <typename FuncType> using TFunctionRef = std::function<FuncType>;
+
+/** 只能移动的可调用对象, 可以持有只能移动的 lambda. */
+template <typename FuncType> class TUniqueFunction;
+
+template <typename RetType, typename... ParamTypes>
+class TUniqueFunction<RetType(ParamTypes...)>
+{
+public:
+	TUniqueFunction() {}
+	TUniqueFunction(TUniqueFunction&&) = default;
+	TUniqueFunction& operator=(TUniqueFunction&&) = default;
+
+	template <typename FunctorType, typename = std::enable_if_t<!std::is_same_v<std::decay_t<FunctorType>, TUniqueFunction>>>
+	TUniqueFunction(FunctorType&& InFunc)
+		: Callable(new TCallable<std::decay_t<FunctorType>>(Forward<FunctorType>(InFunc)))
+	{
+	}
+
+	RetType operator()(ParamTypes... Params) const { return Callable->Call(Forward<ParamTypes>(Params)...); }
+	explicit operator bool() const { return Callable != nullptr; }
+
+private:
+	struct ICallable
+	{
+		virtual ~ICallable() {}
+		virtual RetType Call(ParamTypes... Params) = 0;
+	};
+
+	template <typename FunctorType>
+	struct TCallable : ICallable
+	{
+		FunctorType Functor;
+		template <typename ArgType> explicit TCallable(ArgType&& InFunctor) : Functor(Forward<ArgType>(InFunctor)) {}
+		virtual RetType Call(ParamTypes... Params) override { return Functor(Forward<ParamTypes>(Params)...); }
+	};
+
+	std::unique_ptr<ICallable> Callable;
+};
@@ -0,0 +1,43 @@
+// SharedPointer.h
+
+#pragma once
+
+#include <memory>
+
+enum class ESPMode : uint8
+{
+	NotThreadSafe = 0,
+	ThreadSafe = 1
+};
+
+/** 只实现模块用到的部分: 非空的共享引用, 以 std::shared_ptr 实现(引用计数总是线程安全的). */
+template <typename ObjectType, ESPMode Mode = ESPMode::ThreadSafe>
+class TSharedRef
+{
+public:
+	explicit TSharedRef(std::shared_ptr<ObjectType> InPtr)
+		: Ptr(MoveTemp(InPtr))
+	{
+	}
+
+	template <typename OtherType, typename = std::enable_if_t<std::is_convertible_v<OtherType*, ObjectType*>>>
+	TSharedRef(const TSharedRef<OtherType, Mode>& Other)
+		: Ptr(Other.Ptr)
+	{
+	}
+
+	ObjectType& Get() const { return *Ptr; }
+	ObjectType& operator*() const { return *Ptr; }
+	ObjectType* operator->() const { return Ptr.get(); }
+
+private:
+	template <typename, ESPMode> friend class TSharedRef;
+
+	std::shared_ptr<ObjectType> Ptr;
+};
+
+template <typename ObjectType, ESPMode Mode = ESPMode::ThreadSafe, typename... ArgTypes>
+TSharedRef<ObjectType, Mode> MakeShared(ArgTypes&&... Args)
+{
+	return TSharedRef<ObjectType, Mode>(std::make_shared<ObjectType>(Forward<ArgTypes>(Args)...));
+}